@@ -20,6 +20,8 @@
 #ifndef COMMON_CORE_COLLISIONASSOCIATION_H_
 #define COMMON_CORE_COLLISIONASSOCIATION_H_
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <memory>
 
@@ -56,6 +58,7 @@ class CollisionAssociation
   void setIncludeUnassigned(bool enable = true) { mIncludeUnassigned = enable; }
   void setFillTableOfCollIdsPerTrack(bool fill = true) { mFillTableOfCollIdsPerTrack = fill; }
   void setBcWindow(int bcWindow = 115) { mBcWindowForOneSigma = bcWindow; }
+  void setUseSortedBcSweep(bool enable = true) { mUseSortedBcSweep = enable; }
 
   template <typename TTracks, typename Slice, typename Assoc, typename RevIndices>
   void runStandardAssoc(o2::aod::Collisions const& collisions,
@@ -124,6 +127,11 @@ class CollisionAssociation
                         Assoc& association,
                         RevIndices& reverseIndices)
   {
+    if (mUseSortedBcSweep) {
+      runAssocWithTimeSorted(collisions, tracksUnfiltered, tracks, ambiguousTracks, bcs, association, reverseIndices);
+      return;
+    }
+
     // cache globalBC
     std::vector<uint64_t> globalBC;
     for (const auto& track : tracks) {
@@ -241,7 +249,177 @@ class CollisionAssociation
     }
   }
 
+  /// Time-based association with a sweep over tracks sorted in (globalBC + trackTime).
+  /// Produces the same association and reverse-index tables as the brute-force loop of runAssocWithTime,
+  /// but each collision only visits the tracks inside its BC window, so the cost is O((Ncoll + Ntracks) log Ntracks).
+  /// Works also with unassigned tracks and merged DFs, since the ordering does not rely on the table ordering.
+  template <typename TTracksUnfiltered, typename TTracks, typename TAmbiTracks, typename Assoc, typename RevIndices>
+  void runAssocWithTimeSorted(o2::aod::Collisions const& collisions,
+                              TTracksUnfiltered const& tracksUnfiltered,
+                              TTracks const& tracks,
+                              TAmbiTracks const& ambiguousTracks,
+                              o2::aod::BCs const& /*bcs*/,
+                              Assoc& association,
+                              RevIndices& reverseIndices)
+  {
+    constexpr float bcSpacing = o2::constants::lhc::LHCBunchSpacingNS;
+
+    // cache globalBC and time of the collisions, indexed by collision global index
+    mCollBC.resize(collisions.size());
+    mCollTime.resize(collisions.size());
+    for (const auto& collision : collisions) {
+      mCollBC[collision.globalIndex()] = collision.bc().globalBC();
+      mCollTime[collision.globalIndex()] = collision.collisionTime();
+    }
+
+    // index from track global index to the globalBC of its ambiguous-track entry (one pass over the ambiguous tracks)
+    mAmbTrackBC.assign(tracksUnfiltered.size(), kInvalidBC);
+    for (const auto& ambTrack : ambiguousTracks) {
+      int64_t trackId{-1};
+      if constexpr (isCentralBarrel) { // FIXME: to be removed as soon as it is possible to use getId<Table>() for joined tables
+        trackId = ambTrack.trackId();
+        if (trackId < 0 || trackId >= static_cast<int64_t>(mAmbTrackBC.size()) || mAmbTrackBC[trackId] != kInvalidBC) {
+          continue; // keep the first entry, as in the linear search
+        }
+        if (!ambTrack.has_bc() || ambTrack.bc().size() == 0) {
+          continue;
+        }
+      } else {
+        trackId = ambTrack.template getId<TTracks>();
+        if (trackId < 0 || trackId >= static_cast<int64_t>(mAmbTrackBC.size()) || mAmbTrackBC[trackId] != kInvalidBC) {
+          continue;
+        }
+      }
+      mAmbTrackBC[trackId] = ambTrack.bc().begin().globalBC();
+    }
+
+    // cache the track quantities needed for the time compatibility and sort them in (globalBC + trackTime)
+    mSortedTracks.clear();
+    mSortedTracks.reserve(tracks.size());
+    uint64_t refBC = mCollBC.empty() ? 0 : *std::min_element(mCollBC.begin(), mCollBC.end());
+    for (const auto& track : tracks) {
+      if (!mIncludeUnassigned && !track.has_collision()) {
+        continue;
+      }
+      TrackTimeEntry entry;
+      if (track.has_collision()) {
+        entry.globalBC = mCollBC[track.collisionId()];
+      } else {
+        entry.globalBC = mAmbTrackBC[track.globalIndex()];
+        if (entry.globalBC == kInvalidBC) {
+          continue;
+        }
+      }
+      entry.trackIdx = track.globalIndex();
+      entry.sortKey = static_cast<double>(static_cast<int64_t>(entry.globalBC - refBC)) + track.trackTime() / bcSpacing;
+      entry.trackTime = track.trackTime();
+      entry.trackTimeRes = track.trackTimeRes();
+      entry.thresholdType = kNSigma;
+      if constexpr (isCentralBarrel) {
+        if (mUsePvAssociation && track.isPVContributor()) {
+          entry.trackTime = mCollTime[track.collisionId()]; // if PV contributor, we assume the time to be the one of the collision
+          entry.trackTimeRes = bcSpacing;                    // 1 BC
+          entry.thresholdType = kPvContributor;
+        } else if (TESTBIT(track.flags(), o2::aod::track::TrackTimeResIsRange)) {
+          entry.thresholdType = kRange;
+        }
+      }
+      mSortedTracks.push_back(entry);
+    }
+    std::sort(mSortedTracks.begin(), mSortedTracks.end(), [](const TrackTimeEntry& a, const TrackTimeEntry& b) { return a.sortKey < b.sortKey; });
+
+    // define vector of vectors to store indices of compatible collisions per track
+    std::vector<std::unique_ptr<std::vector<int>>> collsPerTrack(mFillTableOfCollIdsPerTrack ? tracksUnfiltered.size() : 0);
+
+    // sweep the BC window of each collision over the sorted tracks
+    const float bOffsetMax = mBcWindowForOneSigma * mNumSigmaForTimeCompat + mTimeMargin / bcSpacing;
+    for (const auto& collision : collisions) {
+      const float collTime = collision.collisionTime();
+      const float collTimeRes2 = collision.collisionTimeRes() * collision.collisionTimeRes();
+      const uint64_t collBC = mCollBC[collision.globalIndex()];
+      const double collKey = static_cast<double>(static_cast<int64_t>(collBC - refBC));
+
+      // the window is widened by one BC, the exact (truncated) BC-window condition is applied per candidate below
+      auto first = std::lower_bound(mSortedTracks.begin(), mSortedTracks.end(), collKey - bOffsetMax - 1.,
+                                    [](const TrackTimeEntry& entry, double key) { return entry.sortKey < key; });
+      mCompatibleTracks.clear();
+      for (auto entry = first; entry != mSortedTracks.end() && entry->sortKey <= collKey + bOffsetMax + 1.; ++entry) {
+        const auto bcOffsetWindow = static_cast<int64_t>(entry->sortKey - collKey);
+        if (std::abs(bcOffsetWindow) > bOffsetMax) {
+          continue;
+        }
+        const int64_t bcOffset = static_cast<int64_t>(entry->globalBC - collBC);
+        const float deltaTime = entry->trackTime - collTime + bcOffset * bcSpacing;
+        const float sigmaTimeRes2 = collTimeRes2 + entry->trackTimeRes * entry->trackTimeRes;
+        float thresholdTime = 0.;
+        switch (entry->thresholdType) {
+          case kPvContributor:
+            thresholdTime = entry->trackTimeRes;
+            break;
+          case kRange:
+            thresholdTime = std::sqrt(sigmaTimeRes2) + mTimeMargin;
+            break;
+          default:
+            thresholdTime = mNumSigmaForTimeCompat * std::sqrt(sigmaTimeRes2) + mTimeMargin;
+        }
+        if (std::abs(deltaTime) < thresholdTime) {
+          mCompatibleTracks.push_back(entry->trackIdx);
+        }
+      }
+
+      // fill in track order, as the brute-force loop does
+      std::sort(mCompatibleTracks.begin(), mCompatibleTracks.end());
+      const auto collIdx = collision.globalIndex();
+      for (const auto trackIdx : mCompatibleTracks) {
+        LOGP(debug, "Filling track id {} for coll id {}", trackIdx, collIdx);
+        association(collIdx, trackIdx);
+        if (mFillTableOfCollIdsPerTrack) {
+          if (collsPerTrack[trackIdx] == nullptr) {
+            collsPerTrack[trackIdx] = std::make_unique<std::vector<int>>();
+          }
+          collsPerTrack[trackIdx].get()->push_back(collIdx);
+        }
+      }
+    }
+
+    // create reverse index track to collisions if enabled
+    if (mFillTableOfCollIdsPerTrack) {
+      std::vector<int> empty{};
+      for (const auto& track : tracksUnfiltered) {
+        const auto trackId = track.globalIndex();
+        if (collsPerTrack[trackId] == nullptr) {
+          reverseIndices(empty);
+        } else {
+          reverseIndices(*collsPerTrack[trackId].get());
+        }
+      }
+    }
+  }
+
  private:
+  static constexpr uint64_t kInvalidBC = static_cast<uint64_t>(-1);
+
+  enum TimeThresholdType : uint8_t {
+    kNSigma = 0,
+    kRange,
+    kPvContributor
+  };
+
+  struct TrackTimeEntry {
+    double sortKey{0.};             // globalBC (relative to the first collision BC) + trackTime in BC units
+    uint64_t globalBC{0};           // globalBC of the track (collision BC or first BC of the ambiguous track)
+    int64_t trackIdx{-1};           // global index of the track
+    float trackTime{0.};            // track time used for the compatibility (collision time for PV contributors)
+    float trackTimeRes{0.};         // track time resolution used for the compatibility
+    uint8_t thresholdType{kNSigma}; // type of time threshold (n sigma, range or PV contributor)
+  };
+
+  std::vector<uint64_t> mCollBC{};             // globalBC per collision (sorted sweep only)
+  std::vector<float> mCollTime{};              // collision time per collision (sorted sweep only)
+  std::vector<uint64_t> mAmbTrackBC{};         // globalBC of the ambiguous-track entry per track (sorted sweep only)
+  std::vector<TrackTimeEntry> mSortedTracks{}; // tracks sorted in (globalBC + trackTime) (sorted sweep only)
+  std::vector<int64_t> mCompatibleTracks{};    // scratch buffer with the compatible tracks of a collision (sorted sweep only)
+
   float mNumSigmaForTimeCompat{4.};                                                  // number of sigma for time compatibility
   float mTimeMargin{500.};                                                           // additional time margin in ns
   int mTrackSelection{o2::aod::track_association::TrackSelection::GlobalTrackWoDCA}; // track selection for central barrel tracks (standard association only)
@@ -249,6 +427,7 @@ class CollisionAssociation
   bool mIncludeUnassigned{true};                                                     // include tracks that were originally not assigned to any collision
   bool mFillTableOfCollIdsPerTrack{false};                                           // fill additional table with vectors of compatible collisions per track
   int mBcWindowForOneSigma{115};                                                     // BC window to be multiplied by the number of sigmas to define maximum window to be considered
+  bool mUseSortedBcSweep{false};                                                     // use the sweep over tracks sorted in time instead of the collision x track loop
 };
 
 #endif // COMMON_CORE_COLLISIONASSOCIATION_H_
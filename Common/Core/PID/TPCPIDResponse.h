@@ -20,6 +20,7 @@
 #include <array>
 #include <vector>
 #include <cmath>
+#include <gsl/span>
 #include "Framework/Logger.h"
 // O2 includes
 #include "ReconstructionDataFormats/PID.h"
@@ -35,6 +36,18 @@ class Response
 {
 
  public:
+  /// Column view of the track quantities needed for the batched evaluation of the number of sigmas
+  /// All spans must have the same size, one entry per track
+  struct TrackColumns {
+    gsl::span<const uint8_t> hasTPC;      // 1 if the track has TPC, 0 otherwise
+    gsl::span<const float> tpcInnerParam; // momentum at the inner wall of the TPC
+    gsl::span<const float> tgl;           // tangent of the dip angle
+    gsl::span<const float> signed1Pt;     // signed inverse transverse momentum
+    gsl::span<const float> tpcNClsFound;  // number of TPC clusters
+    gsl::span<const float> tpcSignal;     // measured TPC signal
+    gsl::span<const float> multTPC;       // TPC multiplicity of the collision of the track (0 if not assigned)
+  };
+
   Response() = default;
   ~Response() = default;
 
@@ -80,6 +93,11 @@ class Response
   /// Gets the deviation to the expected signal
   template <typename TrackType>
   float GetSignalDelta(const TrackType& trk, const o2::track::PID::ID id) const;
+  /// Gets the number of sigmas for a batch of tracks and one particle hypothesis, nSigma must have the size of the columns
+  void GetNumberOfSigma(const TrackColumns& tracks, const o2::track::PID::ID id, gsl::span<float> nSigma) const;
+  /// Gets the number of sigmas for a batch of tracks and several particle hypotheses
+  /// nSigma is filled hypothesis-major, i.e. nSigma[iId * nTracks + iTrack]
+  void GetNumberOfSigma(const TrackColumns& tracks, gsl::span<const o2::track::PID::ID> ids, gsl::span<float> nSigma) const;
   /// Gets relative dEdx resolution contribution due to relative pt resolution
   float GetRelativeResolutiondEdx(const float p, const float mass, const float charge, const float resol) const;
 
@@ -154,6 +172,75 @@ inline float Response::GetNumberOfSigma(const CollisionType& collision, const Tr
   return ((trk.tpcSignal() - GetExpectedSignal(trk, id)) / GetExpectedSigma(collision, trk, id));
 }
 
+/// Gets the number of sigma for a batch of tracks
+/// The Bethe-Bloch is evaluated once per track (twice for the non-default resolution) and no memory is allocated
+inline void Response::GetNumberOfSigma(const TrackColumns& tracks, const o2::track::PID::ID id, gsl::span<float> nSigma) const
+{
+  const std::size_t nTracks = tracks.tpcInnerParam.size();
+  if (nSigma.size() < nTracks) {
+    LOGP(fatal, "Output span for the TPC number of sigmas is too small: {} < {}", nSigma.size(), nTracks);
+  }
+  const float mass = o2::track::pid_constants::sMasses[id];
+  const float charge = o2::track::pid_constants::sCharges[id];
+  const float chargeFactor = std::pow(charge, mChargeFactor);
+  const float bb0 = mBetheBlochParams[0], bb1 = mBetheBlochParams[1], bb2 = mBetheBlochParams[2], bb3 = mBetheBlochParams[3], bb4 = mBetheBlochParams[4];
+
+  if (mUseDefaultResolutionParam) {
+    const float reso0 = mResolutionParamsDefault[0];
+    const float reso1 = mResolutionParamsDefault[1];
+    for (std::size_t i = 0; i < nTracks; i++) {
+      const float bethe = mMIP * o2::tpc::BetheBlochAleph(tracks.tpcInnerParam[i] / mass, bb0, bb1, bb2, bb3, bb4) * chargeFactor;
+      const float ncl = tracks.tpcNClsFound[i];
+      const float reso = bethe * reso0 * (ncl > 0 ? std::sqrt(1. + reso1 / ncl) : 1.f);
+      const bool valid = tracks.hasTPC[i] && bethe >= 0.f && reso >= 0.f;
+      nSigma[i] = valid ? (tracks.tpcSignal[i] - bethe) / reso : -999.f;
+    }
+    return;
+  }
+
+  // Non-default parametrisation, the parameters are unpacked once per batch
+  const double res0Sq = mResolutionParams[0] * mResolutionParams[0];
+  const double res1Sq = mResolutionParams[1] * mResolutionParams[1];
+  const double res2 = mResolutionParams[2];
+  const float res3 = mResolutionParams[3];
+  const double res4 = mResolutionParams[4];
+  const double res5 = mResolutionParams[5];
+  const double res6 = mResolutionParams[6];
+  const double res7 = mResolutionParams[7];
+  const double invMultNorm = 1. / mMultNormalization;
+  for (std::size_t i = 0; i < nTracks; i++) {
+    const float p = tracks.tpcInnerParam[i];
+    const float dEdx = o2::tpc::BetheBlochAleph(p / mass, bb0, bb1, bb2, bb3, bb4) * chargeFactor;
+    const float bethe = mMIP * dEdx;
+    // relative dE/dx resolution due to the momentum resolution, see GetRelativeResolutiondEdx
+    const float deltaP = res3 * std::sqrt(dEdx);
+    const float dEdxDelta = o2::tpc::BetheBlochAleph(p * (1 + deltaP) / mass, bb0, bb1, bb2, bb3, bb4) * chargeFactor;
+    const double relReso = std::abs(dEdxDelta - dEdx) / dEdx;
+
+    const double invdEdx = 1. / static_cast<double>(dEdx);
+    const double sqrtNcl = std::sqrt(static_cast<double>(nClNorm / tracks.tpcNClsFound[i]));
+    const double tgl = tracks.tgl[i];
+    const double invdEdxOverCosDip = invdEdx / std::sqrt(1 + tgl * tgl);
+    const double signed1Pt = tracks.signed1Pt[i];
+    const double mult = tracks.multTPC[i] * invMultNorm;
+    const float reso = std::sqrt(res0Sq * invdEdx + res1Sq * (sqrtNcl * res5) * std::pow(invdEdxOverCosDip, res2) + sqrtNcl * relReso * relReso + (res4 * signed1Pt) * (res4 * signed1Pt) + (mult * res6) * (mult * res6) + (mult * invdEdxOverCosDip * res7) * (mult * invdEdxOverCosDip * res7)) * dEdx * mMIP;
+    const bool valid = tracks.hasTPC[i] && bethe >= 0.f && reso >= 0.f;
+    nSigma[i] = valid ? (tracks.tpcSignal[i] - bethe) / reso : -999.f;
+  }
+}
+
+/// Gets the number of sigma for a batch of tracks and several particle hypotheses
+inline void Response::GetNumberOfSigma(const TrackColumns& tracks, gsl::span<const o2::track::PID::ID> ids, gsl::span<float> nSigma) const
+{
+  const std::size_t nTracks = tracks.tpcInnerParam.size();
+  if (nSigma.size() < nTracks * ids.size()) {
+    LOGP(fatal, "Output span for the TPC number of sigmas is too small: {} < {}", nSigma.size(), nTracks * ids.size());
+  }
+  for (std::size_t iId = 0; iId < ids.size(); iId++) {
+    GetNumberOfSigma(tracks, ids[iId], nSigma.subspan(iId * nTracks, nTracks));
+  }
+}
+
 /// Gets the deviation between the actual signal and the expected signal
 template <typename TrackType>
 inline float Response::GetSignalDelta(const TrackType& trk, const o2::track::PID::ID id) const
@@ -0,0 +1,134 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   benchmarkTPCPIDResponse.cxx
+/// \brief  Timing of the per-track against the batched TPC number of sigmas on synthetic tracks
+///         Usage: o2-bench-analysis-tpc-pid-response [number of tracks] [number of repetitions]
+///
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Common/Core/PID/TPCPIDResponse.h"
+
+namespace
+{
+/// Synthetic track columns, also seen through the accessors used by the per-track evaluation
+struct SyntheticTracks {
+  std::vector<uint8_t> hasTPC;
+  std::vector<float> tpcInnerParam;
+  std::vector<float> tgl;
+  std::vector<float> signed1Pt;
+  std::vector<float> tpcNClsFound;
+  std::vector<float> tpcSignal;
+  std::vector<float> multTPC;
+
+  explicit SyntheticTracks(std::size_t nTracks)
+  {
+    std::mt19937 gen(12345);
+    std::uniform_real_distribution<float> p(0.1f, 10.f);
+    std::uniform_real_distribution<float> tglDist(-1.f, 1.f);
+    std::uniform_int_distribution<int> ncl(60, 159);
+    std::uniform_real_distribution<float> signal(30.f, 200.f);
+    std::uniform_real_distribution<float> mult(0.f, 5000.f);
+    std::bernoulli_distribution hasTPCDist(0.95);
+    std::bernoulli_distribution sign(0.5);
+    for (std::size_t i = 0; i < nTracks; i++) {
+      const float pTrk = p(gen);
+      const float tglTrk = tglDist(gen);
+      hasTPC.push_back(hasTPCDist(gen));
+      tpcInnerParam.push_back(pTrk);
+      tgl.push_back(tglTrk);
+      signed1Pt.push_back((sign(gen) ? 1.f : -1.f) * std::sqrt(1.f + tglTrk * tglTrk) / pTrk);
+      tpcNClsFound.push_back(ncl(gen));
+      tpcSignal.push_back(signal(gen));
+      multTPC.push_back(mult(gen));
+    }
+  }
+
+  o2::pid::tpc::Response::TrackColumns columns() const { return {hasTPC, tpcInnerParam, tgl, signed1Pt, tpcNClsFound, tpcSignal, multTPC}; }
+};
+
+/// Row view with the accessors of the AO2D track and collision tables
+struct TrackRow {
+  const SyntheticTracks* tracks;
+  std::size_t i;
+  bool hasTPC() const { return tracks->hasTPC[i]; }
+  float tpcInnerParam() const { return tracks->tpcInnerParam[i]; }
+  float tgl() const { return tracks->tgl[i]; }
+  float signed1Pt() const { return tracks->signed1Pt[i]; }
+  float tpcNClsFound() const { return tracks->tpcNClsFound[i]; }
+  float tpcSignal() const { return tracks->tpcSignal[i]; }
+  float multTPC() const { return tracks->multTPC[i]; }
+};
+
+constexpr o2::track::PID::ID NHypotheses = 9;
+
+/// Times both evaluations for all hypotheses, returns the largest relative difference between them
+double run(const o2::pid::tpc::Response& response, const SyntheticTracks& tracks, int nRepetitions, const char* label)
+{
+  const std::size_t nTracks = tracks.tpcInnerParam.size();
+  std::vector<float> nSigmaPerTrack(nTracks * NHypotheses);
+  std::vector<float> nSigmaBatch(nTracks * NHypotheses);
+  const auto columns = tracks.columns();
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int iRep = 0; iRep < nRepetitions; iRep++) {
+    for (o2::track::PID::ID id = 0; id < NHypotheses; id++) {
+      for (std::size_t i = 0; i < nTracks; i++) {
+        const TrackRow row{&tracks, i}; // the row is both the track and its collision
+        nSigmaPerTrack[id * nTracks + i] = response.GetNumberOfSigma(row, row, id);
+      }
+    }
+  }
+  auto stop = std::chrono::high_resolution_clock::now();
+  const double nsPerTrack = std::chrono::duration<double, std::nano>(stop - start).count() / (static_cast<double>(nRepetitions) * nTracks * NHypotheses);
+
+  start = std::chrono::high_resolution_clock::now();
+  for (int iRep = 0; iRep < nRepetitions; iRep++) {
+    for (o2::track::PID::ID id = 0; id < NHypotheses; id++) {
+      response.GetNumberOfSigma(columns, id, gsl::span<float>(nSigmaBatch).subspan(id * nTracks, nTracks));
+    }
+  }
+  stop = std::chrono::high_resolution_clock::now();
+  const double nsBatch = std::chrono::duration<double, std::nano>(stop - start).count() / (static_cast<double>(nRepetitions) * nTracks * NHypotheses);
+
+  double maxRelDiff = 0.;
+  for (std::size_t i = 0; i < nSigmaBatch.size(); i++) {
+    const double diff = std::abs(nSigmaBatch[i] - nSigmaPerTrack[i]);
+    maxRelDiff = std::max(maxRelDiff, diff / std::max(1., static_cast<double>(std::abs(nSigmaPerTrack[i]))));
+  }
+  std::printf("%-28s per track: %8.2f ns, batch: %8.2f ns, speed-up: %5.2f, max. relative difference: %g\n", label, nsPerTrack, nsBatch, nsPerTrack / nsBatch, maxRelDiff);
+  return maxRelDiff;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  const std::size_t nTracks = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  const int nRepetitions = argc > 2 ? std::atoi(argv[2]) : 10;
+  const SyntheticTracks tracks(nTracks);
+  std::printf("TPC number of sigmas for %zu tracks x %d hypotheses, %d repetitions (time per track and hypothesis)\n", nTracks, static_cast<int>(NHypotheses), nRepetitions);
+
+  o2::pid::tpc::Response response;
+  const double diffDefault = run(response, tracks, nRepetitions, "default resolution:");
+  response.SetUseDefaultResolutionParam(false);
+  const double diffMult = run(response, tracks, nRepetitions, "multiplicity-dependent:");
+
+  // the batched evaluation must reproduce the per-track one
+  return (diffDefault < 1e-5 && diffMult < 1e-5) ? 0 : 1;
+}
@@ -92,6 +92,8 @@ struct tpcPid {
   Configurable<bool> enableNetworkOptimizations{"enableNetworkOptimizations", 1, "(bool) If the neural network correction is used, this enables GraphOptimizationLevel::ORT_ENABLE_EXTENDED in the ONNX session"};
   Configurable<std::string> networkPathCCDB{"networkPathCCDB", "Analysis/PID/TPC/ML", "Path on CCDB"};
   Configurable<int> networkSetNumThreads{"networkSetNumThreads", 0, "Especially important for running on a SLURM cluster. Sets the number of threads used for execution."};
+  Configurable<bool> useBatchedNSigma{"useBatchedNSigma", true, "(bool) Without network correction, compute the number of sigmas in one pass per mass hypothesis and response validity interval, false: per track"};
+  Configurable<int> networkInferenceChunkSize{"networkInferenceChunkSize", 0, "Maximum number of rows (tracks x mass hypotheses) evaluated in one network inference to bound the memory. 0: all rows in one inference"};
   // Configuration flags to include and exclude particle hypotheses
   Configurable<int> pidEl{"pid-el", -1, {"Produce PID information for the Electron mass hypothesis, overrides the automatic setup: the corresponding table can be set off (0) or on (1)"}};
   Configurable<int> pidMu{"pid-mu", -1, {"Produce PID information for the Muon mass hypothesis, overrides the automatic setup: the corresponding table can be set off (0) or on (1)"}};
@@ -106,6 +108,112 @@ struct tpcPid {
   // Paramatrization configuration
   bool useCCDBParam = false;
 
+  // Buffers for the batched evaluation of the number of sigmas, reused across DFs
+  std::vector<uint8_t> batchHasTPC;
+  std::vector<float> batchTpcInnerParam;
+  std::vector<float> batchTgl;
+  std::vector<float> batchSigned1Pt;
+  std::vector<float> batchTpcNClsFound;
+  std::vector<float> batchTpcSignal;
+  std::vector<float> batchMultTPC;
+  std::vector<float> batchNSigma;
+  std::vector<float> collisionMultTPC;
+
+  // Buffers for the network correction, reused across DFs
+  std::vector<float> networkInput;
+  std::vector<float> networkPrediction;
+
+  /// Retrieves the TPC response valid for the given timestamp from the CCDB
+  void updateResponse(const uint64_t timestamp)
+  {
+    if (recoPass.value == "") {
+      LOGP(info, "Retrieving latest TPC response object for timestamp {}:", timestamp);
+    } else {
+      LOGP(info, "Retrieving TPC Response for timestamp {} and recoPass {}:", timestamp, recoPass.value);
+    }
+    response = ccdb->getSpecific<o2::pid::tpc::Response>(ccdbPath.value, timestamp, metadata);
+    if (!response) {
+      LOGP(warning, "!! Could not find a valid TPC response object for specific pass name {}! Falling back to latest uploaded object.", recoPass.value);
+      response = ccdb->getForTimeStamp<o2::pid::tpc::Response>(ccdbPath.value, timestamp);
+      if (!response) {
+        LOGP(fatal, "Could not find ANY TPC response object for the timestamp {}!", timestamp);
+      }
+    }
+    response->PrintAll();
+  }
+
+  /// Computes the number of sigmas of the tracks [first, last) for the enabled hypotheses with the current response
+  void computeNSigmaSegment(const std::size_t nTracks, const std::size_t first, const std::size_t last)
+  {
+    if (first >= last) {
+      return;
+    }
+    const std::size_t n = last - first;
+    const o2::pid::tpc::Response::TrackColumns columns{gsl::span<const uint8_t>(batchHasTPC).subspan(first, n),
+                                                       gsl::span<const float>(batchTpcInnerParam).subspan(first, n),
+                                                       gsl::span<const float>(batchTgl).subspan(first, n),
+                                                       gsl::span<const float>(batchSigned1Pt).subspan(first, n),
+                                                       gsl::span<const float>(batchTpcNClsFound).subspan(first, n),
+                                                       gsl::span<const float>(batchTpcSignal).subspan(first, n),
+                                                       gsl::span<const float>(batchMultTPC).subspan(first, n)};
+    auto fillHypothesis = [&](const Configurable<int>& flag, const o2::track::PID::ID pid) {
+      if (flag.value != 1) {
+        return;
+      }
+      response->GetNumberOfSigma(columns, pid, gsl::span<float>(batchNSigma).subspan(pid * nTracks + first, n));
+    };
+    fillHypothesis(pidEl, o2::track::PID::Electron);
+    fillHypothesis(pidMu, o2::track::PID::Muon);
+    fillHypothesis(pidPi, o2::track::PID::Pion);
+    fillHypothesis(pidKa, o2::track::PID::Kaon);
+    fillHypothesis(pidPr, o2::track::PID::Proton);
+    fillHypothesis(pidDe, o2::track::PID::Deuteron);
+    fillHypothesis(pidTr, o2::track::PID::Triton);
+    fillHypothesis(pidHe, o2::track::PID::Helium3);
+    fillHypothesis(pidAl, o2::track::PID::Alpha);
+  }
+
+  /// Computes the number of sigmas of all tracks for the enabled hypotheses in one pass per hypothesis and response validity interval
+  /// The response is refreshed in track order exactly as in the per-track evaluation, the tracks between two refreshes are evaluated together
+  /// batchNSigma is filled hypothesis-major, i.e. batchNSigma[pid * nTracks + iTrack]
+  void computeNSigmaBatch(Coll const& collisions, Trks const& tracks)
+  {
+    const std::size_t nTracks = tracks.size();
+    collisionMultTPC.resize(collisions.size());
+    for (auto const& collision : collisions) {
+      collisionMultTPC[collision.globalIndex()] = collision.multTPC();
+    }
+    batchHasTPC.resize(nTracks);
+    batchTpcInnerParam.resize(nTracks);
+    batchTgl.resize(nTracks);
+    batchSigned1Pt.resize(nTracks);
+    batchTpcNClsFound.resize(nTracks);
+    batchTpcSignal.resize(nTracks);
+    batchMultTPC.resize(nTracks);
+    batchNSigma.resize(nTracks * 9);
+    std::size_t iTrack = 0;
+    std::size_t firstInSegment = 0;
+    for (auto const& trk : tracks) {
+      if (trk.has_collision() && useCCDBParam && ccdbTimestamp.value == 0) {
+        const auto& bc = collisions.iteratorAt(trk.collisionId()).bc_as<aod::BCsWithTimestamps>();
+        if (!ccdb->isCachedObjectValid(ccdbPath.value, bc.timestamp())) { // close the segment of the previous response
+          computeNSigmaSegment(nTracks, firstInSegment, iTrack);
+          updateResponse(bc.timestamp());
+          firstInSegment = iTrack;
+        }
+      }
+      batchHasTPC[iTrack] = trk.hasTPC();
+      batchTpcInnerParam[iTrack] = trk.tpcInnerParam();
+      batchTgl[iTrack] = trk.tgl();
+      batchSigned1Pt[iTrack] = trk.signed1Pt();
+      batchTpcNClsFound[iTrack] = trk.tpcNClsFound();
+      batchTpcSignal[iTrack] = trk.tpcSignal();
+      batchMultTPC[iTrack] = trk.has_collision() ? collisionMultTPC[trk.collisionId()] : 0.f;
+      iTrack++;
+    }
+    computeNSigmaSegment(nTracks, firstInSegment, nTracks);
+  }
+
   void init(o2::framework::InitContext& initContext)
   {
     response = new o2::pid::tpc::Response();
@@ -227,7 +335,6 @@ struct tpcPid {
     reserveTable(pidHe, tablePIDHe);
     reserveTable(pidAl, tablePIDAl);
 
-    std::vector<float> network_prediction;
     const uint64_t tracksForNet_size = (skipTPCOnly) ? notTPCStandaloneTracks.size() : tracksWithTPC.size();
 
     if (useNetworkCorrection) {
@@ -268,85 +375,82 @@ struct tpcPid {
       }
 
       // Defining some network parameters
-      int input_dimensions = network.getNumInputNodes();
-      int output_dimensions = network.getNumOutputNodes();
-      const uint64_t track_prop_size = input_dimensions * tracksForNet_size;
-      const uint64_t prediction_size = output_dimensions * tracksForNet_size;
-
-      network_prediction = std::vector<float>(prediction_size * 9); // For each mass hypotheses
+      const int input_dimensions = network.getNumInputNodes();
+      const int output_dimensions = network.getNumOutputNodes();
+      const uint64_t nRows = tracksForNet_size * 9; // one row per track and mass hypothesis
       const float nNclNormalization = response->GetNClNormalization();
       float duration_network = 0;
 
-      std::vector<float> track_properties(track_prop_size);
-      uint64_t counter_track_props = 0;
-      int loop_counter = 0;
+      // Multiplicity gathered once per collision
+      collisionMultTPC.resize(collisions.size());
+      for (auto const& collision : collisions) {
+        collisionMultTPC[collision.globalIndex()] = collision.multTPC();
+      }
 
-      // Filling a std::vector<float> to be evaluated by the network
-      // Evaluation on single tracks brings huge overhead: Thus evaluation is done on one large vector
-      for (int i = 0; i < 9; i++) { // Loop over particle number for which network correction is used
-        for (auto const& trk : tracks) {
-          if (!trk.hasTPC()) {
+      // Filling the input of all mass hypotheses in one pass over the tracks
+      // The rows are ordered hypothesis-major (row = i * tracksForNet_size + track) as expected when reading the predictions
+      // Evaluation on single tracks brings huge overhead: Thus evaluation is done on large chunks
+      networkInput.resize(nRows * input_dimensions);
+      networkPrediction.resize(nRows * output_dimensions);
+      uint64_t counter_tracks = 0;
+      for (auto const& trk : tracks) {
+        if (!trk.hasTPC()) {
+          continue;
+        }
+        if (skipTPCOnly) {
+          if (!trk.hasITS() && !trk.hasTRD() && !trk.hasTOF()) {
             continue;
           }
-          if (skipTPCOnly) {
-            if (!trk.hasITS() && !trk.hasTRD() && !trk.hasTOF()) {
-              continue;
-            }
-          }
-          track_properties[counter_track_props] = trk.tpcInnerParam();
-          track_properties[counter_track_props + 1] = trk.tgl();
-          track_properties[counter_track_props + 2] = trk.signed1Pt();
-          track_properties[counter_track_props + 3] = o2::track::pid_constants::sMasses[i];
-          track_properties[counter_track_props + 4] = collisions.iteratorAt(trk.collisionId()).multTPC() / 11000.;
-          track_properties[counter_track_props + 5] = std::sqrt(nNclNormalization / trk.tpcNClsFound());
-          counter_track_props += input_dimensions;
         }
-
-        auto start_network_eval = std::chrono::high_resolution_clock::now();
-        float* output_network = network.evalModel(track_properties);
-        auto stop_network_eval = std::chrono::high_resolution_clock::now();
-        duration_network += std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_eval - start_network_eval).count();
-        for (uint64_t i = 0; i < prediction_size; i += output_dimensions) {
-          for (int j = 0; j < output_dimensions; j++) {
-            network_prediction[i + j + prediction_size * loop_counter] = output_network[i + j];
-          }
+        const float mult = trk.has_collision() ? collisionMultTPC[trk.collisionId()] / 11000. : 0.f;
+        const float nclNorm = std::sqrt(nNclNormalization / trk.tpcNClsFound());
+        for (int i = 0; i < 9; i++) { // Loop over particle number for which network correction is used
+          float* row = networkInput.data() + (i * tracksForNet_size + counter_tracks) * input_dimensions;
+          row[0] = trk.tpcInnerParam();
+          row[1] = trk.tgl();
+          row[2] = trk.signed1Pt();
+          row[3] = o2::track::pid_constants::sMasses[i];
+          row[4] = mult;
+          row[5] = nclNorm;
         }
+        counter_tracks++;
+      }
 
-        counter_track_props = 0;
-        loop_counter += 1;
+      // Evaluating the network in chunks of rows, the predictions are written directly into the output buffer
+      const uint64_t chunkSize = networkInferenceChunkSize.value > 0 ? static_cast<uint64_t>(networkInferenceChunkSize.value) : nRows;
+      auto start_network_eval = std::chrono::high_resolution_clock::now();
+      for (uint64_t firstRow = 0; firstRow < nRows; firstRow += chunkSize) {
+        const uint64_t nRowsChunk = std::min(chunkSize, nRows - firstRow);
+        if (!network.evalModel(networkInput.data() + firstRow * input_dimensions, nRowsChunk, networkPrediction.data() + firstRow * output_dimensions)) {
+          LOG(fatal) << "Neural network evaluation for the TPC PID response correction failed!";
+        }
       }
-      track_properties.clear();
+      auto stop_network_eval = std::chrono::high_resolution_clock::now();
+      duration_network += std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_eval - start_network_eval).count();
 
       auto stop_network_total = std::chrono::high_resolution_clock::now();
       LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval ONNX): " << duration_network / (tracksForNet_size * 9) << "ns ; Total time (eval ONNX): " << duration_network / 1000000000 << " s";
       LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval + overhead): " << std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_total - start_network_total).count() / (tracksForNet_size * 9) << "ns ; Total time (eval + overhead): " << std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_total - start_network_total).count() / 1000000000 << " s";
     }
 
+    const bool batchedNSigma = useBatchedNSigma.value && !useNetworkCorrection.value;
+    if (batchedNSigma) {
+      computeNSigmaBatch(collisions, tracks);
+    }
+
     uint64_t count_tracks = 0;
+    uint64_t count_all_tracks = 0;
 
     for (auto const& trk : tracks) {
       // Loop on Tracks
-      if (trk.has_collision()) {
+      if (trk.has_collision() && !batchedNSigma) { // the batched evaluation already went through the response updates
         const auto& bc = collisions.iteratorAt(trk.collisionId()).bc_as<aod::BCsWithTimestamps>();
         if (useCCDBParam && ccdbTimestamp.value == 0 && !ccdb->isCachedObjectValid(ccdbPath.value, bc.timestamp())) { // Updating parametrisation only if the initial timestamp is 0
-          if (recoPass.value == "") {
-            LOGP(info, "Retrieving latest TPC response object for timestamp {}:", bc.timestamp());
-          } else {
-            LOGP(info, "Retrieving TPC Response for timestamp {} and recoPass {}:", bc.timestamp(), recoPass.value);
-          }
-          response = ccdb->getSpecific<o2::pid::tpc::Response>(ccdbPath.value, bc.timestamp(), metadata);
-          if (!response) {
-            LOGP(warning, "!! Could not find a valid TPC response object for specific pass name {}! Falling back to latest uploaded object.", recoPass.value);
-            response = ccdb->getForTimeStamp<o2::pid::tpc::Response>(ccdbPath.value, bc.timestamp());
-            if (!response) {
-              LOGP(fatal, "Could not find ANY TPC response object for the timestamp {}!", bc.timestamp());
-            }
-          }
-          response->PrintAll();
+          updateResponse(bc.timestamp());
         }
       }
       // Check and fill enabled tables
-      auto makeTable = [&trk, &collisions, &network_prediction, &count_tracks, &tracksForNet_size, this](const Configurable<int>& flag, auto& table, const o2::track::PID::ID pid) {
+      auto makeTable = [&trk, &collisions, &count_tracks, &count_all_tracks, &tracksForNet_size, &outTable_size, &batchedNSigma, this](const Configurable<int>& flag, auto& table, const o2::track::PID::ID pid) {
         if (flag.value != 1) {
           return;
         }
@@ -360,32 +464,35 @@ struct tpcPid {
             return;
           }
         }
+        if (batchedNSigma) { // number of sigmas from the batched evaluation
+          aod::pidutils::packInTable<aod::pidtpc_tiny::binning>(batchNSigma[pid * outTable_size + count_all_tracks], table);
+          return;
+        }
         auto expSignal = response->GetExpectedSignal(trk, pid);
         auto expSigma = response->GetExpectedSigma(collisions.iteratorAt(trk.collisionId()), trk, pid);
         if (expSignal < 0. || expSigma < 0.) { // skip if expected signal invalid
           table(aod::pidtpc_tiny::binning::underflowBin);
           return;
         }
+        if (!useNetworkCorrection) {
+          aod::pidutils::packInTable<aod::pidtpc_tiny::binning>(response->GetNumberOfSigma(collisions.iteratorAt(trk.collisionId()), trk, pid), table);
+          return;
+        }
 
-        if (useNetworkCorrection) {
-
-          // Here comes the application of the network. The output--dimensions of the network dtermine the application: 1: mean, 2: sigma, 3: sigma asymmetric
-          // For now only the option 2: sigma will be used. The other options are kept if there would be demand later on
-          if (network.getNumOutputNodes() == 1) {
-            aod::pidutils::packInTable<aod::pidtpc_tiny::binning>((trk.tpcSignal() - network_prediction[count_tracks + tracksForNet_size * pid] * expSignal) / expSigma, table);
-          } else if (network.getNumOutputNodes() == 2) {
-            aod::pidutils::packInTable<aod::pidtpc_tiny::binning>((trk.tpcSignal() / expSignal - network_prediction[2 * (count_tracks + tracksForNet_size * pid)]) / (network_prediction[2 * (count_tracks + tracksForNet_size * pid) + 1] - network_prediction[2 * (count_tracks + tracksForNet_size * pid)]), table);
-          } else if (network.getNumOutputNodes() == 3) {
-            if (trk.tpcSignal() / expSignal >= network_prediction[3 * (count_tracks + tracksForNet_size * pid)]) {
-              aod::pidutils::packInTable<aod::pidtpc_tiny::binning>((trk.tpcSignal() / expSignal - network_prediction[3 * (count_tracks + tracksForNet_size * pid)]) / (network_prediction[3 * (count_tracks + tracksForNet_size * pid) + 1] - network_prediction[3 * (count_tracks + tracksForNet_size * pid)]), table);
-            } else {
-              aod::pidutils::packInTable<aod::pidtpc_tiny::binning>((trk.tpcSignal() / expSignal - network_prediction[3 * (count_tracks + tracksForNet_size * pid)]) / (network_prediction[3 * (count_tracks + tracksForNet_size * pid)] - network_prediction[3 * (count_tracks + tracksForNet_size * pid) + 2]), table);
-            }
+        // Here comes the application of the network. The output--dimensions of the network dtermine the application: 1: mean, 2: sigma, 3: sigma asymmetric
+        // For now only the option 2: sigma will be used. The other options are kept if there would be demand later on
+        if (network.getNumOutputNodes() == 1) {
+          aod::pidutils::packInTable<aod::pidtpc_tiny::binning>((trk.tpcSignal() - networkPrediction[count_tracks + tracksForNet_size * pid] * expSignal) / expSigma, table);
+        } else if (network.getNumOutputNodes() == 2) {
+          aod::pidutils::packInTable<aod::pidtpc_tiny::binning>((trk.tpcSignal() / expSignal - networkPrediction[2 * (count_tracks + tracksForNet_size * pid)]) / (networkPrediction[2 * (count_tracks + tracksForNet_size * pid) + 1] - networkPrediction[2 * (count_tracks + tracksForNet_size * pid)]), table);
+        } else if (network.getNumOutputNodes() == 3) {
+          if (trk.tpcSignal() / expSignal >= networkPrediction[3 * (count_tracks + tracksForNet_size * pid)]) {
+            aod::pidutils::packInTable<aod::pidtpc_tiny::binning>((trk.tpcSignal() / expSignal - networkPrediction[3 * (count_tracks + tracksForNet_size * pid)]) / (networkPrediction[3 * (count_tracks + tracksForNet_size * pid) + 1] - networkPrediction[3 * (count_tracks + tracksForNet_size * pid)]), table);
           } else {
-            LOGF(fatal, "Network output-dimensions incompatible!");
+            aod::pidutils::packInTable<aod::pidtpc_tiny::binning>((trk.tpcSignal() / expSignal - networkPrediction[3 * (count_tracks + tracksForNet_size * pid)]) / (networkPrediction[3 * (count_tracks + tracksForNet_size * pid)] - networkPrediction[3 * (count_tracks + tracksForNet_size * pid) + 2]), table);
           }
         } else {
-          aod::pidutils::packInTable<aod::pidtpc_tiny::binning>(response->GetNumberOfSigma(collisions.iteratorAt(trk.collisionId()), trk, pid), table);
+          LOGF(fatal, "Network output-dimensions incompatible!");
         }
       };
 
@@ -402,6 +509,7 @@ struct tpcPid {
       if (trk.hasTPC() && (!skipTPCOnly || trk.hasITS() || trk.hasTRD() || trk.hasTOF())) {
         count_tracks++; // Increment network track counter only if (not skipping TPConly) or (is not TPConly)
       }
+      count_all_tracks++;
     }
   }
 };
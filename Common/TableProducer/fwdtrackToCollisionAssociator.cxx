@@ -38,6 +38,7 @@ struct FwdTrackToCollisionAssociation {
   Configurable<bool> includeUnassigned{"includeUnassigned", false, "consider also tracks which are not assigned to any collision"};
   Configurable<bool> fillTableOfCollIdsPerTrack{"fillTableOfCollIdsPerTrack", false, "fill additional table with vector of collision ids per track"};
   Configurable<int> bcWindowForOneSigma{"bcWindowForOneSigma", 115, "BC window to be multiplied by the number of sigmas to define maximum window to be considered"};
+  Configurable<bool> useSortedBcSweep{"useSortedBcSweep", false, "sort tracks in time once and sweep the BC window of each collision instead of looping over all collision-track pairs"};
 
   CollisionAssociation<false> collisionAssociator;
 
@@ -64,6 +65,7 @@ struct FwdTrackToCollisionAssociation {
     collisionAssociator.setUsePvAssociation(false);
     collisionAssociator.setIncludeUnassigned(includeUnassigned);
     collisionAssociator.setFillTableOfCollIdsPerTrack(fillTableOfCollIdsPerTrack);
+    collisionAssociator.setUseSortedBcSweep(useSortedBcSweep);
   }
 
   void processFwdAssocWithTime(Collisions const& collisions,
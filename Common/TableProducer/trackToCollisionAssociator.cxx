@@ -39,6 +39,7 @@ struct TrackToCollisionAssociation {
   Configurable<bool> includeUnassigned{"includeUnassigned", false, "consider also tracks which are not assigned to any collision"};
   Configurable<bool> fillTableOfCollIdsPerTrack{"fillTableOfCollIdsPerTrack", false, "fill additional table with vector of collision ids per track"};
   Configurable<int> bcWindowForOneSigma{"bcWindowForOneSigma", 60, "BC window to be multiplied by the number of sigmas to define maximum window to be considered"};
+  Configurable<bool> useSortedBcSweep{"useSortedBcSweep", false, "sort tracks in time once and sweep the BC window of each collision instead of looping over all collision-track pairs"};
 
   CollisionAssociation<true> collisionAssociator;
 
@@ -62,6 +63,7 @@ struct TrackToCollisionAssociation {
     collisionAssociator.setUsePvAssociation(usePVAssociation);
     collisionAssociator.setIncludeUnassigned(includeUnassigned);
     collisionAssociator.setFillTableOfCollIdsPerTrack(fillTableOfCollIdsPerTrack);
+    collisionAssociator.setUseSortedBcSweep(useSortedBcSweep);
     collisionAssociator.setBcWindow(bcWindowForOneSigma);
   }
 
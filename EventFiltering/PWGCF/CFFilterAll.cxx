@@ -20,9 +20,14 @@
 #include <TMath.h>
 #include <TRandom3.h>
 #include <fairlogger/Logger.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <iterator>
+#include <limits>
+#include <numeric>
 #include <string>
+#include <vector>
 
 #include "../filterTables.h"
 
@@ -188,6 +193,10 @@ struct CFFilter {
     "ConfAutocorRejection",
     true,
     "Rejection autocorrelation pL pairs"};
+  Configurable<bool> ConfFastTripletSearch{
+    "ConfFastTripletSearch",
+    false,
+    "Three body triggers: only decide the trigger, pruning triplets by their pair relative momenta and stopping at the first accepted triplet (Q3 histograms are not filled)"};
 
   // Configs for tracks
   Configurable<bool> ConfDeuteronThPVMom{
@@ -1097,6 +1106,161 @@ struct CFFilter {
     return sqrt(-Q32);
   }
 
+  // Fast triplet search
+  // Q3^2 is the sum of the pair terms -q_ij^2 >= 0, so that every pair of an accepted triplet has -q_ij^2 < Q3limit^2.
+  // The pair terms are computed once per event and trigger, pairs above the limit are stored as infinity.
+  // For two particles of mass m, -q_ij^2 = 2 (p_i p_j - m^2) >= 2 m^2 (cosh(chi_i - chi_j) - 1) with chi = asinh(|p| / m),
+  // therefore the loops over candidates sorted in |p| can stop as soon as this bound exceeds the limit.
+  struct TripletCandidates {
+    std::vector<ROOT::Math::PxPyPzEVector> momenta; // four-momenta, sorted in |p|
+    std::vector<float> chi;                         // asinh(|p| / m)
+    std::vector<int> index;                         // position in the unsorted vector of the species
+    float mass = 0.f;
+  };
+  TripletCandidates candProtons, candAntiProtons, candLambdas, candAntiLambdas;
+  std::vector<float> q2Same, q2Mixed; // pair terms -q_ij^2, [i * n + j]
+  static constexpr float kQ2Rejected = std::numeric_limits<float>::infinity();
+
+  void fillTripletCandidates(const std::vector<ROOT::Math::PtEtaPhiMVector>& parts, float mass, TripletCandidates& cands)
+  {
+    cands.mass = mass;
+    cands.index.resize(parts.size());
+    std::iota(cands.index.begin(), cands.index.end(), 0);
+    std::sort(cands.index.begin(), cands.index.end(), [&parts](int i, int j) { return parts[i].P() < parts[j].P(); });
+    cands.momenta.clear();
+    cands.chi.clear();
+    for (const int i : cands.index) {
+      cands.momenta.emplace_back(parts[i]);
+      cands.chi.push_back(std::asinh(parts[i].P() / mass));
+    }
+  }
+
+  float getQ2ij(const ROOT::Math::PxPyPzEVector& vecparti, const ROOT::Math::PxPyPzEVector& vecpartj)
+  {
+    ROOT::Math::PxPyPzEVector trackSum = vecparti + vecpartj;
+    ROOT::Math::PxPyPzEVector trackDifference = vecparti - vecpartj;
+    float scaling = trackDifference.Dot(trackSum) / trackSum.Dot(trackSum);
+    return -(trackDifference - scaling * trackSum).M2();
+  }
+
+  float getQ2ijMin(float mass, float deltaChi)
+  {
+    return 2.f * mass * mass * (std::cosh(deltaChi) - 1.f);
+  }
+
+  bool acceptTriplet(const char* downsampleName)
+  {
+    if (ConfDownsample->get("Switch", downsampleName) > 0) {
+      return rng->Uniform(0., 1.) < ConfDownsample->get("Factor", downsampleName);
+    }
+    return true;
+  }
+
+  /// Pair terms of candidates of the same species
+  template <typename T>
+  void fillPairTerms(const TripletCandidates& cands, float limit2, T const& vetoPair)
+  {
+    const int n = cands.momenta.size();
+    q2Same.assign(n * n, kQ2Rejected);
+    for (int i = 0; i < n; i++) {
+      for (int j = i + 1; j < n; j++) {
+        if (getQ2ijMin(cands.mass, cands.chi[j] - cands.chi[i]) >= limit2) {
+          break;
+        }
+        if (vetoPair(cands.index[i], cands.index[j])) {
+          continue;
+        }
+        float q2 = getQ2ij(cands.momenta[i], cands.momenta[j]);
+        if (q2 < limit2) {
+          q2Same[i * n + j] = q2;
+          q2Same[j * n + i] = q2;
+        }
+      }
+    }
+  }
+
+  /// Pair terms of candidates of two different species
+  template <typename T>
+  void fillPairTerms(const TripletCandidates& candsA, const TripletCandidates& candsB, float limit2, T const& vetoPair)
+  {
+    const int nA = candsA.momenta.size();
+    const int nB = candsB.momenta.size();
+    q2Mixed.assign(nA * nB, kQ2Rejected);
+    for (int i = 0; i < nA; i++) {
+      for (int k = 0; k < nB; k++) {
+        if (vetoPair(candsA.index[i], candsB.index[k])) {
+          continue;
+        }
+        float q2 = getQ2ij(candsA.momenta[i], candsB.momenta[k]);
+        if (q2 < limit2) {
+          q2Mixed[i * nB + k] = q2;
+        }
+      }
+    }
+  }
+
+  /// Search for a triplet of three candidates of the same species with Q3 below the limit
+  /// \return true at the first triplet kept by the downsampling
+  template <typename T>
+  bool hasLowQ3Triplet(const TripletCandidates& cands, float limit, T const& vetoPair, const char* downsampleName)
+  {
+    const float limit2 = limit * limit;
+    const int n = cands.momenta.size();
+    fillPairTerms(cands, limit2, vetoPair);
+    for (int i = 0; i < n; i++) {
+      for (int j = i + 1; j < n; j++) {
+        if (getQ2ijMin(cands.mass, cands.chi[j] - cands.chi[i]) >= limit2) {
+          break;
+        }
+        const float q2ij = q2Same[i * n + j];
+        if (q2ij >= limit2) {
+          continue;
+        }
+        for (int k = j + 1; k < n; k++) {
+          if (q2ij + getQ2ijMin(cands.mass, cands.chi[k] - cands.chi[i]) + getQ2ijMin(cands.mass, cands.chi[k] - cands.chi[j]) >= limit2) {
+            break;
+          }
+          if (q2ij + q2Same[i * n + k] + q2Same[j * n + k] < limit2 && acceptTriplet(downsampleName)) {
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  }
+
+  /// Search for a triplet of two candidates of species A and one of species B with Q3 below the limit
+  /// \return true at the first triplet kept by the downsampling
+  template <typename TA, typename TAB>
+  bool hasLowQ3Triplet(const TripletCandidates& candsA, const TripletCandidates& candsB, float limit, TA const& vetoPairA, TAB const& vetoPairAB, const char* downsampleName)
+  {
+    const float limit2 = limit * limit;
+    const int nA = candsA.momenta.size();
+    const int nB = candsB.momenta.size();
+    if (nA < 2 || nB < 1) {
+      return false;
+    }
+    fillPairTerms(candsA, limit2, vetoPairA);
+    fillPairTerms(candsA, candsB, limit2, vetoPairAB);
+    for (int i = 0; i < nA; i++) {
+      for (int j = i + 1; j < nA; j++) {
+        if (getQ2ijMin(candsA.mass, candsA.chi[j] - candsA.chi[i]) >= limit2) {
+          break;
+        }
+        const float q2ij = q2Same[i * nA + j];
+        if (q2ij >= limit2) {
+          continue;
+        }
+        for (int k = 0; k < nB; k++) {
+          if (q2ij + q2Mixed[i * nB + k] + q2Mixed[j * nB + k] < limit2 && acceptTriplet(downsampleName)) {
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  }
+
   std::vector<double> setValuesBB(aod::BCsWithTimestamps::iterator const& bunchCrossing, const std::string ccdbPath)
   {
     map<string, string> metadata;
@@ -1496,7 +1660,61 @@ struct CFFilter {
       }
 
       float Q3 = 999.f, kstar = 999.f;
-      if (ConfTriggerSwitches->get("Switch", "ppp") > 0.) {
+      if (ConfFastTripletSearch.value) {
+        fillTripletCandidates(protons, mMassProton, candProtons);
+        fillTripletCandidates(antiprotons, mMassProton, candAntiProtons);
+        fillTripletCandidates(lambdas, mMassLambda, candLambdas);
+        fillTripletCandidates(antilambdas, mMassLambda, candAntiLambdas);
+        auto noVeto = [](int, int) { return false; };
+        auto vetoLambdaLambda = [&](int i1, int i2) {
+          return ConfAutocorRejection.value &&
+                 (LambdaPosDaughIndex.at(i1) == LambdaPosDaughIndex.at(i2) ||
+                  LambdaNegDaughIndex.at(i1) == LambdaNegDaughIndex.at(i2));
+        };
+        auto vetoAntiLambdaAntiLambda = [&](int i1, int i2) {
+          return ConfAutocorRejection.value &&
+                 (AntiLambdaPosDaughIndex.at(i1) == AntiLambdaPosDaughIndex.at(i2) ||
+                  AntiLambdaNegDaughIndex.at(i1) == AntiLambdaNegDaughIndex.at(i2));
+        };
+        auto vetoProtonLambda = [&](int iProton, int iLambda) {
+          return ConfAutocorRejection.value && ProtonIndex.at(iProton) == LambdaPosDaughIndex.at(iLambda);
+        };
+        auto vetoAntiProtonAntiLambda = [&](int iAntiProton, int iAntiLambda) {
+          return ConfAutocorRejection.value && AntiProtonIndex.at(iAntiProton) == AntiLambdaNegDaughIndex.at(iAntiLambda);
+        };
+        auto vetoLambdaProton = [&](int iLambda, int iProton) { return vetoProtonLambda(iProton, iLambda); };
+        auto vetoAntiLambdaAntiProton = [&](int iAntiLambda, int iAntiProton) { return vetoAntiProtonAntiLambda(iAntiProton, iAntiLambda); };
+
+        if (ConfTriggerSwitches->get("Switch", "ppp") > 0.) {
+          float limit = ConfQ3Limits->get(static_cast<uint>(0), CFTrigger::kPPP);
+          if (hasLowQ3Triplet(candProtons, limit, noVeto, "PPP") ||
+              hasLowQ3Triplet(candAntiProtons, limit, noVeto, "aPaPaP")) {
+            lowQ3Triplets[CFTrigger::kPPP] += 1;
+          }
+        }
+        if (ConfTriggerSwitches->get("Switch", "ppL") > 0.) {
+          float limit = ConfQ3Limits->get(static_cast<uint>(0), CFTrigger::kPPL);
+          if (hasLowQ3Triplet(candProtons, candLambdas, limit, noVeto, vetoProtonLambda, "PPL") ||
+              hasLowQ3Triplet(candAntiProtons, candAntiLambdas, limit, noVeto, vetoAntiProtonAntiLambda, "aPaPaL")) {
+            lowQ3Triplets[CFTrigger::kPPL] += 1;
+          }
+        }
+        if (ConfTriggerSwitches->get("Switch", "pLL") > 0.) {
+          float limit = ConfQ3Limits->get(static_cast<uint>(0), CFTrigger::kPLL);
+          if (hasLowQ3Triplet(candLambdas, candProtons, limit, vetoLambdaLambda, vetoLambdaProton, "PLL") ||
+              hasLowQ3Triplet(candAntiLambdas, candAntiProtons, limit, vetoAntiLambdaAntiLambda, vetoAntiLambdaAntiProton, "aPaLaL")) {
+            lowQ3Triplets[CFTrigger::kPLL] += 1;
+          }
+        }
+        if (ConfTriggerSwitches->get("Switch", "LLL") > 0.) {
+          float limit = ConfQ3Limits->get(static_cast<uint>(0), CFTrigger::kLLL);
+          if (hasLowQ3Triplet(candLambdas, limit, vetoLambdaLambda, "LLL") ||
+              hasLowQ3Triplet(candAntiLambdas, limit, vetoAntiLambdaAntiLambda, "aLaLaL")) {
+            lowQ3Triplets[CFTrigger::kLLL] += 1;
+          }
+        }
+      }
+      if (!ConfFastTripletSearch.value && ConfTriggerSwitches->get("Switch", "ppp") > 0.) {
         // ppp trigger
         for (auto iProton1 = protons.begin(); iProton1 != protons.end(); ++iProton1) {
           auto iProton2 = iProton1 + 1;
@@ -1539,7 +1757,7 @@ struct CFFilter {
           }
         }
       }
-      if (ConfTriggerSwitches->get("Switch", "ppL") > 0.) {
+      if (!ConfFastTripletSearch.value && ConfTriggerSwitches->get("Switch", "ppL") > 0.) {
         // ppl trigger
         for (auto iProton1 = protons.begin(); iProton1 != protons.end(); ++iProton1) {
           auto iProton2 = iProton1 + 1;
@@ -1596,7 +1814,7 @@ struct CFFilter {
           }
         }
       }
-      if (ConfTriggerSwitches->get("Switch", "pLL") > 0.) {
+      if (!ConfFastTripletSearch.value && ConfTriggerSwitches->get("Switch", "pLL") > 0.) {
         // pll trigger
         for (auto iLambda1 = lambdas.begin(); iLambda1 != lambdas.end(); ++iLambda1) {
           auto iLambda2 = iLambda1 + 1;
@@ -1663,7 +1881,7 @@ struct CFFilter {
           }
         }
       }
-      if (ConfTriggerSwitches->get("Switch", "LLL") > 0.) {
+      if (!ConfFastTripletSearch.value && ConfTriggerSwitches->get("Switch", "LLL") > 0.) {
         // lll trigger
         for (auto iLambda1 = lambdas.begin(); iLambda1 != lambdas.end(); ++iLambda1) {
           auto iLambda2 = iLambda1 + 1;
@@ -0,0 +1,184 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef PWGCF_CORE_QVECTORACCUMULATOR_H_
+#define PWGCF_CORE_QVECTORACCUMULATOR_H_
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+// Accumulator of weighted Q-vectors Q_{n,p} = sum_i w_i^p exp(i n phi_i) for harmonics n = 0..nHarmonics-1,
+// powers p = 0..nPowers(n)-1 and an optional number of (e.g. pT) bins.
+// Particles are buffered and processed in blocks: sin/cos are evaluated once per particle and the
+// higher harmonics are obtained by the recurrence exp(i(n+1)phi) = exp(i n phi) * exp(i phi),
+// the weight powers by repeated multiplication. The Q-vectors are stored as separate real and
+// imaginary arrays, indexed by (bin, harmonic, power).
+// The second weight w2 allows to use w1 * w2^(p-1) for p > 1 (as for POIs which are also REFs), by
+// default w2 = w1.
+// Buffered particles are added to the Q-vectors by Flush(), which is called automatically when a
+// block is full; call it before reading the Q-vectors.
+
+class QVectorAccumulator
+{
+ public:
+  static constexpr int kBlockSize = 256;
+
+  QVectorAccumulator() = default;
+
+  void Init(int nHarmonics, const std::vector<int>& nPowers, int nBins = 1)
+  {
+    fNHarmonics = nHarmonics;
+    fNBins = nBins;
+    fNPowers = nPowers;
+    fNPowers.resize(nHarmonics, nPowers.empty() ? 1 : nPowers.back());
+    fMaxPower = 0;
+    for (int h = 0; h < fNHarmonics; h++) {
+      if (fNPowers[h] > fMaxPower) {
+        fMaxPower = fNPowers[h];
+      }
+    }
+    fRe.assign(fNBins * fNHarmonics * fMaxPower, 0.);
+    fIm.assign(fNBins * fNHarmonics * fMaxPower, 0.);
+    fPhi.resize(kBlockSize);
+    fW1.resize(kBlockSize);
+    fW2.resize(kBlockSize);
+    fBin.resize(kBlockSize);
+    fCos.resize(kBlockSize);
+    fSin.resize(kBlockSize);
+    fHarRe.resize(kBlockSize);
+    fHarIm.resize(kBlockSize);
+    fWPow.resize(fMaxPower * kBlockSize);
+    fNBuffered = 0;
+  }
+  void Init(int nHarmonics, int nPowers, int nBins = 1) { Init(nHarmonics, std::vector<int>(nHarmonics, nPowers), nBins); }
+  bool IsInitialized() const { return fNHarmonics > 0; }
+
+  // Zero the Q-vectors and drop the buffered particles
+  void Reset()
+  {
+    std::fill(fRe.begin(), fRe.end(), 0.);
+    std::fill(fIm.begin(), fIm.end(), 0.);
+    fNBuffered = 0;
+  }
+
+  // Buffer one particle; w2 <= 0 means w2 = w1
+  void Add(double phi, double w1 = 1., double w2 = -1., int bin = 0)
+  {
+    fPhi[fNBuffered] = phi;
+    fW1[fNBuffered] = w1;
+    fW2[fNBuffered] = (w2 > 0. ? w2 : w1);
+    fBin[fNBuffered] = bin;
+    if (++fNBuffered == kBlockSize) {
+      Flush();
+    }
+  }
+
+  void Flush()
+  {
+    const int n = fNBuffered;
+    if (n == 0) {
+      return;
+    }
+    for (int i = 0; i < n; i++) {
+      fCos[i] = std::cos(fPhi[i]);
+      fSin[i] = std::sin(fPhi[i]);
+      fHarRe[i] = 1.;
+      fHarIm[i] = 0.;
+    }
+    // weight powers: p = 0 -> 1, p = 1 -> w1, p > 1 -> w1 * w2^(p-1)
+    double* wPow = fWPow.data();
+    for (int p = 0; p < fMaxPower; p++) {
+      double* cur = wPow + p * kBlockSize;
+      if (p == 0) {
+        for (int i = 0; i < n; i++) {
+          cur[i] = 1.;
+        }
+      } else if (p == 1) {
+        for (int i = 0; i < n; i++) {
+          cur[i] = fW1[i];
+        }
+      } else {
+        const double* prev = cur - kBlockSize;
+        for (int i = 0; i < n; i++) {
+          cur[i] = prev[i] * fW2[i];
+        }
+      }
+    }
+
+    double* hRe = fHarRe.data();
+    double* hIm = fHarIm.data();
+    const double* c1 = fCos.data();
+    const double* s1 = fSin.data();
+    for (int h = 0; h < fNHarmonics; h++) {
+      if (fNBins == 1) {
+        for (int p = 0; p < fNPowers[h]; p++) {
+          const double* w = wPow + p * kBlockSize;
+          double sumRe = 0., sumIm = 0.;
+          for (int i = 0; i < n; i++) {
+            sumRe += w[i] * hRe[i];
+            sumIm += w[i] * hIm[i];
+          }
+          fRe[h * fMaxPower + p] += sumRe;
+          fIm[h * fMaxPower + p] += sumIm;
+        }
+      } else {
+        for (int i = 0; i < n; i++) {
+          const int offset = (fBin[i] * fNHarmonics + h) * fMaxPower;
+          for (int p = 0; p < fNPowers[h]; p++) {
+            fRe[offset + p] += wPow[p * kBlockSize + i] * hRe[i];
+            fIm[offset + p] += wPow[p * kBlockSize + i] * hIm[i];
+          }
+        }
+      }
+      // exp(i(h+1)phi) = exp(i h phi) * exp(i phi)
+      for (int i = 0; i < n; i++) {
+        const double re = hRe[i] * c1[i] - hIm[i] * s1[i];
+        hIm[i] = hRe[i] * s1[i] + hIm[i] * c1[i];
+        hRe[i] = re;
+      }
+    }
+    fNBuffered = 0;
+  }
+
+  // Getters; the buffered particles are not included until Flush() is called
+  double Re(int h, int p, int bin = 0) const { return fRe[(bin * fNHarmonics + h) * fMaxPower + p]; }
+  double Im(int h, int p, int bin = 0) const { return fIm[(bin * fNHarmonics + h) * fMaxPower + p]; }
+  std::complex<double> Get(int h, int p, int bin = 0) const
+  {
+    const int index = (bin * fNHarmonics + h) * fMaxPower + p;
+    return std::complex<double>(fRe[index], fIm[index]);
+  }
+  int GetNHarmonics() const { return fNHarmonics; }
+  int GetNPowers(int h) const { return fNPowers[h]; }
+  int GetNBins() const { return fNBins; }
+
+ private:
+  int fNHarmonics = 0;        // number of harmonics, starting from 0
+  int fMaxPower = 0;          // maximum number of powers over all harmonics
+  int fNBins = 1;             // number of bins
+  std::vector<int> fNPowers;  // number of powers per harmonic
+  std::vector<double> fRe;    // real part of the Q-vectors, [(bin * fNHarmonics + h) * fMaxPower + p]
+  std::vector<double> fIm;    // imaginary part of the Q-vectors, same indexing
+  int fNBuffered = 0;         // number of particles in the current block
+  std::vector<double> fPhi;   // block: azimuthal angles
+  std::vector<double> fW1;    // block: first weight
+  std::vector<double> fW2;    // block: second weight
+  std::vector<int> fBin;      // block: bins
+  std::vector<double> fCos;   // block: cos(phi)
+  std::vector<double> fSin;   // block: sin(phi)
+  std::vector<double> fHarRe; // block: real part of exp(i h phi) for the current harmonic
+  std::vector<double> fHarIm; // block: imaginary part of exp(i h phi) for the current harmonic
+  std::vector<double> fWPow;  // block: weight powers, [p * kBlockSize + i]
+};
+
+#endif // PWGCF_CORE_QVECTORACCUMULATOR_H_
@@ -16,11 +16,15 @@
 #ifndef PWGCF_FEMTODREAM_FEMTODREAMDETADPHISTAR_H_
 #define PWGCF_FEMTODREAM_FEMTODREAMDETADPHISTAR_H_
 
+#include <array>
+#include <cmath>
 #include <memory>
 #include <string>
 #include <vector>
 #include "PWGCF/DataModel/FemtoDerived.h"
+#include "PWGCF/FemtoDream/FemtoDreamMixingPool.h"
 #include "Framework/HistogramRegistry.h"
+#include "TMath.h"
 
 using namespace o2;
 using namespace o2::framework;
@@ -88,7 +92,7 @@ class FemtoDreamDetaDphiStar
       auto deta = part1.eta() - part2.eta();
       auto dphiAvg = AveragePhiStar(part1, part2, 0);
       histdetadpi[0][0]->Fill(deta, dphiAvg);
-      if (pow(dphiAvg, 2) / pow(deltaPhiMax, 2) + pow(deta, 2) / pow(deltaEtaMax, 2) < 1.) {
+      if (isInEllipse(deta, dphiAvg)) {
         return true;
       } else {
         histdetadpi[0][1]->Fill(deta, dphiAvg);
@@ -110,7 +114,7 @@ class FemtoDreamDetaDphiStar
         auto deta = part1.eta() - daughter.eta();
         auto dphiAvg = AveragePhiStar(part1, *daughter, i);
         histdetadpi[i][0]->Fill(deta, dphiAvg);
-        if (pow(dphiAvg, 2) / pow(deltaPhiMax, 2) + pow(deta, 2) / pow(deltaEtaMax, 2) < 1.) {
+        if (isInEllipse(deta, dphiAvg)) {
           pass = true;
         } else {
           histdetadpi[i][1]->Fill(deta, dphiAvg);
@@ -123,6 +127,52 @@ class FemtoDreamDetaDphiStar
     }
   }
 
+  ///  Check if a Track-Track pair is close, using phi* at the TPC radii computed beforehand (see FemtoDreamParticleCache)
+  /// \param deta difference of the pseudorapidities of the two particles
+  /// \param phiStar1 phi* of particle 1 at the TPC radii
+  /// \param phiStar2 phi* of particle 2 at the TPC radii
+  bool isClosePair(float deta, const float* phiStar1, const float* phiStar2)
+  {
+    static_assert(mPartOneType == o2::aod::femtodreamparticle::ParticleType::kTrack && mPartTwoType == o2::aod::femtodreamparticle::ParticleType::kTrack, "FemtoDreamDetaDphiStar: cached phi* only supported for kTrack,kTrack");
+    auto dphiAvg = AveragePhiStar(deta, phiStar1, phiStar2, 0);
+    histdetadpi[0][0]->Fill(deta, dphiAvg);
+    if (isInEllipse(deta, dphiAvg)) {
+      return true;
+    }
+    histdetadpi[0][1]->Fill(deta, dphiAvg);
+    return false;
+  }
+
+  /// Invalidate the phi* computed with computePhiStar. Has to be called at the beginning of each process function,
+  /// since the stored values are indexed by the particle index, which is only valid within a data frame
+  void resetPhiStar()
+  {
+    mPhiStarCounter++;
+  }
+
+  /// Compute phi* at the TPC radii once for all the particles of a collision. In isClosePair, the stored values are used
+  /// instead of recomputing them for each pair; particles which were not passed here are computed on the fly
+  /// \param groupParts particles of one collision
+  /// \param lmagfield magnetic field of the collision (Tesla)
+  template <typename PartitionType>
+  void computePhiStar(PartitionType const& groupParts, float lmagfield)
+  {
+    for (auto& part : groupParts) {
+      const size_t index = part.index();
+      if (index >= mPhiStarStamp.size()) {
+        mPhiStar.resize(index + 1);
+        mPhiStarStamp.resize(index + 1, 0);
+        mPhiStarMagField.resize(index + 1, 0.f);
+      }
+      if (mPhiStarStamp[index] == mPhiStarCounter && mPhiStarMagField[index] == lmagfield) {
+        continue; // already computed, e.g. for a previous mixed event
+      }
+      PhiAtRadiiTPC(part, lmagfield, mPhiStar[index].data());
+      mPhiStarStamp[index] = mPhiStarCounter;
+      mPhiStarMagField[index] = lmagfield;
+    }
+  }
+
  private:
   HistogramRegistry* mHistogramRegistry = nullptr;   ///< For main output
   HistogramRegistry* mHistogramRegistryQA = nullptr; ///< For QA output
@@ -140,11 +190,7 @@ class FemtoDreamDetaDphiStar
   static constexpr o2::aod::femtodreamparticle::ParticleType mPartOneType = partOne; ///< Type of particle 1
   static constexpr o2::aod::femtodreamparticle::ParticleType mPartTwoType = partTwo; ///< Type of particle 2
 
-  static constexpr float tmpRadiiTPC[9] = {85., 105., 125., 145., 165., 185., 205., 225., 245.};
-
-  static constexpr uint32_t kSignMinusMask = 1;
-  static constexpr uint32_t kSignPlusMask = 1 << 1;
-  static constexpr uint32_t kValue0 = 0;
+  static constexpr int kNRadii = FemtoDreamParticleCache::kNRadii; ///< Number of TPC radii for phi*
 
   float deltaPhiMax;
   float deltaEtaMax;
@@ -154,50 +200,71 @@ class FemtoDreamDetaDphiStar
   std::array<std::array<std::shared_ptr<TH2>, 2>, 2> histdetadpi{};
   std::array<std::array<std::shared_ptr<TH2>, 9>, 2> histdetadpiRadii{};
 
-  ///  Calculate phi at all required radii stored in tmpRadiiTPC
+  std::vector<std::array<float, kNRadii>> mPhiStar; ///< phi* at the TPC radii, by particle index
+  std::vector<uint32_t> mPhiStarStamp;              ///< value of mPhiStarCounter when phi* was computed, by particle index
+  std::vector<float> mPhiStarMagField;              ///< magnetic field used for phi*, by particle index
+  uint32_t mPhiStarCounter = 1;                     ///< incremented by resetPhiStar to invalidate the stored phi*
+
+  ///  Calculate phi at all required radii stored in FemtoDreamParticleCache::kRadiiTPC
   /// Magnetic field to be provided in Tesla
   template <typename T>
-  void PhiAtRadiiTPC(const T& part, std::vector<float>& tmpVec)
+  void PhiAtRadiiTPC(const T& part, float lmagfield, float* phiStar)
   {
+    FemtoDreamParticleCache::phiAtRadiiTPC(part.phi(), part.pt(), part.cut(), lmagfield, phiStar);
+  }
 
-    float phi0 = part.phi();
-    // Start: Get the charge from cutcontainer using masks
-    float charge = 0.;
-    if ((part.cut() & kSignMinusMask) == kValue0 && (part.cut() & kSignPlusMask) == kValue0) {
-      charge = 0;
-    } else if ((part.cut() & kSignPlusMask) == kSignPlusMask) {
-      charge = 1;
-    } else if ((part.cut() & kSignMinusMask) == kSignMinusMask) {
-      charge = -1;
-    } else {
-      LOG(fatal) << "FemtoDreamDetaDphiStar: Charge bits are set wrong!";
+  ///  Get phi* of a particle, either computed by computePhiStar or computed now in the provided buffer
+  template <typename T>
+  const float* getPhiStar(const T& part, float* buffer)
+  {
+    const size_t index = part.index();
+    if (index < mPhiStarStamp.size() && mPhiStarStamp[index] == mPhiStarCounter && mPhiStarMagField[index] == magfield) {
+      return mPhiStar[index].data();
     }
-    // End: Get the charge from cutcontainer using masks
-    float pt = part.pt();
-    for (size_t i = 0; i < 9; i++) {
-      tmpVec.push_back(phi0 - std::asin(0.3 * charge * 0.1 * magfield * tmpRadiiTPC[i] * 0.01 / (2. * pt)));
+    PhiAtRadiiTPC(part, magfield, buffer);
+    return buffer;
+  }
+
+  ///  Azimuthal angle difference in [-pi, pi)
+  static float wrapPhi(double dphi)
+  {
+    return dphi - TMath::TwoPi() * std::floor((dphi + TMath::Pi()) / TMath::TwoPi());
+  }
+
+  ///  Check if the pair is inside the rejection ellipse
+  bool isInEllipse(float deta, float dphiAvg) const
+  {
+    const double etaTerm = static_cast<double>(deta) * deta / (static_cast<double>(deltaEtaMax) * deltaEtaMax);
+    if (etaTerm >= 1.) {
+      return false; // outside of the ellipse for any dphi
     }
+    return static_cast<double>(dphiAvg) * dphiAvg / (static_cast<double>(deltaPhiMax) * deltaPhiMax) + etaTerm < 1.;
   }
 
   ///  Calculate average phi
   template <typename T1, typename T2>
   float AveragePhiStar(const T1& part1, const T2& part2, int iHist)
   {
-    std::vector<float> tmpVec1;
-    std::vector<float> tmpVec2;
-    PhiAtRadiiTPC(part1, tmpVec1);
-    PhiAtRadiiTPC(part2, tmpVec2);
-    int num = tmpVec1.size();
+    float buffer1[kNRadii];
+    float buffer2[kNRadii];
+    return AveragePhiStar(part1.eta() - part2.eta(), getPhiStar(part1, buffer1), getPhiStar(part2, buffer2), iHist);
+  }
+
+  ///  Calculate average phi from phi* at the TPC radii
+  float AveragePhiStar(float deta, const float* phiStar1, const float* phiStar2, int iHist)
+  {
+    float dphi[kNRadii];
     float dPhiAvg = 0;
-    for (int i = 0; i < num; i++) {
-      float dphi = tmpVec1.at(i) - tmpVec2.at(i);
-      dphi = TVector2::Phi_mpi_pi(dphi);
-      dPhiAvg += dphi;
-      if (plotForEveryRadii) {
-        histdetadpiRadii[iHist][i]->Fill(part1.eta() - part2.eta(), dphi);
+    for (int i = 0; i < kNRadii; i++) {
+      dphi[i] = wrapPhi(phiStar1[i] - phiStar2[i]);
+      dPhiAvg += dphi[i];
+    }
+    if (plotForEveryRadii) {
+      for (int i = 0; i < kNRadii; i++) {
+        histdetadpiRadii[iHist][i]->Fill(deta, dphi[i]);
       }
     }
-    return dPhiAvg / num;
+    return dPhiAvg / kNRadii;
   }
 };
 
@@ -0,0 +1,191 @@
+// Copyright 2019-2022 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file FemtoDreamMixingPool.h
+/// \brief FemtoDreamMixingPool - Event pool for the event mixing, keeping the selected particles of the last events of each mixing bin
+/// \details The particles of an event are read from the tables only once, when the event is added to the pool.
+/// The pool does not depend on the FemtoDream data model and can be used with any particle providing pt(), eta(), phi() and cut()
+
+#ifndef PWGCF_FEMTODREAM_FEMTODREAMMIXINGPOOL_H_
+#define PWGCF_FEMTODREAM_FEMTODREAMMIXINGPOOL_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Framework/Logger.h"
+
+namespace o2::analysis::femtoDream
+{
+
+/// \class FemtoDreamParticleCache
+/// \brief Structure-of-arrays cache of the selected particles of one event
+/// Together with the kinematics, the azimuthal angles phi* of the particles at the TPC radii used by the close pair rejection are stored
+class FemtoDreamParticleCache
+{
+ public:
+  static constexpr int kNRadii = 9;                                                                  ///< Number of TPC radii for phi*
+  static constexpr float kRadiiTPC[kNRadii] = {85., 105., 125., 145., 165., 185., 205., 225., 245.}; ///< TPC radii (cm)
+
+  /// Lightweight view of a cached particle, providing the accessors needed by FemtoDreamMath and the containers
+  struct Particle {
+    float mPt;
+    float mEta;
+    float mPhi;
+    float pt() const { return mPt; }
+    float eta() const { return mEta; }
+    float phi() const { return mPhi; }
+  };
+
+  /// Compute phi* at the TPC radii, the charge is taken from the sign bits of the cut container
+  /// \param phi0 azimuthal angle of the particle at the primary vertex
+  /// \param pt transverse momentum of the particle
+  /// \param cut cut container of the particle
+  /// \param magField magnetic field (Tesla)
+  /// \param phiStar output array of kNRadii values
+  static void phiAtRadiiTPC(float phi0, float pt, uint32_t cut, float magField, float* phiStar)
+  {
+    float charge = 0.;
+    if ((cut & kSignMinusMask) == kValue0 && (cut & kSignPlusMask) == kValue0) {
+      charge = 0;
+    } else if ((cut & kSignPlusMask) == kSignPlusMask) {
+      charge = 1;
+    } else if ((cut & kSignMinusMask) == kSignMinusMask) {
+      charge = -1;
+    } else {
+      LOG(fatal) << "FemtoDreamParticleCache: Charge bits are set wrong!";
+    }
+    for (int i = 0; i < kNRadii; i++) {
+      phiStar[i] = phi0 - std::asin(0.3 * charge * 0.1 * magField * kRadiiTPC[i] * 0.01 / (2. * pt));
+    }
+  }
+
+  void clear()
+  {
+    mPt.clear();
+    mEta.clear();
+    mPhi.clear();
+    mCut.clear();
+    mPhiStar.clear();
+  }
+
+  /// Add a particle to the cache
+  /// \param part particle
+  /// \param magField magnetic field (Tesla) of the event, used for phi*
+  template <typename T>
+  void add(T const& part, float magField)
+  {
+    mPt.push_back(part.pt());
+    mEta.push_back(part.eta());
+    mPhi.push_back(part.phi());
+    mCut.push_back(part.cut());
+    mPhiStar.resize(mPhiStar.size() + kNRadii);
+    phiAtRadiiTPC(part.phi(), part.pt(), part.cut(), magField, mPhiStar.data() + mPhiStar.size() - kNRadii);
+  }
+
+  size_t size() const { return mPt.size(); }
+  Particle get(size_t i) const { return Particle{mPt[i], mEta[i], mPhi[i]}; }
+  float pt(size_t i) const { return mPt[i]; }
+  float eta(size_t i) const { return mEta[i]; }
+  float phi(size_t i) const { return mPhi[i]; }
+  uint32_t cut(size_t i) const { return mCut[i]; }
+  const float* phiStar(size_t i) const { return mPhiStar.data() + i * kNRadii; }
+
+ private:
+  static constexpr uint32_t kSignMinusMask = 1;
+  static constexpr uint32_t kSignPlusMask = 1 << 1;
+  static constexpr uint32_t kValue0 = 0;
+
+  std::vector<float> mPt;      ///< transverse momentum
+  std::vector<float> mEta;     ///< pseudorapidity
+  std::vector<float> mPhi;     ///< azimuthal angle
+  std::vector<uint32_t> mCut;  ///< cut container
+  std::vector<float> mPhiStar; ///< phi* at the TPC radii, kNRadii values per particle
+};
+
+/// \class FemtoDreamMixingPool
+/// \brief Ring buffer of the last events for each mixing bin
+/// A new event is first paired with the events in the pool of its bin and then added to the pool, replacing the oldest event.
+/// If the pool is cleared for every data frame, this gives the same pairs as soa::selfCombinations with the same depth,
+/// where the older event provides the first particle.
+class FemtoDreamMixingPool
+{
+ public:
+  /// Event stored in the pool
+  struct Event {
+    float magField = 0.f;             ///< magnetic field (Tesla)
+    int mult = 0;                     ///< multiplicity
+    FemtoDreamParticleCache partsOne; ///< selected particles of type one
+    FemtoDreamParticleCache partsTwo; ///< selected particles of type two
+  };
+
+  /// Initialization of the pool, the bins are created when the first event is added to them
+  /// \param depth number of events kept for each bin
+  void init(int depth)
+  {
+    if (depth < 1) {
+      LOG(fatal) << "FemtoDreamMixingPool: the mixing depth has to be positive";
+    }
+    mDepth = depth;
+    mEvents.clear();
+    mNext.clear();
+    mSize.clear();
+  }
+
+  /// Number of events in the pool of a bin
+  int getNEvents(int bin) const { return bin < static_cast<int>(mSize.size()) ? mSize[bin] : 0; }
+
+  /// Event i of the pool of a bin, 0 is the oldest one
+  const Event& getEvent(int bin, int i) const
+  {
+    int slot = (mNext[bin] - mSize[bin] + i + mDepth) % mDepth;
+    return mEvents[bin][slot];
+  }
+
+  /// Add an event to the pool of a bin, replacing the oldest one
+  /// The content of the event is swapped with the replaced slot, so that the memory of the caches is reused
+  void push(int bin, Event& event)
+  {
+    if (bin >= static_cast<int>(mEvents.size())) {
+      mEvents.resize(bin + 1);
+      mNext.resize(bin + 1, 0);
+      mSize.resize(bin + 1, 0);
+    }
+    if (mEvents[bin].empty()) {
+      mEvents[bin].resize(mDepth);
+    }
+    std::swap(mEvents[bin][mNext[bin]], event);
+    mNext[bin] = (mNext[bin] + 1) % mDepth;
+    if (mSize[bin] < mDepth) {
+      mSize[bin]++;
+    }
+    event.partsOne.clear();
+    event.partsTwo.clear();
+  }
+
+  /// Remove all events from the pool
+  void clear()
+  {
+    std::fill(mNext.begin(), mNext.end(), 0);
+    std::fill(mSize.begin(), mSize.end(), 0);
+  }
+
+ private:
+  int mDepth = 1;                          ///< number of events kept for each bin
+  std::vector<std::vector<Event>> mEvents; ///< events, per bin
+  std::vector<int> mNext;                  ///< slot to be filled next, per bin
+  std::vector<int> mSize;                  ///< number of events, per bin
+};
+
+} // namespace o2::analysis::femtoDream
+
+#endif // PWGCF_FEMTODREAM_FEMTODREAMMIXINGPOOL_H_
@@ -31,6 +31,7 @@
 #include "FemtoDreamPairCleaner.h"
 #include "FemtoDreamContainer.h"
 #include "FemtoDreamDetaDphiStar.h"
+#include "FemtoDreamMixingPool.h"
 #include "FemtoUtils.h"
 
 using namespace o2;
@@ -128,6 +129,8 @@ struct femtoDreamPairTaskTrackTrack {
   FemtoDreamContainer<femtoDreamContainer::EventType::mixed, femtoDreamContainer::Observable::kstar> mixedEventCont;
   FemtoDreamPairCleaner<aod::femtodreamparticle::ParticleType::kTrack, aod::femtodreamparticle::ParticleType::kTrack> pairCleaner;
   FemtoDreamDetaDphiStar<aod::femtodreamparticle::ParticleType::kTrack, aod::femtodreamparticle::ParticleType::kTrack> pairCloseRejection;
+  FemtoDreamMixingPool mixingPool;         ///< Pool of the last events of each mixing bin, used by processMixedEventPool
+  FemtoDreamMixingPool::Event mixingEvent; ///< Cache of the current event, swapped into the pool after mixing
   /// Histogram output
   HistogramRegistry qaRegistry{"TrackQA", {}, OutputObjHandlingPolicy::AnalysisObject};
   HistogramRegistry resultRegistry{"Correlations", {}, OutputObjHandlingPolicy::AnalysisObject};
@@ -157,6 +160,10 @@ struct femtoDreamPairTaskTrackTrack {
     vPIDPartOne = ConfPIDPartOne.value;
     vPIDPartTwo = ConfPIDPartTwo.value;
     kNsigma = ConfTrkPIDnSigmaMax.value;
+
+    if (doprocessMixedEventPool) {
+      mixingPool.init(ConfNEventsMix.value);
+    }
   }
 
   template <typename CollisionType>
@@ -217,6 +224,12 @@ struct femtoDreamPairTaskTrackTrack {
         trackHistoPartTwo.fillQA<isMC, false>(part, aod::femtodreamparticle::kPt);
       }
     }
+    /// Compute phi* of all the particles once, before building the combinations
+    if (ConfIsCPR.value) {
+      pairCloseRejection.computePhiStar(groupPartsOne, magFieldTesla);
+      pairCloseRejection.computePhiStar(groupPartsTwo, magFieldTesla);
+    }
+
     /// Now build the combinations
     for (auto& [p1, p2] : combinations(CombinationsStrictlyUpperIndexPolicy(groupPartsOne, groupPartsTwo))) {
       if (p1.p() > ConfCutTable->get("PartOne", "MaxP") || p1.pt() > ConfCutTable->get("PartOne", "MaxPt") || p2.p() > ConfCutTable->get("PartTwo", "MaxP") || p2.pt() > ConfCutTable->get("PartTwo", "MaxPt")) {
@@ -262,6 +275,7 @@ struct femtoDreamPairTaskTrackTrack {
                         o2::aod::FDParticles& parts)
   {
     fillCollision(col);
+    pairCloseRejection.resetPhiStar();
 
     auto thegroupPartsOne = partsOne->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
     auto thegroupPartsTwo = partsTwo->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
@@ -279,6 +293,7 @@ struct femtoDreamPairTaskTrackTrack {
                           o2::aod::FDMCParticles&)
   {
     fillCollision(col);
+    pairCloseRejection.resetPhiStar();
 
     auto thegroupPartsOne = partsOneMC->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
     auto thegroupPartsTwo = partsTwoMC->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
@@ -300,6 +315,10 @@ struct femtoDreamPairTaskTrackTrack {
   template <bool isMC, typename PartitionType, typename PartType>
   void doMixedEvent(PartitionType groupPartsOne, PartitionType groupPartsTwo, PartType parts, float magFieldTesla, int multCol)
   {
+    if (ConfIsCPR.value) {
+      pairCloseRejection.computePhiStar(groupPartsOne, magFieldTesla);
+      pairCloseRejection.computePhiStar(groupPartsTwo, magFieldTesla);
+    }
 
     for (auto& [p1, p2] : combinations(CombinationsFullIndexPolicy(groupPartsOne, groupPartsTwo))) {
       if (p1.p() > ConfCutTable->get("PartOne", "MaxP") || p1.pt() > ConfCutTable->get("PartOne", "MaxPt") || p2.p() > ConfCutTable->get("PartTwo", "MaxP") || p2.pt() > ConfCutTable->get("PartTwo", "MaxPt")) {
@@ -340,6 +359,7 @@ struct femtoDreamPairTaskTrackTrack {
   void processMixedEvent(o2::aod::FDCollisions& cols,
                          o2::aod::FDParticles& parts)
   {
+    pairCloseRejection.resetPhiStar();
     for (auto& [collision1, collision2] : soa::selfCombinations(colBinning, 5, -1, cols, cols)) {
 
       const int multiplicityCol = collision1.multNtr();
@@ -370,6 +390,7 @@ struct femtoDreamPairTaskTrackTrack {
                            soa::Join<o2::aod::FDParticles, o2::aod::FDMCLabels>& parts,
                            o2::aod::FDMCParticles&)
   {
+    pairCloseRejection.resetPhiStar();
     for (auto& [collision1, collision2] : soa::selfCombinations(colBinning, 5, -1, cols, cols)) {
 
       const int multiplicityCol = collision1.multNtr();
@@ -391,6 +412,90 @@ struct femtoDreamPairTaskTrackTrack {
     }
   }
   PROCESS_SWITCH(femtoDreamPairTaskTrackTrack, processMixedEventMC, "Enable processing mixed events MC", false);
+
+  /// Fill the cache of the mixing pool with the particles of a partition passing the momentum and PID selections
+  /// \tparam PartitionType
+  /// \param groupParts partition of the particles of one collision
+  /// \param partName name of the particle in ConfCutTable (PartOne/PartTwo)
+  /// \param vPID PID selection of the particle
+  /// \param magFieldTesla magnetic field of the collision
+  /// \param particleCache cache to be filled
+  template <typename PartitionType>
+  void fillParticleCache(PartitionType& groupParts, const char* partName, int vPID, float magFieldTesla, FemtoDreamParticleCache& particleCache)
+  {
+    particleCache.clear();
+    for (auto& part : groupParts) {
+      if (part.p() > ConfCutTable->get(partName, "MaxP") || part.pt() > ConfCutTable->get(partName, "MaxPt")) {
+        continue;
+      }
+      if (!isFullPIDSelected(part.pidcut(),
+                             part.p(),
+                             ConfCutTable->get(partName, "PIDthr"),
+                             vPID,
+                             ConfNspecies,
+                             kNsigma,
+                             ConfCutTable->get(partName, "nSigmaTPC"),
+                             ConfCutTable->get(partName, "nSigmaTPCTOF"))) {
+        continue;
+      }
+      particleCache.add(part, magFieldTesla);
+    }
+  }
+
+  /// This function pairs the cached particles of two events for the mixed event
+  /// \param cacheOne particles of type one of the older event
+  /// \param cacheTwo particles of type two of the newer event
+  /// \param multCol multiplicity of the older event
+  void doMixedEventCached(const FemtoDreamParticleCache& cacheOne, const FemtoDreamParticleCache& cacheTwo, int multCol)
+  {
+    for (size_t i = 0; i < cacheOne.size(); i++) {
+      const auto p1 = cacheOne.get(i);
+      for (size_t j = 0; j < cacheTwo.size(); j++) {
+        if (ConfIsCPR.value) {
+          if (pairCloseRejection.isClosePair(cacheOne.eta(i) - cacheTwo.eta(j), cacheOne.phiStar(i), cacheTwo.phiStar(j))) {
+            continue;
+          }
+        }
+        mixedEventCont.setPair<false>(p1, cacheTwo.get(j), multCol, ConfUse3D, ConfExtendedPlots);
+      }
+    }
+  }
+
+  /// process function for the mixed event with the mixing pool (Data)
+  /// The particles of each collision are selected and read only once, and paired with the cached particles of the
+  /// previous ConfNEventsMix collisions of the same mixing bin. The pairs are the same as in processMixedEvent.
+  /// @param cols subscribe to the collisions table (Data)
+  /// @param FDParticles subscribe to the femtoDreamParticleTable
+  void processMixedEventPool(o2::aod::FDCollisions& cols,
+                             o2::aod::FDParticles&)
+  {
+    mixingPool.clear();
+    for (auto& col : cols) {
+      const int bin = colBinning.getBin({col.posZ(), col.multNtr()});
+      if (bin < 0) {
+        continue;
+      }
+
+      auto groupPartsOne = partsOne->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
+      auto groupPartsTwo = partsTwo->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
+
+      mixingEvent.magField = col.magField();
+      mixingEvent.mult = col.multNtr();
+      fillParticleCache(groupPartsOne, "PartOne", vPIDPartOne, mixingEvent.magField, mixingEvent.partsOne);
+      fillParticleCache(groupPartsTwo, "PartTwo", vPIDPartTwo, mixingEvent.magField, mixingEvent.partsTwo);
+
+      for (int iEvent = 0; iEvent < mixingPool.getNEvents(bin); iEvent++) {
+        const auto& poolEvent = mixingPool.getEvent(bin, iEvent);
+        MixQaRegistry.fill(HIST("MixingQA/hMECollisionBins"), bin);
+        if (poolEvent.magField != mixingEvent.magField) {
+          continue;
+        }
+        doMixedEventCached(poolEvent.partsOne, mixingEvent.partsTwo, poolEvent.mult);
+      }
+      mixingPool.push(bin, mixingEvent);
+    }
+  }
+  PROCESS_SWITCH(femtoDreamPairTaskTrackTrack, processMixedEventPool, "Enable processing mixed events with the mixing pool (replaces processMixedEvent)", false);
 };
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
@@ -227,6 +227,12 @@ struct femtoUniversePairTaskTrackTrack {
         trackHistoPartTwo.fillQA<isMC, false>(part);
       }
     }
+    /// Compute phi* of all the particles once, before building the combinations
+    if (ConfIsCPR.value) {
+      pairCloseRejection.computePhiStar(groupPartsOne, magFieldTesla);
+      pairCloseRejection.computePhiStar(groupPartsTwo, magFieldTesla);
+    }
+
     /// Now build the combinations
     for (auto& [p1, p2] : combinations(CombinationsStrictlyUpperIndexPolicy(groupPartsOne, groupPartsTwo))) {
       if (p1.p() > ConfCutTable->get("PartOne", "MaxP") || p1.pt() > ConfCutTable->get("PartOne", "MaxPt") || p2.p() > ConfCutTable->get("PartTwo", "MaxP") || p2.pt() > ConfCutTable->get("PartTwo", "MaxPt")) {
@@ -274,6 +280,7 @@ struct femtoUniversePairTaskTrackTrack {
                         o2::aod::FDParticles& parts)
   {
     fillCollision(col);
+    pairCloseRejection.resetPhiStar();
 
     auto thegroupPartsOne = partsOne->sliceByCached(aod::femtouniverseparticle::fdCollisionId, col.globalIndex(), cache);
     auto thegroupPartsTwo = partsTwo->sliceByCached(aod::femtouniverseparticle::fdCollisionId, col.globalIndex(), cache);
@@ -291,6 +298,7 @@ struct femtoUniversePairTaskTrackTrack {
                           o2::aod::FDMCParticles&)
   {
     fillCollision(col);
+    pairCloseRejection.resetPhiStar();
 
     auto thegroupPartsOne = partsOneMC->sliceByCached(aod::femtouniverseparticle::fdCollisionId, col.globalIndex(), cache);
     auto thegroupPartsTwo = partsTwoMC->sliceByCached(aod::femtouniverseparticle::fdCollisionId, col.globalIndex(), cache);
@@ -312,6 +320,10 @@ struct femtoUniversePairTaskTrackTrack {
   template <bool isMC, typename PartitionType, typename PartType>
   void doMixedEvent(PartitionType groupPartsOne, PartitionType groupPartsTwo, PartType parts, float magFieldTesla, int multCol)
   {
+    if (ConfIsCPR.value) {
+      pairCloseRejection.computePhiStar(groupPartsOne, magFieldTesla);
+      pairCloseRejection.computePhiStar(groupPartsTwo, magFieldTesla);
+    }
 
     for (auto& [p1, p2] : combinations(CombinationsFullIndexPolicy(groupPartsOne, groupPartsTwo))) {
       if (p1.p() > ConfCutTable->get("PartOne", "MaxP") || p1.pt() > ConfCutTable->get("PartOne", "MaxPt") || p2.p() > ConfCutTable->get("PartTwo", "MaxP") || p2.pt() > ConfCutTable->get("PartTwo", "MaxPt")) {
@@ -353,6 +365,7 @@ struct femtoUniversePairTaskTrackTrack {
   void processMixedEvent(o2::aod::FDCollisions& cols,
                          o2::aod::FDParticles& parts)
   {
+    pairCloseRejection.resetPhiStar();
     for (auto& [collision1, collision2] : soa::selfCombinations(colBinning, 5, -1, cols, cols)) {
 
       const int multiplicityCol = collision1.multNtr();
@@ -383,6 +396,7 @@ struct femtoUniversePairTaskTrackTrack {
                            soa::Join<o2::aod::FDParticles, o2::aod::FDMCLabels>& parts,
                            o2::aod::FDMCParticles&)
   {
+    pairCloseRejection.resetPhiStar();
     for (auto& [collision1, collision2] : soa::selfCombinations(colBinning, 5, -1, cols, cols)) {
 
       const int multiplicityCol = collision1.multNtr();
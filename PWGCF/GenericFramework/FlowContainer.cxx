@@ -149,6 +149,43 @@ int FlowContainer::FillProfile(const char* hname, double multi, double corr, dou
   };
   return 0;
 };
+int FlowContainer::GetProfileHandle(const char* hname)
+{
+  if (!fProf)
+    return -1;
+  int yin = fProf->GetYaxis()->FindFixBin(hname);
+  if (yin < 1) {
+    printf("Could not find bin %s\n", hname);
+    return -1;
+  };
+  return yin;
+};
+int FlowContainer::FillProfile(int handle, double multi, double corr, double w, double rn)
+{
+  if (!fProf || handle < 1)
+    return -1;
+  fProf->Fill(multi, handle, corr, w);
+  if (fNRandom) {
+    double rnind = rn * fNRandom;
+    ((TProfile2D*)fProfRand->At((int)rnind))->Fill(multi, handle, corr, w);
+  };
+  return 0;
+};
+int FlowContainer::FillProfiles(int nCorr, const int* handles, double multi, const double* corr, const double* w, double rn)
+{
+  if (!fProf)
+    return -1;
+  // the bootstrap sub-profile is the same for all correlators of the event
+  TProfile2D* profRand = fNRandom ? (TProfile2D*)fProfRand->At((int)(rn * fNRandom)) : 0;
+  for (int i = 0; i < nCorr; i++) {
+    if (handles[i] < 1)
+      continue;
+    fProf->Fill(multi, handles[i], corr[i], w[i]);
+    if (profRand)
+      profRand->Fill(multi, handles[i], corr[i], w[i]);
+  }
+  return 0;
+};
 void FlowContainer::OverrideProfileErrors(TProfile2D* inpf)
 {
   int nBinsX = fProf->GetNbinsX();
@@ -50,6 +50,9 @@ class FlowContainer : public TNamed
   int GetNMultiBins() { return fProf->GetNbinsX(); }
   double GetMultiAtBin(int bin) { return fProf->GetXaxis()->GetBinCenter(bin); }
   int FillProfile(const char* hname, double multi, double y, double w, double rn);
+  int GetProfileHandle(const char* hname); // Resolves the correlator name once; the handle is valid until the profile is re-initialized, -1 if not found
+  int FillProfile(int handle, double multi, double y, double w, double rn);
+  int FillProfiles(int nCorr, const int* handles, double multi, const double* y, const double* w, double rn); // All correlators of an event in one pass
   TProfile2D* GetProfile() { return fProf; }
   void OverrideProfileErrors(TProfile2D* inpf);
   void ReadAndMerge(const char* infile);
@@ -305,6 +305,149 @@ complex<double> GFW::Calculate(CorrConfig corconf, int ptbin, bool SetHarmsToZer
   }
   return retval;
 };
+int GFW::AddDAGLeaf(int cumulant, int har, int pow, int ptbin)
+{
+  vector<int> key{-1, cumulant, har, pow, ptbin};
+  auto it = fDAGNodeMap.find(key);
+  if (it != fDAGNodeMap.end())
+    return it->second;
+  DAGNode node;
+  node.Leaf = cumulant;
+  node.Har = har;
+  node.Pow = pow;
+  node.Pt = ptbin;
+  fDAGNodes.push_back(node);
+  fDAGNodeMap[key] = static_cast<int>(fDAGNodes.size()) - 1;
+  return static_cast<int>(fDAGNodes.size()) - 1;
+};
+int GFW::AddDAGCorr(int poi, int ref, int ol, int ptbin, vector<int>& hars, vector<int>& pows)
+{
+  if ((pows.at(0) != 1) && ol > -1)
+    poi = ol; // same as in RecursiveCorr
+  if (hars.size() < 2)
+    return AddDAGLeaf(poi, hars.at(0), pows.at(0), ptbin);
+  // The value of a term only depends on the regions, pT bin, harmonics and powers
+  vector<int> key{static_cast<int>(hars.size()), poi, ref, ol, ptbin};
+  key.insert(key.end(), hars.begin(), hars.end());
+  key.insert(key.end(), pows.begin(), pows.end());
+  auto it = fDAGNodeMap.find(key);
+  if (it != fDAGNodeMap.end())
+    return it->second;
+  DAGNode node;
+  vector<pair<int, int>> subtractions;
+  if (hars.size() < 3) { // same as TwoRec
+    node.Factor1 = AddDAGLeaf(poi, hars.at(0), pows.at(0), ptbin);
+    node.Factor2 = AddDAGLeaf(ref, hars.at(1), pows.at(1), ptbin);
+    if (ol > -1)
+      subtractions.push_back(std::make_pair(AddDAGLeaf(ol, hars.at(0) + hars.at(1), pows.at(0) + pows.at(1), ptbin), 1));
+  } else {
+    int harlast = hars.at(hars.size() - 1);
+    int powlast = pows.at(pows.size() - 1);
+    hars.erase(hars.end() - 1);
+    pows.erase(pows.end() - 1);
+    node.Factor1 = AddDAGCorr(poi, ref, ol, ptbin, hars, pows);
+    node.Factor2 = AddDAGLeaf(ref, harlast, powlast, 0);
+    int lDegeneracy = 1;
+    int harSize = static_cast<int>(hars.size());
+    for (int i = harSize - 1; i >= 0; i--) {
+      if (i > 2) {
+        if (hars.at(i) == hars.at(i - 1) && pows.at(i) == pows.at(i - 1)) {
+          lDegeneracy++;
+          continue;
+        }
+      }
+      hars.at(i) += harlast;
+      pows.at(i) += powlast;
+      subtractions.push_back(std::make_pair(AddDAGCorr(poi, ref, ol, ptbin, hars, pows), lDegeneracy));
+      lDegeneracy = 1;
+      hars.at(i) -= harlast;
+      pows.at(i) -= powlast;
+    }
+    hars.push_back(harlast);
+    pows.push_back(powlast);
+  }
+  // subtracted terms are stored contiguously, after all the nodes they depend on have been added
+  node.SubFirst = static_cast<int>(fDAGSubtractions.size());
+  node.NSub = static_cast<int>(subtractions.size());
+  fDAGSubtractions.insert(fDAGSubtractions.end(), subtractions.begin(), subtractions.end());
+  fDAGNodes.push_back(node);
+  fDAGNodeMap[key] = static_cast<int>(fDAGNodes.size()) - 1;
+  return static_cast<int>(fDAGNodes.size()) - 1;
+};
+int GFW::GetCorrelatorHandle(const CorrConfig& corconf, int ptbin, bool SetHarmsToZero)
+{
+  // Same logic as in Calculate(corconf, ptbin, SetHarmsToZero); the checks on the filled pT bins and on the number of particles are done per event
+  DAGCorr corr;
+  corr.SubFirst = static_cast<int>(fDAGSubevents.size());
+  corr.NSub = 0;
+  bool alwaysZero = (corconf.Regs.size() == 0);
+  for (int i = 0; i < static_cast<int>(corconf.Regs.size()) && !alwaysZero; i++) {
+    if (corconf.Regs.at(i).size() == 0) {
+      alwaysZero = true;
+      break;
+    }
+    DAGSubevent subevent;
+    subevent.PtInd = corconf.ptInd.at(i);
+    if (subevent.PtInd < 0)
+      subevent.PtInd = ptbin;
+    subevent.Poi = corconf.Regs.at(i).at(0);
+    subevent.Ref = (corconf.Regs.at(i).size() > 1) ? corconf.Regs.at(i).at(1) : corconf.Regs.at(i).at(0);
+    subevent.MinN = corconf.Hars.at(i).size();
+    if (subevent.Poi != subevent.Ref)
+      subevent.MinN--;
+    int ovl = corconf.Overlap.at(i);
+    if (ovl < 0 && subevent.Ref == subevent.Poi)
+      ovl = subevent.Ref;
+    vector<int> hars = corconf.Hars.at(i);
+    if (SetHarmsToZero)
+      std::fill(hars.begin(), hars.end(), 0);
+    vector<int> pows(hars.size(), 1);
+    subevent.Node = AddDAGCorr(subevent.Poi, subevent.Ref, ovl, subevent.PtInd, hars, pows);
+    fDAGSubevents.push_back(subevent);
+    corr.NSub++;
+  }
+  if (alwaysZero) {
+    fDAGSubevents.resize(corr.SubFirst);
+    corr.NSub = 0;
+  }
+  fDAGCorrs.push_back(corr);
+  fDAGValues.resize(fDAGNodes.size());
+  fDAGResults.resize(fDAGCorrs.size());
+  return static_cast<int>(fDAGCorrs.size()) - 1;
+};
+void GFW::CalculateAll()
+{
+  const int nNodes = static_cast<int>(fDAGNodes.size());
+  for (int i = 0; i < nNodes; i++) {
+    const DAGNode& node = fDAGNodes[i];
+    if (node.Leaf > -1) {
+      fDAGValues[i] = fCumulants[node.Leaf].Vec(node.Har, node.Pow, node.Pt);
+      continue;
+    }
+    complex<double> formula = fDAGValues[node.Factor1] * fDAGValues[node.Factor2];
+    for (int j = node.SubFirst; j < node.SubFirst + node.NSub; j++) {
+      if (fDAGSubtractions[j].second > 1)
+        formula -= fDAGValues[fDAGSubtractions[j].first] * static_cast<double>(fDAGSubtractions[j].second);
+      else
+        formula -= fDAGValues[fDAGSubtractions[j].first];
+    }
+    fDAGValues[i] = formula;
+  }
+  for (int i = 0; i < static_cast<int>(fDAGCorrs.size()); i++) {
+    const DAGCorr& corr = fDAGCorrs[i];
+    complex<double> retval(corr.NSub ? 1 : 0, 0);
+    for (int j = corr.SubFirst; j < corr.SubFirst + corr.NSub; j++) {
+      const DAGSubevent& subevent = fDAGSubevents[j];
+      GFWCumulant& qref = fCumulants[subevent.Ref];
+      if (!qref.IsPtBinFilled(subevent.PtInd) || !fCumulants[subevent.Poi].IsPtBinFilled(subevent.PtInd) || qref.GetN() < subevent.MinN) {
+        retval = complex<double>(0, 0);
+        break;
+      }
+      retval *= fDAGValues[subevent.Node];
+    }
+    fDAGResults[i] = retval;
+  }
+};
 vector<pair<int, vector<int>>> GFW::GetHarmonicsSingleConfig(const CorrConfig& incfg)
 {
   vector<pair<int, vector<int>>> retPair;
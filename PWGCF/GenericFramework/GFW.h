@@ -26,6 +26,7 @@ If used, modified, or distributed, please aknowledge the author of this code.
 #include <utility>
 #include <algorithm>
 #include <complex>
+#include <map>
 
 class GFW
 {
@@ -67,6 +68,11 @@ class GFW
   CorrConfig GetCorrelatorConfig(std::string config, std::string head = "", bool ptdif = false);
   std::complex<double> Calculate(CorrConfig corconf, int ptbin, bool SetHarmsToZero);
   void InitializePowerArrays();
+  // Non-recursive evaluation: the correlators are registered once and expanded into a graph of distinct terms shared by all of them.
+  // CalculateAll() then evaluates the whole graph for the current event, and GetCorrelator(handle) returns the same as Calculate(corconf, ptbin, SetHarmsToZero)
+  int GetCorrelatorHandle(const CorrConfig& corconf, int ptbin, bool SetHarmsToZero);
+  void CalculateAll();
+  std::complex<double> GetCorrelator(int handle) { return fDAGResults[handle]; }
 
  protected:
   bool fInitialized;
@@ -74,6 +80,28 @@ class GFW
   std::complex<double> TwoRec(int n1, int n2, int p1, int p2, int ptbin, GFWCumulant*, GFWCumulant*, GFWCumulant*);
   std::complex<double> RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, std::vector<int>& hars, std::vector<int>& pows); // POI, Ref. flow, overlapping region
   std::complex<double> RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, std::vector<int>& hars);                         // POI, Ref. flow, overlapping region
+  // Graph of the terms of all registered correlators, ordered such that every node only depends on the preceding ones
+  struct DAGNode {
+    int Leaf = -1;                  // cumulant index if the node is a Q-vector, -1 otherwise
+    int Har = 0, Pow = 0, Pt = 0;   // Q-vector indices of a leaf
+    int Factor1 = -1, Factor2 = -1; // node = Factor1 * Factor2 - sum of the subtracted terms
+    int SubFirst = 0, NSub = 0;     // range of the subtracted terms in fDAGSubtractions
+  };
+  struct DAGSubevent {
+    int Poi, Ref, PtInd, MinN, Node;
+  };
+  struct DAGCorr {
+    int SubFirst = 0, NSub = 0; // range of the subevents in fDAGSubevents; no subevents means always 0
+  };
+  std::vector<DAGNode> fDAGNodes;                    //!
+  std::vector<std::pair<int, int>> fDAGSubtractions; //! node index and degeneracy
+  std::vector<DAGSubevent> fDAGSubevents;            //!
+  std::vector<DAGCorr> fDAGCorrs;                    //!
+  std::map<std::vector<int>, int> fDAGNodeMap;       //! term -> node index, only used when registering
+  std::vector<std::complex<double>> fDAGValues;      //!
+  std::vector<std::complex<double>> fDAGResults;     //!
+  int AddDAGLeaf(int cumulant, int har, int pow, int ptbin);
+  int AddDAGCorr(int poi, int ref, int ol, int ptbin, std::vector<int>& hars, std::vector<int>& pows); // Mirrors RecursiveCorr
   void AddRegion(Region inreg) { fRegions.push_back(inreg); }
   Region GetRegion(int index) { return fRegions.at(index); }
   int FindRegionByName(std::string refName);
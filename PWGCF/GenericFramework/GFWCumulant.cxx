@@ -22,7 +22,7 @@ If used, modified, or distributed, please aknowledge the author of this code.
 using std::complex;
 using std::vector;
 
-GFWCumulant::GFWCumulant() : fQvector(0),
+GFWCumulant::GFWCumulant() : fQvector(),
                              fUsed(kBlank),
                              fNEntries(-1),
                              fN(1),
@@ -41,52 +41,25 @@ void GFWCumulant::FillArray(int ptin, double phi, double weight, double SecondWe
   else if (ptin < 0 || ptin >= fPt)
     return;
   fFilledPts[ptin] = true;
-  for (int lN = 0; lN < fN; lN++) {
-    double lSin = sin(lN * phi); // No need to recalculate for each power
-    double lCos = cos(lN * phi); // No need to recalculate for each power
-    for (int lPow = 0; lPow < PW(lN); lPow++) {
-      double lPrefactor = 0;
-      // Dont calculate it twice; multiplication is cheaper that power
-      // Also, if second weight is specified, then keep the first weight with power no more than 1, and us the other weight otherwise
-      // this is important when POIs are a subset of REFs and have different weights than REFs
-      if (SecondWeight > 0 && lPow > 1)
-        lPrefactor = pow(SecondWeight, lPow - 1) * weight;
-      else
-        lPrefactor = pow(weight, lPow);
-      double qsin = lPrefactor * lSin;
-      double qcos = lPrefactor * lCos;
-      fQvector[ptin][lN][lPow] += complex<double>(qcos, qsin);
-    }
-  }
+  // Harmonics and weight powers are calculated for a block of particles at once, see QVectorAccumulator.
+  // If second weight is specified, then keep the first weight with power no more than 1, and use the other weight otherwise
+  // this is important when POIs are a subset of REFs and have different weights than REFs
+  fQvector.Add(phi, weight, SecondWeight, ptin);
   Inc();
 };
 void GFWCumulant::ResetQs()
 {
   if (!fNEntries)
     return; // If 0 entries, then no need to reset. Otherwise, if -1, then just initialized and need to set to 0.
-  for (int i = 0; i < fPt; i++) {
+  for (int i = 0; i < fPt; i++)
     fFilledPts[i] = false;
-    for (int lN = 0; lN < fN; lN++) {
-      for (int lPow = 0; lPow < PW(lN); lPow++) {
-        fQvector[i][lN][lPow] = fNullQ;
-      }
-    }
-  }
+  fQvector.Reset();
   fNEntries = 0;
 };
 void GFWCumulant::DestroyComplexVectorArray()
 {
   if (!fInitialized)
     return;
-  for (int l_n = 0; l_n < fN; l_n++) {
-    for (int i = 0; i < fPt; i++) {
-      delete[] fQvector[i][l_n];
-    }
-  }
-  for (int i = 0; i < fPt; i++) {
-    delete[] fQvector[i];
-  }
-  delete[] fQvector;
   delete[] fFilledPts;
   fInitialized = false;
   fNEntries = -1;
@@ -108,15 +81,7 @@ void GFWCumulant::CreateComplexVectorArrayVarPower(int N, vector<int> PowVec, in
   fPt = Pt;
   fFilledPts = new bool[Pt];
   fPowVec = PowVec;
-  fQvector = new complex<double>**[fPt];
-  for (int i = 0; i < fPt; i++) {
-    fQvector[i] = new complex<double>*[fN];
-  }
-  for (int l_n = 0; l_n < fN; l_n++) {
-    for (int i = 0; i < fPt; i++) {
-      fQvector[i][l_n] = new complex<double>[PW(l_n)];
-    }
-  }
+  fQvector.Init(fN, fPowVec, fPt);
   ResetQs();
   fInitialized = true;
 };
@@ -126,9 +91,10 @@ complex<double> GFWCumulant::Vec(int n, int p, int ptbin)
     return 0;
   if (ptbin >= fPt || ptbin < 0)
     ptbin = 0;
+  fQvector.Flush(); // Add the particles still in the buffer
   if (n >= 0)
-    return fQvector[ptbin][n][p];
-  return conj(fQvector[ptbin][-n][p]);
+    return fQvector.Get(n, p, ptbin);
+  return conj(fQvector.Get(-n, p, ptbin));
 };
 bool GFWCumulant::IsPtBinFilled(int ptb)
 {
@@ -23,6 +23,8 @@ If used, modified, or distributed, please aknowledge the author of this code.
 #include <complex>
 #include <vector>
 
+#include "PWGCF/Core/QVectorAccumulator.h"
+
 class GFWCumulant
 {
  public:
@@ -47,7 +49,7 @@ class GFWCumulant
   void DestroyComplexVectorArray();
   std::complex<double> Vec(int, int, int ptbin = 0); // envelope class to summarize pt-dif. Q-vec getter
  protected:
-  std::complex<double>*** fQvector;
+  QVectorAccumulator fQvector; //! Q-vectors, filled in blocks
   uint fUsed;
   int fNEntries;
   // Q-vectors. Could be done recursively, but maybe defining each one of them explicitly is easier to read
@@ -21,7 +21,11 @@ GFWWeights::GFWWeights() : TNamed("", ""),
                            fIntEff(0),
                            fAccInt(0),
                            fNbinsPt(0),
-                           fbinsPt(0) {}
+                           fbinsPt(0),
+                           fFrozen(kFALSE),
+                           fFrozenNUA(),
+                           fFrozenNUE(),
+                           fFrozenWeight() {}
 GFWWeights::GFWWeights(const char* name) : TNamed(name, name),
                                            fDataFilled(kFALSE),
                                            fMCFilled(kFALSE),
@@ -32,7 +36,11 @@ GFWWeights::GFWWeights(const char* name) : TNamed(name, name),
                                            fIntEff(0),
                                            fAccInt(0),
                                            fNbinsPt(0),
-                                           fbinsPt(0) {}
+                                           fbinsPt(0),
+                                           fFrozen(kFALSE),
+                                           fFrozenNUA(),
+                                           fFrozenNUE(),
+                                           fFrozenWeight() {}
 GFWWeights::~GFWWeights()
 {
   delete fW_data;
@@ -130,6 +138,8 @@ double GFWWeights::GetWeight(double phi, double eta, double vz, double pt, doubl
   }
   if (!tar)
     return 1;
+  if (fFrozen && fFrozenWeight[htype].IsSet())
+    return fFrozenWeight[htype].GetInvWeight(htype ? pt : phi, eta, vz);
   TH3D* th3 = reinterpret_cast<TH3D*>(tar->FindObject(GetBinName(0, 0, pf)));
   if (!th3)
     return 1; //-1;
@@ -143,6 +153,8 @@ double GFWWeights::GetWeight(double phi, double eta, double vz, double pt, doubl
 };
 double GFWWeights::GetNUA(double phi, double eta, double vz)
 {
+  if (fFrozen && fFrozenNUA.IsSet())
+    return fFrozenNUA.GetInvWeight(phi, eta, vz);
   if (!fAccInt)
     CreateNUA();
   int xind = fAccInt->GetXaxis()->FindBin(phi);
@@ -155,6 +167,8 @@ double GFWWeights::GetNUA(double phi, double eta, double vz)
 }
 double GFWWeights::GetNUE(double pt, double eta, double vz)
 {
+  if (fFrozen && fFrozenNUE.IsSet())
+    return fFrozenNUE.GetInvWeight(pt, eta, vz);
   if (!fEffInt)
     CreateNUE();
   int xind = fEffInt->GetXaxis()->FindBin(pt);
@@ -165,6 +179,63 @@ double GFWWeights::GetNUE(double pt, double eta, double vz)
     return 1. / weight;
   return 1;
 }
+void GFWWeights::FrozenAxis::Set(const TAxis* ax)
+{
+  fNbins = ax->GetNbins();
+  fMin = ax->GetXmin();
+  fMax = ax->GetXmax();
+  fScale = fNbins / (fMax - fMin);
+  fEdges.clear();
+  if (ax->GetXbins()->GetSize())
+    fEdges.assign(ax->GetXbins()->GetArray(), ax->GetXbins()->GetArray() + fNbins + 1);
+}
+void GFWWeights::FrozenHist::Set(TH3D* inh)
+{
+  fInvWeights.clear();
+  if (!inh)
+    return;
+  fX.Set(inh->GetXaxis());
+  fY.Set(inh->GetYaxis());
+  fZ.Set(inh->GetZaxis());
+  fInvWeights.resize((fX.fNbins + 2) * (fY.fNbins + 2) * (fZ.fNbins + 2));
+  for (int k = 0; k <= fZ.fNbins + 1; k++)
+    for (int j = 0; j <= fY.fNbins + 1; j++)
+      for (int i = 0; i <= fX.fNbins + 1; i++) {
+        double weight = inh->GetBinContent(i, j, k);
+        fInvWeights[(k * (fY.fNbins + 2) + j) * (fX.fNbins + 2) + i] = (weight != 0) ? 1. / weight : 1.;
+      }
+}
+void GFWWeights::Freeze()
+{
+  fFrozen = kFALSE; // the tables are built from the histograms
+  if (!fAccInt && fW_data && fW_data->GetEntries())
+    CreateNUA();
+  fFrozenNUA.Set(fAccInt);
+  fFrozenNUE.Set(fEffInt); // not created here, since CreateNUE() rebins the MC histograms
+  TObjArray* tars[3] = {fW_data, fW_mcrec, fW_mcgen};
+  const char* pfs[3] = {"data", "mcrec", "mcgen"};
+  for (int htype = 0; htype < 3; htype++)
+    fFrozenWeight[htype].Set(tars[htype] ? reinterpret_cast<TH3D*>(tars[htype]->FindObject(GetBinName(0, 0, pfs[htype]))) : 0);
+  fFrozen = kTRUE;
+}
+void GFWWeights::GetWeights(gsl::span<const float> phi, gsl::span<const float> eta, float vz, gsl::span<float> weights)
+{
+  if (weights.size() < phi.size() || eta.size() < phi.size()) {
+    printf("Inconsistent sizes of the input and output spans!\n");
+    return;
+  }
+  if (!fFrozen)
+    Freeze();
+  if (!fFrozenNUA.IsSet()) {
+    std::fill(weights.begin(), weights.begin() + phi.size(), 1.f);
+    return;
+  }
+  // the vz bin is common to all tracks of the event
+  const FrozenHist& nua = fFrozenNUA;
+  const float* table = nua.fInvWeights.data() + nua.fZ.FindBin(vz) * (nua.fY.fNbins + 2) * (nua.fX.fNbins + 2);
+  for (size_t i = 0; i < phi.size(); i++)
+    weights[i] = table[nua.fY.FindBin(eta[i]) * (nua.fX.fNbins + 2) + nua.fX.FindBin(phi[i])];
+}
 double GFWWeights::FindMax(TH3D* inh, int& ix, int& iy, int& iz)
 {
   double maxv = inh->GetBinContent(1, 1, 1);
@@ -19,6 +19,9 @@
 #include "TFile.h"
 #include "TCollection.h"
 #include "TString.h"
+#include <algorithm>
+#include <vector>
+#include <gsl/span>
 
 class GFWWeights : public TNamed
 {
@@ -52,18 +55,59 @@ class GFWWeights : public TNamed
   void OverwriteNUA();
   TH1D* GetdNdPhi();
   TH1D* GetEfficiency(double etamin, double etamax, double vzmin, double vzmax);
+  // Tabulates the inverse weights into flat arrays, which are then used by GetWeight, GetNUA, GetNUE and GetWeights.
+  // Has to be called again if the weights are modified afterwards
+  void Freeze();
+  bool IsFrozen() { return fFrozen; }
+  // Fetches the NUA weights for all tracks of an event at once
+  void GetWeights(gsl::span<const float> phi, gsl::span<const float> eta, float vz, gsl::span<float> weights);
 
  private:
+  struct FrozenAxis {
+    int fNbins = 0;
+    double fMin = 0;
+    double fMax = 0;
+    double fScale = 0;          // nbins / (max - min), used for uniform axes
+    std::vector<double> fEdges; // bin edges, only filled for variable axes
+    void Set(const TAxis* ax);
+    int FindBin(double x) const // same convention as TAxis::FindBin, 0 and nbins+1 are under- and overflow
+    {
+      if (!(x >= fMin))
+        return 0;
+      if (x >= fMax)
+        return fNbins + 1;
+      if (fEdges.empty())
+        return 1 + static_cast<int>((x - fMin) * fScale);
+      return std::upper_bound(fEdges.begin(), fEdges.end(), x) - fEdges.begin();
+    }
+  };
+  struct FrozenHist {
+    FrozenAxis fX;
+    FrozenAxis fY;
+    FrozenAxis fZ;
+    std::vector<float> fInvWeights; // 1/content (1 if empty) for all bins including under- and overflow
+    void Set(TH3D* inh);
+    bool IsSet() const { return !fInvWeights.empty(); }
+    float GetInvWeight(double x, double y, double z) const
+    {
+      return fInvWeights[(fZ.FindBin(z) * (fY.fNbins + 2) + fY.FindBin(y)) * (fX.fNbins + 2) + fX.FindBin(x)];
+    }
+  };
+
   bool fDataFilled;
   bool fMCFilled;
   TObjArray* fW_data;
   TObjArray* fW_mcrec;
   TObjArray* fW_mcgen;
-  TH3D* fEffInt;   //!
-  TH1D* fIntEff;   //!
-  TH3D* fAccInt;   //!
-  int fNbinsPt;    //! do not store
-  double* fbinsPt; //! do not store
+  TH3D* fEffInt;               //!
+  TH1D* fIntEff;               //!
+  TH3D* fAccInt;               //!
+  int fNbinsPt;                //! do not store
+  double* fbinsPt;             //! do not store
+  bool fFrozen;                //!
+  FrozenHist fFrozenNUA;       //! tabulated fAccInt
+  FrozenHist fFrozenNUE;       //! tabulated fEffInt
+  FrozenHist fFrozenWeight[3]; //! tabulated weights for data, mc rec and mc gen
   void AddArray(TObjArray* targ, TObjArray* sour);
   const char* GetBinName(double ptv, double v0mv, const char* pf = "")
   {
@@ -123,6 +123,7 @@ struct Qvector_Arrays {
     {TComplex(0., 0.)}}; //! generic Q-vector
   TComplex fQvector[gMaxHarmonic * gMaxCorrelator + 1][gMaxCorrelator + 1] = {
     {TComplex(0., 0.)}}; //! "integrated" Q-vector
+  QVectorAccumulator fQvectorAcc; //! block-wise filling of fQvector, see FlushQvector()
 } qv_a;
 
 // *) Multiparticle correlations (standard, isotropic, same harmonic):
@@ -72,6 +72,7 @@
 // TComplex Four(Int_t n1, Int_t n2, Int_t n3, Int_t n4)
 // ... TBI 20220809 port the rest ...
 // void ResetQ(); // reset the components of generic Q-vectors
+// void FlushQvector(); // add the buffered particles to the integrated Q-vector
 
 // *) Particle weights:
 // void SetWeightsHist(TH1D* const hist, const char *variable)
@@ -638,7 +639,7 @@ void BookQvectorHistograms()
   // Book all Q-vector histograms.
 
   // a) Book the profile holding flags;
-  // b) ...
+  // b) Initialize the accumulator used to fill the Q-vectors.
 
   if (fVerbose) {
     LOGF(info, "\033[1;32m%s\033[0m", __PRETTY_FUNCTION__);
@@ -659,7 +660,8 @@ void BookQvectorHistograms()
   fQvectorFlagsPro->Fill(2.5, gMaxCorrelator);
   fQvectorList->Add(fQvectorFlagsPro);
 
-  // b) ...
+  // b) Initialize the accumulator used to fill the Q-vectors:
+  qv_a.fQvectorAcc.Init(gMaxHarmonic * gMaxCorrelator + 1, gMaxCorrelator + 1);
 
 } // void BookQvectorHistograms()
 
@@ -1595,6 +1597,27 @@ void ResetQ()
 
 //============================================================
 
+void FlushQvector()
+{
+  // Add the particles buffered in qv_a.fQvectorAcc to the "integrated" Q-vector qv_a.fQvector, and reset the accumulator.
+
+  if (fVerbose) {
+    LOGF(info, "\033[1;32m%s\033[0m", __PRETTY_FUNCTION__);
+  }
+
+  qv_a.fQvectorAcc.Flush();
+  for (Int_t h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
+    for (Int_t wp = 0; wp < gMaxCorrelator + 1; wp++) // weight power
+    {
+      qv_a.fQvector[h][wp] += TComplex(qv_a.fQvectorAcc.Re(h, wp), qv_a.fQvectorAcc.Im(h, wp));
+    }
+  }
+  qv_a.fQvectorAcc.Reset();
+
+} // void FlushQvector()
+
+//============================================================
+
 void SetWeightsHist(TH1D* const hist, const char* variable)
 {
   // Copy histogram holding weights from an external file to the corresponding
@@ -2272,7 +2295,6 @@ void MainLoopOverParticlesRec(TracksRec const& tracks)
   Double_t dPhi = 0., wPhi = 1.; // azimuthal angle and corresponding phi weight
   Double_t dPt = 0., wPt = 1.;   // transverse momentum and corresponding pT weight
   Double_t dEta = 0., wEta = 1.; // pseudorapidity and corresponding eta weight
-  Double_t wToPowerP = 1.;       // weight raised to power p
   fSelectedTracks = 0;           // reset number of selected tracks
   for (auto& track : tracks) {
 
@@ -2319,14 +2341,12 @@ void MainLoopOverParticlesRec(TracksRec const& tracks)
       }
     } // if(pw_a.fUseWeights[wETA])
 
-    for (Int_t h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
-      for (Int_t wp = 0; wp < gMaxCorrelator + 1; wp++) { // weight power
-        if (pw_a.fUseWeights[wPHI] || pw_a.fUseWeights[wPT] || pw_a.fUseWeights[wETA]) {
-          wToPowerP = pow(wPhi * wPt * wEta, wp);
-        }
-        qv_a.fQvector[h][wp] += TComplex(wToPowerP * TMath::Cos(h * dPhi), wToPowerP * TMath::Sin(h * dPhi));
-      } // for(Int_t wp=0;wp<gMaxCorrelator+1;wp++)
-    }   // for(Int_t h=0;h<gMaxHarmonic*gMaxCorrelator+1;h++)
+    // *) Q-vectors (all harmonics and weight powers are calculated in blocks of particles, see FlushQvector()):
+    if (pw_a.fUseWeights[wPHI] || pw_a.fUseWeights[wPT] || pw_a.fUseWeights[wETA]) {
+      qv_a.fQvectorAcc.Add(dPhi, wPhi * wPt * wEta);
+    } else {
+      qv_a.fQvectorAcc.Add(dPhi);
+    }
 
     // *) Nested loops containers:
     if (fCalculateNestedLoops || fCalculateCustomNestedLoop) {
@@ -2346,6 +2366,9 @@ void MainLoopOverParticlesRec(TracksRec const& tracks)
 
   } // for (auto& track : tracks)
 
+  // *) Add the particles still in the buffer to the Q-vectors:
+  FlushQvector();
+
 } // void MainLoopOverParticlesRec(TracksRec const& tracks)
 
 //============================================================
@@ -2363,7 +2386,6 @@ void MainLoopOverParticlesRecSim(TracksRecSim const& tracks)
   Double_t dPhi = 0., wPhi = 1.; // azimuthal angle and corresponding phi weight
   Double_t dPt = 0., wPt = 1.;   // transverse momentum and corresponding pT weight
   Double_t dEta = 0., wEta = 1.; // pseudorapidity and corresponding eta weight
-  Double_t wToPowerP = 1.;       // weight raised to power p
   fSelectedTracks = 0;           // reset number of selected tracks
   for (auto& track : tracks) {
 
@@ -2427,14 +2449,12 @@ void MainLoopOverParticlesRecSim(TracksRecSim const& tracks)
       }
     } // if(pw_a.fUseWeights[wETA])
 
-    for (Int_t h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
-      for (Int_t wp = 0; wp < gMaxCorrelator + 1; wp++) { // weight power
-        if (pw_a.fUseWeights[wPHI] || pw_a.fUseWeights[wPT] || pw_a.fUseWeights[wETA]) {
-          wToPowerP = pow(wPhi * wPt * wEta, wp);
-        }
-        qv_a.fQvector[h][wp] += TComplex(wToPowerP * TMath::Cos(h * dPhi), wToPowerP * TMath::Sin(h * dPhi));
-      } // for(Int_t wp=0;wp<gMaxCorrelator+1;wp++)
-    }   // for(Int_t h=0;h<gMaxHarmonic*gMaxCorrelator+1;h++)
+    // *) Q-vectors (all harmonics and weight powers are calculated in blocks of particles, see FlushQvector()):
+    if (pw_a.fUseWeights[wPHI] || pw_a.fUseWeights[wPT] || pw_a.fUseWeights[wETA]) {
+      qv_a.fQvectorAcc.Add(dPhi, wPhi * wPt * wEta);
+    } else {
+      qv_a.fQvectorAcc.Add(dPhi);
+    }
 
     // *) Nested loops containers:
     if (fCalculateNestedLoops || fCalculateCustomNestedLoop) {
@@ -2454,6 +2474,9 @@ void MainLoopOverParticlesRecSim(TracksRecSim const& tracks)
 
   } // for (auto& track : tracks)
 
+  // *) Add the particles still in the buffer to the Q-vectors:
+  FlushQvector();
+
 } // void MainLoopOverParticlesRecSim(TracksRecSim const& tracks)
 
 //============================================================
@@ -15,6 +15,7 @@
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
 #include "Common/DataModel/TrackSelectionTables.h" // needed for aod::TracksDCA table
+#include "PWGCF/Core/QVectorAccumulator.h"
 using namespace o2;
 using namespace o2::framework;
 
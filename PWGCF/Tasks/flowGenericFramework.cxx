@@ -77,8 +77,16 @@ struct GenericFramework {
   // define global variables
   GFW* fGFW = new GFW();
   std::vector<GFW::CorrConfig> corrconfigs;
+  std::vector<std::vector<int>> corrHandles;                // FlowContainer handles per config, [0] for the pT-integrated and [i] for the i-th pT bin
+  std::vector<std::vector<std::pair<int, int>>> gfwHandles; // GFW handles (denominator, numerator) per config and GFW pT bin
+  std::vector<int> fEventHandles;                           // correlators of the current event, filled into the FlowContainer at once
+  std::vector<double> fEventValues;
+  std::vector<double> fEventWeights;
   TRandom3* fRndm = new TRandom3(0);
   TAxis* fPtAxis;
+  std::vector<float> fTrackPhi;
+  std::vector<float> fTrackEta;
+  std::vector<float> fTrackNUA;
 
   void init(InitContext const&)
   {
@@ -157,6 +165,7 @@ struct GenericFramework {
 
       CreateCorrConfigs();
       fGFW->CreateRegions();
+      CreateCorrHandles();
     }
   }
 
@@ -166,9 +175,10 @@ struct GenericFramework {
       return;
     if (cfgAcceptance.value.empty() == false) {
       cfg.mAcceptance = ccdb->getForTimeStamp<GFWWeights>(cfgAcceptance, timestamp);
-      if (cfg.mAcceptance)
+      if (cfg.mAcceptance) {
+        cfg.mAcceptance->Freeze();
         LOGF(info, "Loaded acceptance weights from %s (%p)", cfgAcceptance.value.c_str(), (void*)cfg.mAcceptance);
-      else
+      } else
         LOGF(warning, "Could not load acceptance weights from %s (%p)", cfgAcceptance.value.c_str(), (void*)cfg.mAcceptance);
     }
     if (cfgEfficiency.value.empty() == false) {
@@ -205,25 +215,52 @@ struct GenericFramework {
     corrconfigs.push_back(fGFW->GetCorrelatorConfig("refFull {2 2 2 2 2 -2 -2 -2 -2 -2}", "ChFull210", kFALSE));
   }
 
-  void FillFC(const GFW::CorrConfig& corrconf, const double& cent, const double& rndm)
+  void CreateCorrHandles()
+  {
+    corrHandles.clear();
+    gfwHandles.clear();
+    for (auto& corrconf : corrconfigs) {
+      std::vector<std::pair<int, int>> gfwhandles;
+      int nGFWBins = corrconf.pTDif ? fPtAxis->GetNbins() : 1;
+      for (Int_t i = 0; i < nGFWBins; i++)
+        gfwhandles.push_back(std::make_pair(fGFW->GetCorrelatorHandle(corrconf, i, kTRUE), fGFW->GetCorrelatorHandle(corrconf, i, kFALSE)));
+      gfwHandles.push_back(gfwhandles);
+
+      std::vector<int> handles;
+      handles.push_back(fFC->GetProfileHandle(corrconf.Head.c_str()));
+      if (corrconf.pTDif) {
+        for (Int_t i = 1; i <= fPtAxis->GetNbins(); i++)
+          handles.push_back(fFC->GetProfileHandle(Form("%s_pt_%i", corrconf.Head.c_str(), i)));
+      }
+      corrHandles.push_back(handles);
+    }
+  }
+
+  void FillFC(const GFW::CorrConfig& corrconf, const std::vector<int>& handles, const std::vector<std::pair<int, int>>& gfwhandles)
   {
     double dnx, val;
-    dnx = fGFW->Calculate(corrconf, 0, kTRUE).real();
+    dnx = fGFW->GetCorrelator(gfwhandles[0].first).real();
     if (dnx == 0)
       return;
     if (!corrconf.pTDif) {
-      val = fGFW->Calculate(corrconf, 0, kFALSE).real() / dnx;
-      if (TMath::Abs(val) < 1)
-        fFC->FillProfile(corrconf.Head.c_str(), cent, val, dnx, rndm);
+      val = fGFW->GetCorrelator(gfwhandles[0].second).real() / dnx;
+      if (TMath::Abs(val) < 1) {
+        fEventHandles.push_back(handles[0]);
+        fEventValues.push_back(val);
+        fEventWeights.push_back(dnx);
+      }
       return;
     }
     for (Int_t i = 1; i <= fPtAxis->GetNbins(); i++) {
-      dnx = fGFW->Calculate(corrconf, i - 1, kTRUE).real();
+      dnx = fGFW->GetCorrelator(gfwhandles[i - 1].first).real();
       if (dnx == 0)
         continue;
-      val = fGFW->Calculate(corrconf, i - 1, kFALSE).real() / dnx;
-      if (TMath::Abs(val) < 1)
-        fFC->FillProfile(Form("%s_pt_%i", corrconf.Head.c_str(), i), cent, val, dnx, rndm);
+      val = fGFW->GetCorrelator(gfwhandles[i - 1].second).real() / dnx;
+      if (TMath::Abs(val) < 1) {
+        fEventHandles.push_back(handles[i]);
+        fEventValues.push_back(val);
+        fEventWeights.push_back(dnx);
+      }
     }
     return;
   }
@@ -248,7 +285,21 @@ struct GenericFramework {
     float l_Random = fRndm->Rndm();
     float weff = 1, wacc = 1;
 
+    // fetch the acceptance weights of all tracks at once
+    if (cfg.mAcceptance) {
+      fTrackPhi.clear();
+      fTrackEta.clear();
+      for (auto& track : tracks) {
+        fTrackPhi.push_back(track.phi());
+        fTrackEta.push_back(track.eta());
+      }
+      fTrackNUA.resize(fTrackPhi.size());
+      cfg.mAcceptance->GetWeights(fTrackPhi, fTrackEta, vtxz, fTrackNUA);
+    }
+
+    int itrack = -1;
     for (auto& track : tracks) {
+      itrack++;
       registry.fill(HIST("hPhi"), track.phi());
       registry.fill(HIST("hEta"), track.eta());
 
@@ -261,7 +312,7 @@ struct GenericFramework {
         continue;
       weff = 1. / weff;
       if (cfg.mAcceptance)
-        wacc = cfg.mAcceptance->GetNUA(track.phi(), track.eta(), vtxz);
+        wacc = fTrackNUA[itrack];
       else
         wacc = 1;
       registry.fill(HIST("hPhiEtaVtxZ_corrected"), track.phi(), track.eta(), vtxz, wacc);
@@ -275,9 +326,14 @@ struct GenericFramework {
       if (WithinPtPOI && WithinPtRef)
         fGFW->Fill(track.eta(), fPtAxis->FindBin(pt) - 1, track.phi(), wacc * weff, 4);
     }
+    fEventHandles.clear();
+    fEventValues.clear();
+    fEventWeights.clear();
+    fGFW->CalculateAll();
     for (uint l_ind = 0; l_ind < corrconfigs.size(); l_ind++) {
-      FillFC(corrconfigs.at(l_ind), centrality, l_Random);
+      FillFC(corrconfigs.at(l_ind), corrHandles.at(l_ind), gfwHandles.at(l_ind));
     }
+    fFC->FillProfiles(fEventHandles.size(), fEventHandles.data(), centrality, fEventValues.data(), fEventWeights.data(), l_Random);
   }
   PROCESS_SWITCH(GenericFramework, processData, "Process analysis for data", true);
 
@@ -0,0 +1,346 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "PWGDQ/Core/AnalysisCutCompiler.h"
+
+#include <algorithm>
+#include "Framework/Logger.h"
+
+//____________________________________________________________________________
+AnalysisCutCompiler::AnalysisCutCompiler() : fNCuts(0),
+                                             fNGridPoints(1000),
+                                             fMaxStackDepth(0),
+                                             fCurrentDepth(0),
+                                             fProgram(),
+                                             fTests(),
+                                             fFuncs(),
+                                             fTableValues(),
+                                             fUsedVars(),
+                                             fColumns(),
+                                             fColumnPointers(),
+                                             fNObjects(0),
+                                             fStack(),
+                                             fCutWords()
+{
+  //
+  // default constructor
+  //
+}
+
+//____________________________________________________________________________
+void AnalysisCutCompiler::Clear()
+{
+  //
+  // remove all the compiled cuts
+  //
+  fNCuts = 0;
+  fMaxStackDepth = 0;
+  fCurrentDepth = 0;
+  fProgram.clear();
+  fTests.clear();
+  fFuncs.clear();
+  fTableValues.clear();
+  fUsedVars.clear();
+  fColumns.clear();
+  fColumnPointers.clear();
+  fNObjects = 0;
+  fStack.clear();
+  fCutWords.clear();
+}
+
+//____________________________________________________________________________
+int AnalysisCutCompiler::AddCut(const AnalysisCut* cut)
+{
+  //
+  // compile a cut and assign it the next bit in the decision mask
+  //
+  if (fNCuts >= kMaxNCuts) {
+    LOG(fatal) << "AnalysisCutCompiler: at most " << kMaxNCuts << " cuts can be compiled";
+  }
+  if (cut->IsA() == AnalysisCompositeCut::Class()) {
+    CompileCompositeCut(*static_cast<const AnalysisCompositeCut*>(cut));
+  } else {
+    CompileCut(*cut);
+  }
+  Emit(kStore, fNCuts);
+  fCutWords.resize(fNCuts + 1);
+  return fNCuts++;
+}
+
+//____________________________________________________________________________
+void AnalysisCutCompiler::Emit(OpCode op, int arg)
+{
+  //
+  // append an instruction and keep track of the stack depth needed to run the program
+  //
+  fProgram.push_back({op, arg});
+  switch (op) {
+    case kTest:
+    case kTrue:
+    case kFalse:
+      fCurrentDepth++;
+      break;
+    case kAnd:
+    case kOr:
+      fCurrentDepth -= arg - 1;
+      break;
+    case kStore:
+      fCurrentDepth--;
+      break;
+  }
+  fMaxStackDepth = std::max(fMaxStackDepth, fCurrentDepth);
+  fStack.resize(fMaxStackDepth);
+}
+
+//____________________________________________________________________________
+void AnalysisCutCompiler::CompileCut(const AnalysisCut& cut)
+{
+  //
+  // a plain cut is the AND of its range tests
+  //
+  const auto& cuts = cut.GetCuts();
+  if (cuts.empty()) {
+    Emit(kTrue);
+    return;
+  }
+  for (const auto& cont : cuts) {
+    RangeTest test;
+    test.fVar = cont.fVar;
+    test.fLow = cont.fLow;
+    test.fHigh = cont.fHigh;
+    test.fExclude = cont.fExclude;
+    test.fDepVar = cont.fDepVar;
+    test.fDepLow = cont.fDepLow;
+    test.fDepHigh = cont.fDepHigh;
+    test.fDepExclude = cont.fDepExclude;
+    test.fDepVar2 = cont.fDepVar2;
+    test.fDep2Low = cont.fDep2Low;
+    test.fDep2High = cont.fDep2High;
+    test.fDep2Exclude = cont.fDep2Exclude;
+    test.fFuncLow = (cont.fFuncLow ? AddFunction(cont.fFuncLow, cont) : -1);
+    test.fFuncHigh = (cont.fFuncHigh ? AddFunction(cont.fFuncHigh, cont) : -1);
+    AddUsedVar(test.fVar);
+    AddUsedVar(test.fDepVar);
+    AddUsedVar(test.fDepVar2);
+    fTests.push_back(test);
+    Emit(kTest, fTests.size() - 1);
+  }
+  if (cuts.size() > 1) {
+    Emit(kAnd, cuts.size());
+  }
+}
+
+//____________________________________________________________________________
+void AnalysisCutCompiler::CompileCompositeCut(const AnalysisCompositeCut& cut)
+{
+  //
+  // a composite cut is the AND (OR) of its plain cuts followed by its composite cuts
+  //
+  int nOperands = cut.GetNCuts();
+  if (nOperands == 0) {
+    Emit(cut.GetUseAND() ? kTrue : kFalse);
+    return;
+  }
+  for (const auto& subCut : cut.GetCutList()) {
+    CompileCut(subCut);
+  }
+  for (const auto& subCut : cut.GetCompositeCutList()) {
+    CompileCompositeCut(subCut);
+  }
+  if (nOperands > 1) {
+    Emit(cut.GetUseAND() ? kAnd : kOr, nOperands);
+  }
+}
+
+//____________________________________________________________________________
+int AnalysisCutCompiler::AddFunction(TF1* func, const AnalysisCut::CutContainer& cont)
+{
+  //
+  // tabulate a function bound on a grid of the dependent variable
+  // If the cut is applied only inside the dependent variable range, the grid spans that range,
+  //   otherwise it spans the range of definition of the function
+  //
+  FuncTable table;
+  table.fFunc = func;
+  table.fOffset = fTableValues.size();
+  table.fNPoints = (fNGridPoints > 1 ? fNGridPoints : 0);
+  double xmin = (cont.fDepExclude ? func->GetXmin() : cont.fDepLow);
+  double xmax = (cont.fDepExclude ? func->GetXmax() : cont.fDepHigh);
+  if (!(xmax > xmin)) {
+    table.fNPoints = 0;
+  }
+  table.fXmin = xmin;
+  table.fInvStep = 0.0;
+  if (table.fNPoints > 0) {
+    double step = (xmax - xmin) / (table.fNPoints - 1);
+    table.fInvStep = 1.0 / step;
+    for (int i = 0; i < table.fNPoints; i++) {
+      fTableValues.push_back(func->Eval(xmin + i * step));
+    }
+  }
+  fFuncs.push_back(table);
+  return fFuncs.size() - 1;
+}
+
+//____________________________________________________________________________
+void AnalysisCutCompiler::AddUsedVar(int var)
+{
+  if (var < 0 || std::find(fUsedVars.begin(), fUsedVars.end(), var) != fUsedVars.end()) {
+    return;
+  }
+  fUsedVars.push_back(var);
+  if (var >= static_cast<int>(fColumns.size())) {
+    fColumns.resize(var + 1);
+    fColumnPointers.resize(var + 1, nullptr);
+  }
+}
+
+//____________________________________________________________________________
+void AnalysisCutCompiler::AddObject(const float* values)
+{
+  //
+  // copy the used variables of one object into the internal column store
+  //
+  for (int var : fUsedVars) {
+    auto& column = fColumns[var];
+    if (static_cast<int>(column.size()) <= fNObjects) {
+      column.resize(std::max<size_t>(2 * column.size(), fNObjects + 64));
+    }
+    column[fNObjects] = values[var];
+  }
+  fNObjects++;
+}
+
+//____________________________________________________________________________
+void AnalysisCutCompiler::Evaluate(uint64_t* decisions)
+{
+  //
+  // evaluate the compiled cuts for all the objects in the internal column store
+  //
+  for (int var : fUsedVars) {
+    fColumnPointers[var] = fColumns[var].data();
+  }
+  Evaluate(fColumnPointers.data(), fNObjects, decisions);
+}
+
+//____________________________________________________________________________
+inline float AnalysisCutCompiler::EvalBound(int func, float x) const
+{
+  const FuncTable& table = fFuncs[func];
+  float t = (x - table.fXmin) * table.fInvStep;
+  if (!(t >= 0.0f) || t > static_cast<float>(table.fNPoints - 1) || table.fNPoints == 0) {
+    return table.fFunc->Eval(x);
+  }
+  int i = std::min(static_cast<int>(t), table.fNPoints - 2);
+  const float* grid = fTableValues.data() + table.fOffset + i;
+  return grid[0] + (t - i) * (grid[1] - grid[0]);
+}
+
+//____________________________________________________________________________
+uint64_t AnalysisCutCompiler::EvalTest(const RangeTest& test, const float* const* columns, int first, int n) const
+{
+  //
+  // evaluate one range test for n (<= 64) objects starting at first; bit j is set if object first+j passes
+  // The semantics are the same as in AnalysisCut::IsSelected()
+  //
+  const float* x = columns[test.fVar] + first;
+  const float* dep = (test.fDepVar != -1 ? columns[test.fDepVar] + first : nullptr);
+  const float* dep2 = (test.fDepVar2 != -1 ? columns[test.fDepVar2] + first : nullptr);
+  bool decisions[64];
+
+  if (!dep && test.fFuncLow < 0 && test.fFuncHigh < 0) {
+    // most common case: plain range on a single variable
+    for (int j = 0; j < n; j++) {
+      bool inRange = (x[j] >= test.fLow && x[j] <= test.fHigh);
+      decisions[j] = (inRange != test.fExclude);
+    }
+  } else {
+    for (int j = 0; j < n; j++) {
+      bool applies = true;
+      if (dep) {
+        bool inRange = (dep[j] > test.fDepLow && dep[j] <= test.fDepHigh);
+        applies = (inRange != test.fDepExclude);
+      }
+      if (dep2) {
+        bool inRange = (dep2[j] > test.fDep2Low && dep2[j] <= test.fDep2High);
+        applies = applies && (inRange != test.fDep2Exclude);
+      }
+      if (!applies) {
+        decisions[j] = true;
+        continue;
+      }
+      float cutLow = (test.fFuncLow < 0 ? test.fLow : EvalBound(test.fFuncLow, dep[j]));
+      float cutHigh = (test.fFuncHigh < 0 ? test.fHigh : EvalBound(test.fFuncHigh, dep[j]));
+      bool inRange = (x[j] >= cutLow && x[j] <= cutHigh);
+      decisions[j] = (inRange != test.fExclude);
+    }
+  }
+
+  uint64_t word = 0;
+  for (int j = 0; j < n; j++) {
+    word |= (static_cast<uint64_t>(decisions[j]) << j);
+  }
+  return word;
+}
+
+//____________________________________________________________________________
+void AnalysisCutCompiler::Evaluate(const float* const* columns, int nObjects, uint64_t* decisions)
+{
+  //
+  // run the program on blocks of 64 objects; every stack entry holds the decisions for the whole block
+  //
+  for (int first = 0; first < nObjects; first += 64) {
+    int n = std::min(64, nObjects - first);
+    uint64_t allPass = (n == 64 ? ~uint64_t(0) : ((uint64_t(1) << n) - 1));
+    int top = 0;
+    for (const auto& instr : fProgram) {
+      switch (instr.fOp) {
+        case kTest:
+          fStack[top++] = EvalTest(fTests[instr.fArg], columns, first, n);
+          break;
+        case kTrue:
+          fStack[top++] = allPass;
+          break;
+        case kFalse:
+          fStack[top++] = 0;
+          break;
+        case kAnd: {
+          uint64_t word = allPass;
+          for (int i = 0; i < instr.fArg; i++) {
+            word &= fStack[--top];
+          }
+          fStack[top++] = word;
+          break;
+        }
+        case kOr: {
+          uint64_t word = 0;
+          for (int i = 0; i < instr.fArg; i++) {
+            word |= fStack[--top];
+          }
+          fStack[top++] = word;
+          break;
+        }
+        case kStore:
+          fCutWords[instr.fArg] = fStack[--top];
+          break;
+      }
+    }
+
+    // transpose the per cut words into per object masks
+    for (int j = 0; j < n; j++) {
+      uint64_t mask = 0;
+      for (int icut = 0; icut < fNCuts; icut++) {
+        mask |= ((fCutWords[icut] >> j) & uint64_t(1)) << icut;
+      }
+      decisions[first + j] = mask;
+    }
+  }
+}
@@ -0,0 +1,127 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//
+// Contact: iarsene@cern.ch, i.c.arsene@fys.uio.no
+//
+// Class which lowers a set of AnalysisCut / AnalysisCompositeCut trees into a flat program of
+// range tests and evaluates all of them at once for a block of objects.
+// The values are provided as structure-of-arrays (one column per VarManager variable), and the result
+// is a 64 bit mask per object, with bit i set if the object passed the i-th added cut.
+// Bounds given as TF1 are tabulated on a grid of the dependent variable at compile time
+//   and linearly interpolated (values outside the grid are evaluated with the TF1 directly).
+//
+
+#ifndef AnalysisCutCompiler_H
+#define AnalysisCutCompiler_H
+
+#include "PWGDQ/Core/AnalysisCut.h"
+#include "PWGDQ/Core/AnalysisCompositeCut.h"
+
+#include <TF1.h>
+#include <cstdint>
+#include <vector>
+
+//_________________________________________________________________________
+class AnalysisCutCompiler
+{
+ public:
+  static constexpr int kMaxNCuts = 64;
+
+  AnalysisCutCompiler();
+  ~AnalysisCutCompiler() = default;
+
+  // Number of grid points used to tabulate TF1 bounds. If 0, the functions are evaluated exactly.
+  // NOTE: Must be set before adding cuts
+  void SetNGridPoints(int nPoints) { fNGridPoints = nPoints; }
+
+  // Compile a cut (plain or composite) and return the bit assigned to it in the output masks
+  int AddCut(const AnalysisCut* cut);
+  void Clear();
+
+  int GetNCuts() const { return fNCuts; }
+  const std::vector<int>& GetUsedVars() const { return fUsedVars; }
+
+  // block interface on the internal column store, filled from the VarManager values array
+  void ClearObjects() { fNObjects = 0; }
+  void AddObject(const float* values);
+  int GetNObjects() const { return fNObjects; }
+  void Evaluate(uint64_t* decisions);
+
+  // block interface on external columns: columns[var] must point to nObjects values for every used variable
+  void Evaluate(const float* const* columns, int nObjects, uint64_t* decisions);
+
+ private:
+  enum OpCode {
+    kTest = 0, // push the result of the range test fArg
+    kAnd,      // pop fArg words and push their AND
+    kOr,       // pop fArg words and push their OR
+    kTrue,     // push an all-pass word
+    kFalse,    // push an all-fail word
+    kStore     // pop a word and store it as the decision of cut fArg
+  };
+
+  struct Instruction {
+    OpCode fOp;
+    int fArg;
+  };
+
+  struct RangeTest {
+    int fVar;
+    float fLow;
+    float fHigh;
+    bool fExclude;
+    int fDepVar;
+    float fDepLow;
+    float fDepHigh;
+    bool fDepExclude;
+    int fDepVar2;
+    float fDep2Low;
+    float fDep2High;
+    bool fDep2Exclude;
+    int fFuncLow;  // index of the tabulated lower bound, -1 if constant
+    int fFuncHigh; // index of the tabulated upper bound, -1 if constant
+  };
+
+  struct FuncTable {
+    TF1* fFunc;     // function, used outside of the grid
+    float fXmin;    // first grid point
+    float fInvStep; // inverse of the grid spacing
+    int fNPoints;   // number of grid points (0: always evaluate the function)
+    int fOffset;    // position of the first grid value in fTableValues
+  };
+
+  void CompileCut(const AnalysisCut& cut);
+  void CompileCompositeCut(const AnalysisCompositeCut& cut);
+  void Emit(OpCode op, int arg = 0);
+  int AddFunction(TF1* func, const AnalysisCut::CutContainer& cont);
+  void AddUsedVar(int var);
+  float EvalBound(int func, float x) const;
+  uint64_t EvalTest(const RangeTest& test, const float* const* columns, int first, int n) const;
+
+  int fNCuts;         // number of compiled cuts
+  int fNGridPoints;   // number of grid points used to tabulate TF1 bounds
+  int fMaxStackDepth; // maximum stack depth reached by the program
+  int fCurrentDepth;  // stack depth while compiling
+
+  std::vector<Instruction> fProgram; // flat program for all the cuts
+  std::vector<RangeTest> fTests;     // range tests referenced by the program
+  std::vector<FuncTable> fFuncs;     // tabulated bounds
+  std::vector<float> fTableValues;   // grid values of all the tabulated bounds
+
+  std::vector<int> fUsedVars;                // variables needed by the compiled cuts
+  std::vector<std::vector<float>> fColumns;  // internal column store, indexed by variable
+  std::vector<const float*> fColumnPointers; // column pointers, indexed by variable
+  int fNObjects;                             // number of objects in the internal store
+  std::vector<uint64_t> fStack;              // evaluation stack, one word (64 objects) per entry
+  std::vector<uint64_t> fCutWords;           // per cut decision word for the current block
+};
+
+#endif
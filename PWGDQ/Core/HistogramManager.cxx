@@ -39,6 +39,12 @@ HistogramManager::HistogramManager() : TNamed("", ""),
                                        fNVars(0),
                                        fUsedVars(nullptr),
                                        fVariablesMap(),
+                                       fHandles(),
+                                       fHandleClasses(),
+                                       fHandleFirstFill(),
+                                       fFillPlans(),
+                                       fFillVars(),
+                                       fFillPlansUpToDate(false),
                                        fUseDefaultVariableNames(false),
                                        fBinsAllocated(0),
                                        fVariableNames(nullptr),
@@ -55,6 +61,12 @@ HistogramManager::HistogramManager(const char* name, const char* title, const in
                                                                                               fNVars(maxNVars),
                                                                                               fUsedVars(),
                                                                                               fVariablesMap(),
+                                                                                              fHandles(),
+                                                                                              fHandleClasses(),
+                                                                                              fHandleFirstFill(),
+                                                                                              fFillPlans(),
+                                                                                              fFillVars(),
+                                                                                              fFillPlansUpToDate(false),
                                                                                               fUseDefaultVariableNames(kFALSE),
                                                                                               fBinsAllocated(0),
                                                                                               fVariableNames(),
@@ -110,6 +122,7 @@ void HistogramManager::AddHistClass(const char* histClass)
   fMainList->Add(hList);
   std::list<std::vector<int>> varList;
   fVariablesMap[histClass] = varList;
+  fFillPlansUpToDate = false;
   cout << "Adding histogram class " << histClass << endl;
   cout << "Variable map size :: " << fVariablesMap.size() << endl;
 }
@@ -184,6 +197,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   cout << "Adding histogram " << hname << endl;
   cout << "size of array :: " << varList.size() << endl;
   fVariablesMap[histClass] = varList;
+  fFillPlansUpToDate = false;
 
   // create and configure histograms according to required options
   TH1* h = nullptr;
@@ -383,6 +397,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   cout << "Adding histogram " << hname << endl;
   cout << "size of array :: " << varList.size() << endl;
   fVariablesMap[histClass] = varList;
+  fFillPlansUpToDate = false;
 
   TH1* h = nullptr;
   switch (dimension) {
@@ -551,6 +566,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   cout << "Adding histogram " << hname << endl;
   cout << "size of array :: " << varList.size() << endl;
   fVariablesMap[histClass] = varList;
+  fFillPlansUpToDate = false;
 
   uint32_t nbins = 1;
   THnBase* h = nullptr;
@@ -630,6 +646,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   cout << "Adding histogram " << hname << endl;
   cout << "size of array :: " << varList.size() << endl;
   fVariablesMap[histClass] = varList;
+  fFillPlansUpToDate = false;
 
   // get the min and max for each axis
   auto* xmin = new double[nDimensions];
@@ -684,125 +701,163 @@ void HistogramManager::FillHistClass(const char* className, Float_t* values)
 {
   //
   //  fill a class of histograms
+  //  NOTE: wrapper around the compiled fill; in loops, use the handle returned by GetHistClassHandle()
   //
-
-  // get the needed histogram list
-  auto* hList = reinterpret_cast<TList*>(fMainList->FindObject(className));
-  if (!hList) {
+  int handle = GetHistClassHandle(className);
+  if (handle == kNothing) {
     // TODO: add some meaningfull error message
     /*LOG(warn) << "HistogramManager::FillHistClass(): Histogram list " << className << " not found!";
     LOG(warn) << "         Histogram list not filled" << endl; */
     return;
   }
+  FillHistClass(handle, values);
+}
 
-  // get the corresponding std::list containng identifiers to the needed variables to be filled
-  list varList = fVariablesMap[className];
+//__________________________________________________________________
+int HistogramManager::GetHistClassHandle(const char* className)
+{
+  //
+  //  get the handle of a histogram class, registering it if needed
+  //
+  auto it = fHandles.find(className);
+  if (it != fHandles.end()) {
+    return it->second;
+  }
+  if (!fMainList->FindObject(className)) {
+    return kNothing;
+  }
+  int handle = fHandleClasses.size();
+  fHandles[className] = handle;
+  fHandleClasses.push_back(className);
+  fFillPlansUpToDate = false;
+  return handle;
+}
 
-  TIter next(hList);
+//__________________________________________________________________
+void HistogramManager::CompileFillPlans()
+{
+  //
+  //  resolve, for all registered handles, the histograms and variables to be filled
+  //
+  fFillPlans.clear();
+  fFillVars.clear();
+  fHandleFirstFill.assign(1, 0);
+  for (const auto& className : fHandleClasses) {
+    auto* hList = reinterpret_cast<TList*>(fMainList->FindObject(className.c_str()));
+    const auto& varList = fVariablesMap[className];
+    TIter next(hList);
+    // NOTE: the histogram list and the variable list contain the same number of elements and are synchronized
+    for (auto varIter = varList.begin(); varIter != varList.end(); varIter++) {
+      FillDescriptor fill;
+      fill.fHist = next();
+      bool isProfile = (varIter->at(0) == 1 ? true : false);
+      fill.fNDim = varIter->at(1);
+      fill.fVarW = varIter->at(2);
+      fill.fVarsOffset = fFillVars.size();
+      if (fill.fNDim > 0) {
+        fill.fKind = kFillTHn;
+        for (int i = 0; i < fill.fNDim; i++) {
+          fFillVars.push_back(varIter->at(3 + i));
+        }
+        for (int i = 0; i < 4; i++) {
+          fill.fVars[i] = kNothing;
+        }
+      } else {
+        int dimension = (reinterpret_cast<TH1*>(fill.fHist))->GetDimension();
+        fill.fKind = (isProfile ? kFillProfile : kFillTH1) + dimension - 1;
+        for (int i = 0; i < 4; i++) {
+          fill.fVars[i] = varIter->at(3 + i);
+        }
+      }
+      fFillPlans.push_back(fill);
+    }
+    fHandleFirstFill.push_back(fFillPlans.size());
+  }
+  fFillPlansUpToDate = true;
+}
+
+//__________________________________________________________________
+void HistogramManager::FillHistClass(int handle, Float_t* values)
+{
+  //
+  //  fill a class of histograms using its compiled fill plan
+  //
+  if (!fFillPlansUpToDate) {
+    CompileFillPlans();
+  }
+  if (handle < 0 || handle + 1 >= static_cast<int>(fHandleFirstFill.size())) {
+    return;
+  }
 
-  TObject* h = nullptr;
-  bool isProfile;
-  bool isTHn;
-  int dimension = 0;
-  bool isSparse = kFALSE;
   // TODO: At the moment, maximum 20 dimensions are foreseen for the THn histograms. We should make this more dynamic
   //       But maybe its better to have it like to avoid dynamically allocating this array in the histogram loop
   double fillValues[20] = {0.0};
-  int varX = -1, varY = -1, varZ = -1, varT = -1, varW = -1;
-
-  // loop over the histogram and std::list
-  // NOTE: these two should contain the same number of elements and be synchronized, otherwise its a mess
-  for (auto varIter = varList.begin(); varIter != varList.end(); varIter++) {
-    h = next(); // get the histogram
-    // decode information from the vector of indices
-    isProfile = (varIter->at(0) == 1 ? true : false);
-    isTHn = (varIter->at(1) > 0 ? true : false);
-    if (isTHn) {
-      dimension = varIter->at(1);
-    } else {
-      dimension = (reinterpret_cast<TH1*>(h))->GetDimension();
-    }
 
-    // get the various variable indices
-    varW = varIter->at(2);
-    if (isTHn) {
-      for (int i = 0; i < dimension; i++) {
-        fillValues[i] = values[varIter->at(3 + i)];
-      }
-    } else {
-      varX = varIter->at(3);
-      varY = varIter->at(4);
-      varZ = varIter->at(5);
-      varT = varIter->at(6);
-    }
-
-    if (!isTHn) {
-      switch (dimension) {
-        case 1:
-          if (isProfile) {
-            if (varW > kNothing) {
-              (reinterpret_cast<TProfile*>(h))->Fill(values[varX], values[varY], values[varW]);
-            } else {
-              (reinterpret_cast<TProfile*>(h))->Fill(values[varX], values[varY]);
-            }
-          } else {
-            if (varW > kNothing) {
-              (reinterpret_cast<TH1F*>(h))->Fill(values[varX], values[varW]);
-            } else {
-              (reinterpret_cast<TH1F*>(h))->Fill(values[varX]);
-            }
-          }
-          break;
-        case 2:
-          if (isProfile) {
-            if (varW > kNothing) {
-              (reinterpret_cast<TProfile2D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varW]);
-            } else {
-              (reinterpret_cast<TProfile2D*>(h))->Fill(values[varX], values[varY], values[varZ]);
-            }
-          } else {
-            if (varW > kNothing) {
-              (reinterpret_cast<TH2F*>(h))->Fill(values[varX], values[varY], values[varW]);
-            } else {
-              (reinterpret_cast<TH2F*>(h))->Fill(values[varX], values[varY]);
-            }
-          }
-          break;
-        case 3:
-          if (isProfile) {
-            if (varW > kNothing) {
-              (reinterpret_cast<TProfile3D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varT], values[varW]);
-            } else {
-              (reinterpret_cast<TProfile3D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varT]);
-            }
-          } else {
-            if (varW > kNothing) {
-              (reinterpret_cast<TH3F*>(h))->Fill(values[varX], values[varY], values[varZ], values[varW]);
-            } else {
-              (reinterpret_cast<TH3F*>(h))->Fill(values[varX], values[varY], values[varZ]);
-            }
-          }
-          break;
-
-        default:
-          break;
-      } // end switch
-      // end if(!isTHn)
-    } else {
-      if (varW > kNothing) {
-        if (isSparse) {
-          (reinterpret_cast<THnSparseF*>(h))->Fill(fillValues, values[varW]);
+  const FillDescriptor* fill = fFillPlans.data() + fHandleFirstFill[handle];
+  const FillDescriptor* last = fFillPlans.data() + fHandleFirstFill[handle + 1];
+  for (; fill != last; fill++) {
+    const int varX = fill->fVars[0], varY = fill->fVars[1], varZ = fill->fVars[2], varT = fill->fVars[3];
+    const bool hasWeight = (fill->fVarW > kNothing);
+    const float weight = hasWeight ? values[fill->fVarW] : 1.0;
+    switch (fill->fKind) {
+      case kFillTH1:
+        if (hasWeight) {
+          (reinterpret_cast<TH1F*>(fill->fHist))->Fill(values[varX], weight);
         } else {
-          (reinterpret_cast<THnF*>(h))->Fill(fillValues, values[varW]);
+          (reinterpret_cast<TH1F*>(fill->fHist))->Fill(values[varX]);
         }
-      } else {
-        if (isSparse) {
-          (reinterpret_cast<THnSparseF*>(h))->Fill(fillValues);
+        break;
+      case kFillTH2:
+        if (hasWeight) {
+          (reinterpret_cast<TH2F*>(fill->fHist))->Fill(values[varX], values[varY], weight);
+        } else {
+          (reinterpret_cast<TH2F*>(fill->fHist))->Fill(values[varX], values[varY]);
+        }
+        break;
+      case kFillTH3:
+        if (hasWeight) {
+          (reinterpret_cast<TH3F*>(fill->fHist))->Fill(values[varX], values[varY], values[varZ], weight);
+        } else {
+          (reinterpret_cast<TH3F*>(fill->fHist))->Fill(values[varX], values[varY], values[varZ]);
+        }
+        break;
+      case kFillProfile:
+        if (hasWeight) {
+          (reinterpret_cast<TProfile*>(fill->fHist))->Fill(values[varX], values[varY], weight);
+        } else {
+          (reinterpret_cast<TProfile*>(fill->fHist))->Fill(values[varX], values[varY]);
+        }
+        break;
+      case kFillProfile2D:
+        if (hasWeight) {
+          (reinterpret_cast<TProfile2D*>(fill->fHist))->Fill(values[varX], values[varY], values[varZ], weight);
+        } else {
+          (reinterpret_cast<TProfile2D*>(fill->fHist))->Fill(values[varX], values[varY], values[varZ]);
+        }
+        break;
+      case kFillProfile3D:
+        if (hasWeight) {
+          (reinterpret_cast<TProfile3D*>(fill->fHist))->Fill(values[varX], values[varY], values[varZ], values[varT], weight);
+        } else {
+          (reinterpret_cast<TProfile3D*>(fill->fHist))->Fill(values[varX], values[varY], values[varZ], values[varT]);
+        }
+        break;
+      case kFillTHn: {
+        const int* vars = fFillVars.data() + fill->fVarsOffset;
+        for (int i = 0; i < fill->fNDim; i++) {
+          fillValues[i] = values[vars[i]];
+        }
+        // THnBase::Fill() dispatches to the THnF or THnSparseF storage
+        if (hasWeight) {
+          (reinterpret_cast<THnBase*>(fill->fHist))->Fill(fillValues, weight);
         } else {
-          (reinterpret_cast<THnF*>(h))->Fill(fillValues);
+          (reinterpret_cast<THnBase*>(fill->fHist))->Fill(fillValues);
         }
+        break;
       }
-    } // end else
+      default:
+        break;
+    } // end switch
   }   // end loop over histograms
 }
 
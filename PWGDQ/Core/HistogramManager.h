@@ -24,6 +24,7 @@
 #include <TAxis.h>
 #include <TArrayD.h>
 
+#include <functional>
 #include <string>
 #include <map>
 #include <vector>
@@ -85,6 +86,11 @@ class HistogramManager : public TNamed
                     TString* axLabels = nullptr, int varW = -1, bool useSparse = kFALSE);
 
   void FillHistClass(const char* className, float* values);
+  // Get an integer handle for the histogram class <className>, to be used with the compiled FillHistClass(int, float*)
+  // The handle should be retrieved once (e.g. at init) and kept, kNothing is returned if the class does not exist
+  int GetHistClassHandle(const char* className);
+  // Fill a class of histograms using its pre-resolved fill plan (no string lookups or copies)
+  void FillHistClass(int handle, float* values);
 
   void SetUseDefaultVariableNames(bool flag) { fUseDefaultVariableNames = flag; };
   void SetDefaultVarNames(TString* vars, TString* units);
@@ -102,6 +108,33 @@ class HistogramManager : public TNamed
   bool* fUsedVars;                                                  //! flags of used variables
   std::map<std::string, std::list<std::vector<int>>> fVariablesMap; //!  map holding identifiers for all variables needed by histograms
 
+  // compiled fill plans, one contiguous range of fill descriptors per histogram class handle
+  enum FillKind {
+    kFillTH1 = 0,
+    kFillTH2,
+    kFillTH3,
+    kFillProfile,
+    kFillProfile2D,
+    kFillProfile3D,
+    kFillTHn
+  };
+  struct FillDescriptor {
+    TObject* fHist;  // histogram to be filled
+    int fKind;       // type of fill, one of FillKind
+    int fVarW;       // variable used as weight (kNothing if none)
+    int fVars[4];    // x, y, z, t variables for TH1/TH2/TH3/profiles
+    int fNDim;       // number of dimensions for THn histograms
+    int fVarsOffset; // offset of the THn variables in fFillVars
+  };
+  std::map<std::string, int, std::less<>> fHandles; //! handle of each histogram class registered with GetHistClassHandle(), found by const char* without copies
+  std::vector<std::string> fHandleClasses;          //! histogram class name of each handle
+  std::vector<int> fHandleFirstFill;                //! first fill descriptor of each handle, with one extra element at the end
+  std::vector<FillDescriptor> fFillPlans;           //! flat array of fill descriptors of all handles
+  std::vector<int> fFillVars;                       //! flat array of THn variable indices
+  bool fFillPlansUpToDate;                          //! false if histograms were added after the fill plans were compiled
+
+  void CompileFillPlans();
+
   // various
   bool fUseDefaultVariableNames;    //! toggle the usage of default variable names and units
   unsigned long int fBinsAllocated; //! number of allocated bins
@@ -20,19 +20,14 @@ ClassImp(VarManager);
 
 TString VarManager::fgVariableNames[VarManager::kNVars] = {""};
 TString VarManager::fgVariableUnits[VarManager::kNVars] = {""};
-bool VarManager::fgUsedVars[VarManager::kNVars] = {false};
-bool VarManager::fgUsedKF = false;
-float VarManager::fgMagField = 0.5;
-float VarManager::fgValues[VarManager::kNVars] = {0.0f};
+VarManager::VarContext VarManager::fgDefaultContext;
+bool* VarManager::fgUsedVars = VarManager::fgDefaultContext.fUsedVars;
+float* VarManager::fgValues = VarManager::fgDefaultContext.fValues;
 std::map<int, int> VarManager::fgRunMap;
 TString VarManager::fgRunStr = "";
 std::vector<int> VarManager::fgRunList = {0};
 float VarManager::fgCenterOfMassEnergy = 13600;         // GeV
 float VarManager::fgMassofCollidingParticle = 9.382720; // GeV
-o2::vertexing::DCAFitterN<2> VarManager::fgFitterTwoProngBarrel;
-o2::vertexing::DCAFitterN<3> VarManager::fgFitterThreeProngBarrel;
-o2::vertexing::FwdDCAFitterN<2> VarManager::fgFitterTwoProngFwd;
-o2::vertexing::FwdDCAFitterN<3> VarManager::fgFitterThreeProngFwd;
 std::map<VarManager::CalibObjects, TObject*> VarManager::fgCalibs;
 bool VarManager::fgRunTPCPostCalibration[4] = {false, false, false, false};
 
@@ -81,6 +76,37 @@ void VarManager::SetVariableDependencies()
   }
 }
 
+//__________________________________________________________________
+void VarManager::UpdateUsedVarGroups(VarContext* ctx)
+{
+  //
+  // Set the groups of variables which need to be computed, based on the used variables
+  //
+  if (!ctx) {
+    ctx = &fgDefaultContext;
+  }
+  const bool* used = ctx->fUsedVars;
+  uint32_t groups = 0;
+  if (used[kIsITSrefit] || used[kTrackTimeResIsRange] || used[kIsTPCrefit] || used[kPVContributor] || used[kIsGoldenChi2] || used[kOrphanTrack] ||
+      used[kIsSPDfirst] || used[kIsSPDboth] || used[kIsSPDany] || used[kITSClusterMap] || used[kIsITSibFirst] || used[kIsITSibAny] || used[kIsITSibAll]) {
+    groups |= kVarGroupTrackFlags;
+  }
+  if (used[kTPCnSigmaEl_Corr] || used[kTPCnSigmaPi_Corr] || used[kTPCnSigmaKa_Corr] || used[kTPCnSigmaPr_Corr] ||
+      used[kTPCsignalRandomized] || used[kTPCnSigmaElRandomized] || used[kTPCnSigmaPiRandomized] || used[kTPCnSigmaPrRandomized]) {
+    groups |= kVarGroupTrackPIDCorr;
+  }
+  if (used[kCosThetaHE] || used[kPhiHE] || used[kCosThetaCS] || used[kPhiCS]) {
+    groups |= kVarGroupPairPolarization;
+  }
+  if (used[kQuadDCAabsXY] || used[kQuadDCAsigXY] || used[kQuadDCAabsZ] || used[kQuadDCAsigZ] || used[kQuadDCAsigXYZ]) {
+    groups |= kVarGroupPairQuadDCA;
+  }
+  if (used[kPairPhiv]) {
+    groups |= kVarGroupPairPhiV;
+  }
+  ctx->fUsedVarGroups = groups;
+}
+
 //__________________________________________________________________
 void VarManager::ResetValues(int startValue, int endValue, float* values)
 {
@@ -215,23 +241,23 @@ void VarManager::SetCollisionSystem(TString system, float energy)
 }
 
 //__________________________________________________________________
-void VarManager::FillEventDerived(float* values)
+void VarManager::FillEventDerived(float* values, VarContext* ctx)
 {
   //
   // Fill event-wise derived quantities (these are all quantities which can be computed just based on the values already filled in the FillEvent() function)
   //
-  if (fgUsedVars[kRunId]) {
+  if (ctx->fUsedVars[kRunId]) {
     values[kRunId] = (fgRunMap.size() > 0 ? fgRunMap[static_cast<int>(values[kRunNo])] : 0);
   }
 }
 
 //__________________________________________________________________
-void VarManager::FillTrackDerived(float* values)
+void VarManager::FillTrackDerived(float* values, VarContext* ctx)
 {
   //
   // Fill track-wise derived quantities (these are all quantities which can be computed just based on the values already filled in the FillTrack() function)
   //
-  if (fgUsedVars[kP]) {
+  if (ctx->fUsedVars[kP]) {
     values[kP] = values[kPt] * std::cosh(values[kEta]);
   }
 }
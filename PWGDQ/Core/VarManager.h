@@ -438,6 +438,38 @@ class VarManager : public TObject
     kD0barToKPi
   };
 
+  // Groups of variables which are computed together in FillTrack() / FillPair()
+  // NOTE: The groups in use are derived from the used variables (i.e. those requested by the cuts, histograms and mixing handlers)
+  //       and FillTrack() / FillPair() run a kernel compiled only for those groups
+  //       Only the groups below are covered: the vertexing (FillPairVertexing, DCA fitter or KFParticle) and the Q-vector / vn
+  //       variables (FillQVectorFromGFW, FillPairVn) are always computed, since tasks write them to tables without declaring them as used
+  enum VarGroups {
+    kVarGroupTrackFlags = BIT(0),       // track quality flags and ITS cluster map based variables
+    kVarGroupTrackPIDCorr = BIT(1),     // TPC post-calibrated and randomized n-sigmas
+    kVarGroupPairPolarization = BIT(2), // polarization angles in the helicity and Collins-Soper frames
+    kVarGroupPairQuadDCA = BIT(3),      // quadratic mean of the leg DCAs
+    kVarGroupPairPhiV = BIT(4),         // pair phiV
+    kVarGroupsTrack = kVarGroupTrackFlags | kVarGroupTrackPIDCorr,
+    kVarGroupsPair = kVarGroupPairPolarization | kVarGroupPairQuadDCA | kVarGroupPairPhiV,
+    kVarGroupsAll = kVarGroupsTrack | kVarGroupsPair
+  };
+
+  // Context in which the variables are computed: the values array, the flags of the used variables and the vertexing tools.
+  // The static interface (fgValues and the Fill functions called without a context) works on fgDefaultContext.
+  // To run the Fill functions concurrently, each worker should use its own copy of the default context,
+  // made after all the Set* / Setup* calls, and pass it to the Fill functions.
+  struct VarContext {
+    float fValues[kNVars] = {0.0f};          // array holding the variables computed for the current object
+    bool fUsedVars[kNVars] = {false};        // flags for the variables which need to be computed
+    uint32_t fUsedVarGroups = kVarGroupsAll; // groups of variables needed, see UpdateUsedVarGroups()
+    bool fUsedKF = false;                    // use KFParticle instead of the DCA fitters for the vertexing
+    float fMagField = 0.5;                   // magnetic field
+    o2::vertexing::DCAFitterN<2> fFitterTwoProngBarrel;
+    o2::vertexing::DCAFitterN<3> fFitterThreeProngBarrel;
+    o2::vertexing::FwdDCAFitterN<2> fFitterTwoProngFwd;
+    o2::vertexing::FwdDCAFitterN<3> fFitterThreeProngFwd;
+  };
+
   static TString fgVariableNames[kNVars]; // variable names
   static TString fgVariableUnits[kNVars]; // variable units
   static void SetDefaultVarNames();
@@ -448,6 +480,7 @@ class VarManager : public TObject
       fgUsedVars[var] = kTRUE;
     }
     SetVariableDependencies();
+    UpdateUsedVarGroups();
   }
   static void SetUseVars(const bool* usedVars)
   {
@@ -457,13 +490,17 @@ class VarManager : public TObject
       }
     }
     SetVariableDependencies();
+    UpdateUsedVarGroups();
   }
   static void SetUseVars(const std::vector<int> usedVars)
   {
     for (auto& var : usedVars) {
       fgUsedVars[var] = true;
     }
+    UpdateUsedVarGroups();
   }
+  // Derive the groups of variables to be computed from the used variables of the context (default context if nullptr)
+  static void UpdateUsedVarGroups(VarContext* ctx = nullptr);
   static bool GetUsedVar(int var)
   {
     if (var >= 0 && var < kNVars) {
@@ -501,55 +538,55 @@ class VarManager : public TObject
 
   static void SetMagneticField(float magField)
   {
-    fgMagField = magField;
+    fgDefaultContext.fMagField = magField;
   }
 
   // Setup the 2 prong KFParticle
   static void SetupTwoProngKFParticle(float magField)
   {
     KFParticle::SetField(magField);
-    fgUsedKF = true;
+    fgDefaultContext.fUsedKF = true;
   }
 
   // Setup the 2 prong DCAFitterN
   static void SetupTwoProngDCAFitter(float magField, bool propagateToPCA, float maxR, float maxDZIni, float minParamChange, float minRelChi2Change, bool useAbsDCA)
   {
-    fgFitterTwoProngBarrel.setBz(magField);
-    fgFitterTwoProngBarrel.setPropagateToPCA(propagateToPCA);
-    fgFitterTwoProngBarrel.setMaxR(maxR);
-    fgFitterTwoProngBarrel.setMaxDZIni(maxDZIni);
-    fgFitterTwoProngBarrel.setMinParamChange(minParamChange);
-    fgFitterTwoProngBarrel.setMinRelChi2Change(minRelChi2Change);
-    fgFitterTwoProngBarrel.setUseAbsDCA(useAbsDCA);
-    fgUsedKF = false;
+    fgDefaultContext.fFitterTwoProngBarrel.setBz(magField);
+    fgDefaultContext.fFitterTwoProngBarrel.setPropagateToPCA(propagateToPCA);
+    fgDefaultContext.fFitterTwoProngBarrel.setMaxR(maxR);
+    fgDefaultContext.fFitterTwoProngBarrel.setMaxDZIni(maxDZIni);
+    fgDefaultContext.fFitterTwoProngBarrel.setMinParamChange(minParamChange);
+    fgDefaultContext.fFitterTwoProngBarrel.setMinRelChi2Change(minRelChi2Change);
+    fgDefaultContext.fFitterTwoProngBarrel.setUseAbsDCA(useAbsDCA);
+    fgDefaultContext.fUsedKF = false;
   }
 
   // Setup the 2 prong FwdDCAFitterN
   static void SetupTwoProngFwdDCAFitter(float magField, bool propagateToPCA, float maxR, float minParamChange, float minRelChi2Change, bool useAbsDCA)
   {
-    fgFitterTwoProngFwd.setBz(magField);
-    fgFitterTwoProngFwd.setPropagateToPCA(propagateToPCA);
-    fgFitterTwoProngFwd.setMaxR(maxR);
-    fgFitterTwoProngFwd.setMinParamChange(minParamChange);
-    fgFitterTwoProngFwd.setMinRelChi2Change(minRelChi2Change);
-    fgFitterTwoProngFwd.setUseAbsDCA(useAbsDCA);
-    fgUsedKF = false;
+    fgDefaultContext.fFitterTwoProngFwd.setBz(magField);
+    fgDefaultContext.fFitterTwoProngFwd.setPropagateToPCA(propagateToPCA);
+    fgDefaultContext.fFitterTwoProngFwd.setMaxR(maxR);
+    fgDefaultContext.fFitterTwoProngFwd.setMinParamChange(minParamChange);
+    fgDefaultContext.fFitterTwoProngFwd.setMinRelChi2Change(minRelChi2Change);
+    fgDefaultContext.fFitterTwoProngFwd.setUseAbsDCA(useAbsDCA);
+    fgDefaultContext.fUsedKF = false;
   }
   // Use MatLayerCylSet to correct MCS in fwdtrack propagation
   static void SetupMatLUTFwdDCAFitter(o2::base::MatLayerCylSet* m)
   {
-    fgFitterTwoProngFwd.setTGeoMat(false);
-    fgFitterTwoProngFwd.setMatLUT(m);
+    fgDefaultContext.fFitterTwoProngFwd.setTGeoMat(false);
+    fgDefaultContext.fFitterTwoProngFwd.setMatLUT(m);
   }
   // Use GeometryManager to correct MCS in fwdtrack propagation
   static void SetupTGeoFwdDCAFitter()
   {
-    fgFitterTwoProngFwd.setTGeoMat(true);
+    fgDefaultContext.fFitterTwoProngFwd.setTGeoMat(true);
   }
   // No material budget in fwdtrack propagation
   static void SetupFwdDCAFitterNoCorr()
   {
-    fgFitterTwoProngFwd.setTGeoMat(false);
+    fgDefaultContext.fFitterTwoProngFwd.setTGeoMat(false);
   }
 
   static auto getEventPlane(int harm, float qnxa, float qnya)
@@ -559,33 +596,33 @@ class VarManager : public TObject
   };
 
   template <uint32_t fillMap, typename T>
-  static void FillEvent(T const& event, float* values = nullptr);
+  static void FillEvent(T const& event, float* values = nullptr, VarContext* ctx = nullptr);
   template <uint32_t fillMap, typename T>
-  static void FillTrack(T const& track, float* values = nullptr);
+  static void FillTrack(T const& track, float* values = nullptr, VarContext* ctx = nullptr);
   template <typename U, typename T>
-  static void FillTrackMC(const U& mcStack, T const& track, float* values = nullptr);
+  static void FillTrackMC(const U& mcStack, T const& track, float* values = nullptr, VarContext* ctx = nullptr);
   template <int pairType, uint32_t fillMap, typename T1, typename T2>
-  static void FillPair(T1 const& t1, T2 const& t2, float* values = nullptr);
+  static void FillPair(T1 const& t1, T2 const& t2, float* values = nullptr, VarContext* ctx = nullptr);
   template <int pairType, typename T1, typename T2>
-  static void FillPairME(T1 const& t1, T2 const& t2, float* values = nullptr);
+  static void FillPairME(T1 const& t1, T2 const& t2, float* values = nullptr, VarContext* ctx = nullptr);
   template <typename T1, typename T2>
-  static void FillPairMC(T1 const& t1, T2 const& t2, float* values = nullptr, PairCandidateType pairType = kDecayToEE);
+  static void FillPairMC(T1 const& t1, T2 const& t2, float* values = nullptr, PairCandidateType pairType = kDecayToEE, VarContext* ctx = nullptr);
   template <int pairType, uint32_t collFillMap, uint32_t fillMap, typename C, typename T>
-  static void FillPairVertexing(C const& collision, T const& t1, T const& t2, bool propToSV = false, float* values = nullptr);
+  static void FillPairVertexing(C const& collision, T const& t1, T const& t2, bool propToSV = false, float* values = nullptr, VarContext* ctx = nullptr);
   template <int candidateType, uint32_t collFillMap, uint32_t fillMap, typename C, typename T1>
-  static void FillDileptonTrackVertexing(C const& collision, T1 const& lepton1, T1 const& lepton2, T1 const& track, float* values);
+  static void FillDileptonTrackVertexing(C const& collision, T1 const& lepton1, T1 const& lepton2, T1 const& track, float* values, VarContext* ctx = nullptr);
   template <typename T1, typename T2>
-  static void FillDileptonHadron(T1 const& dilepton, T2 const& hadron, float* values = nullptr, float hadronMass = 0.0f);
+  static void FillDileptonHadron(T1 const& dilepton, T2 const& hadron, float* values = nullptr, float hadronMass = 0.0f, VarContext* ctx = nullptr);
   template <typename T>
-  static void FillHadron(T const& hadron, float* values = nullptr, float hadronMass = 0.0f);
+  static void FillHadron(T const& hadron, float* values = nullptr, float hadronMass = 0.0f, VarContext* ctx = nullptr);
   template <int partType, typename Cand, typename H>
-  static void FillSingleDileptonCharmHadron(Cand const& candidate, H hfHelper, float* values = nullptr);
+  static void FillSingleDileptonCharmHadron(Cand const& candidate, H hfHelper, float* values = nullptr, VarContext* ctx = nullptr);
   template <int partTypeCharmHad, typename DQ, typename HF, typename H>
-  static void FillDileptonCharmHadron(DQ const& dilepton, HF const& charmHadron, H hfHelper, float* values = nullptr);
+  static void FillDileptonCharmHadron(DQ const& dilepton, HF const& charmHadron, H hfHelper, float* values = nullptr, VarContext* ctx = nullptr);
   template <typename C, typename A>
-  static void FillQVectorFromGFW(C const& collision, A const& compA2, A const& compB2, A const& compC2, A const& compA3, A const& compB3, A const& compC3, float normA = 1.0, float normB = 1.0, float normC = 1.0, float* values = nullptr);
+  static void FillQVectorFromGFW(C const& collision, A const& compA2, A const& compB2, A const& compC2, A const& compA3, A const& compB3, A const& compC3, float normA = 1.0, float normB = 1.0, float normC = 1.0, float* values = nullptr, VarContext* ctx = nullptr);
   template <int pairType, typename T1, typename T2>
-  static void FillPairVn(T1 const& t1, T2 const& t2, float* values = nullptr);
+  static void FillPairVn(T1 const& t1, T2 const& t2, float* values = nullptr, VarContext* ctx = nullptr);
 
   static void SetCalibrationObject(CalibObjects calib, TObject* obj)
   {
@@ -618,23 +655,26 @@ class VarManager : public TObject
   VarManager();
   ~VarManager() override;
 
-  static float fgValues[kNVars]; // array holding all variables computed during analysis
+  static VarContext fgDefaultContext; // context used by the static interface
+  static float* fgValues;             // array holding all variables computed during analysis (values of the default context)
   static void ResetValues(int startValue = 0, int endValue = kNVars, float* values = nullptr);
 
  private:
-  static bool fgUsedVars[kNVars]; // holds flags for when the corresponding variable is needed (e.g., in the histogram manager, in cuts, mixing handler, etc.)
-  static bool fgUsedKF;
+  static bool* fgUsedVars;               // holds flags for when the corresponding variable is needed (e.g., in the histogram manager, in cuts, mixing handler, etc.)
   static void SetVariableDependencies(); // toggle those variables on which other used variables might depend
 
-  static float fgMagField;
   static std::map<int, int> fgRunMap;     // map of runs to be used in histogram axes
   static TString fgRunStr;                // semi-colon separated list of runs, to be used for histogram axis labels
   static std::vector<int> fgRunList;      // vector of runs, to be used for histogram axis
   static float fgCenterOfMassEnergy;      // collision energy
   static float fgMassofCollidingParticle; // mass of the colliding particle
 
-  static void FillEventDerived(float* values = nullptr);
-  static void FillTrackDerived(float* values = nullptr);
+  template <uint32_t fillMap, uint32_t varGroups, typename T>
+  static void FillTrackKernel(T const& track, float* values, VarContext* ctx);
+  template <int pairType, uint32_t fillMap, uint32_t varGroups, typename T1, typename T2>
+  static void FillPairKernel(T1 const& t1, T2 const& t2, float* values, VarContext* ctx);
+  static void FillEventDerived(float* values, VarContext* ctx);
+  static void FillTrackDerived(float* values, VarContext* ctx);
   template <typename T, typename U, typename V>
   static auto getRotatedCovMatrixXX(const T& matrix, U phi, V theta);
   template <typename T>
@@ -645,11 +685,6 @@ class VarManager : public TObject
   static KFPVertex createKFPVertexFromCollision(const T& collision);
   static float calculateCosPA(KFParticle kfp, KFParticle PV);
 
-  static o2::vertexing::DCAFitterN<2> fgFitterTwoProngBarrel;
-  static o2::vertexing::DCAFitterN<3> fgFitterThreeProngBarrel;
-  static o2::vertexing::FwdDCAFitterN<2> fgFitterTwoProngFwd;
-  static o2::vertexing::FwdDCAFitterN<3> fgFitterThreeProngFwd;
-
   static std::map<CalibObjects, TObject*> fgCalibs; // map of calibration histograms
   static bool fgRunTPCPostCalibration[4];           // 0-electron, 1-pion, 2-kaon, 3-proton
 
@@ -744,10 +779,13 @@ KFPVertex VarManager::createKFPVertexFromCollision(const T& collision)
 }
 
 template <uint32_t fillMap, typename T>
-void VarManager::FillEvent(T const& event, float* values)
+void VarManager::FillEvent(T const& event, float* values, VarContext* ctx)
 {
+  if (!ctx) {
+    ctx = &fgDefaultContext;
+  }
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
   }
 
   if constexpr ((fillMap & CollisionTimestamp) > 0) {
@@ -757,40 +795,40 @@ void VarManager::FillEvent(T const& event, float* values)
   if constexpr ((fillMap & Collision) > 0) {
     // TODO: trigger info from the event selection requires a separate flag
     //       so that it can be switched off independently of the rest of Collision variables (e.g. if event selection is not available)
-    if (fgUsedVars[kIsSel8]) {
+    if (ctx->fUsedVars[kIsSel8]) {
       values[kIsSel8] = event.selection_bit(o2::aod::evsel::kIsTriggerTVX);
     }
-    if (fgUsedVars[kIsINT7]) {
+    if (ctx->fUsedVars[kIsINT7]) {
       values[kIsINT7] = (event.alias_bit(kINT7) > 0);
     }
-    if (fgUsedVars[kIsEMC7]) {
+    if (ctx->fUsedVars[kIsEMC7]) {
       values[kIsEMC7] = (event.alias_bit(kEMC7) > 0);
     }
-    if (fgUsedVars[kIsINT7inMUON]) {
+    if (ctx->fUsedVars[kIsINT7inMUON]) {
       values[kIsINT7inMUON] = (event.alias_bit(kINT7inMUON) > 0);
     }
-    if (fgUsedVars[kIsMuonSingleLowPt7]) {
+    if (ctx->fUsedVars[kIsMuonSingleLowPt7]) {
       values[kIsMuonSingleLowPt7] = (event.alias_bit(kMuonSingleLowPt7) > 0);
     }
-    if (fgUsedVars[kIsMuonSingleHighPt7]) {
+    if (ctx->fUsedVars[kIsMuonSingleHighPt7]) {
       values[kIsMuonSingleHighPt7] = (event.alias_bit(kMuonSingleHighPt7) > 0);
     }
-    if (fgUsedVars[kIsMuonUnlikeLowPt7]) {
+    if (ctx->fUsedVars[kIsMuonUnlikeLowPt7]) {
       values[kIsMuonUnlikeLowPt7] = (event.alias_bit(kMuonUnlikeLowPt7) > 0);
     }
-    if (fgUsedVars[kIsMuonLikeLowPt7]) {
+    if (ctx->fUsedVars[kIsMuonLikeLowPt7]) {
       values[kIsMuonLikeLowPt7] = (event.alias_bit(kMuonLikeLowPt7) > 0);
     }
-    if (fgUsedVars[kIsCUP8]) {
+    if (ctx->fUsedVars[kIsCUP8]) {
       values[kIsCUP8] = (event.alias_bit(kCUP8) > 0);
     }
-    if (fgUsedVars[kIsCUP9]) {
+    if (ctx->fUsedVars[kIsCUP9]) {
       values[kIsCUP9] = (event.alias_bit(kCUP9) > 0);
     }
-    if (fgUsedVars[kIsMUP10]) {
+    if (ctx->fUsedVars[kIsMUP10]) {
       values[kIsMUP10] = (event.alias_bit(kMUP10) > 0);
     }
-    if (fgUsedVars[kIsMUP11]) {
+    if (ctx->fUsedVars[kIsMUP11]) {
       values[kIsMUP11] = (event.alias_bit(kMUP11) > 0);
     }
     values[kVtxX] = event.posX();
@@ -837,7 +875,7 @@ void VarManager::FillEvent(T const& event, float* values)
     values[kVtxZ] = event.posZ();
     values[kVtxNcontrib] = event.numContrib();
 
-    if (fgUsedVars[kIsSel8]) {
+    if (ctx->fUsedVars[kIsSel8]) {
       values[kIsSel8] = (event.tag() & (uint64_t(1) << o2::aod::evsel::kIsTriggerTVX)) > 0;
     }
   }
@@ -847,37 +885,37 @@ void VarManager::FillEvent(T const& event, float* values)
     values[kTimestamp] = event.timestamp();
     values[kCentVZERO] = event.centRun2V0M();
     values[kCentFT0C] = event.centFT0C();
-    if (fgUsedVars[kIsINT7]) {
+    if (ctx->fUsedVars[kIsINT7]) {
       values[kIsINT7] = (event.triggerAlias() & (uint32_t(1) << kINT7)) > 0;
     }
-    if (fgUsedVars[kIsEMC7]) {
+    if (ctx->fUsedVars[kIsEMC7]) {
       values[kIsEMC7] = (event.triggerAlias() & (uint32_t(1) << kEMC7)) > 0;
     }
-    if (fgUsedVars[kIsINT7inMUON]) {
+    if (ctx->fUsedVars[kIsINT7inMUON]) {
       values[kIsINT7inMUON] = (event.triggerAlias() & (uint32_t(1) << kINT7inMUON)) > 0;
     }
-    if (fgUsedVars[kIsMuonSingleLowPt7]) {
+    if (ctx->fUsedVars[kIsMuonSingleLowPt7]) {
       values[kIsMuonSingleLowPt7] = (event.triggerAlias() & (uint32_t(1) << kMuonSingleLowPt7)) > 0;
     }
-    if (fgUsedVars[kIsMuonSingleHighPt7]) {
+    if (ctx->fUsedVars[kIsMuonSingleHighPt7]) {
       values[kIsMuonSingleHighPt7] = (event.triggerAlias() & (uint32_t(1) << kMuonSingleHighPt7)) > 0;
     }
-    if (fgUsedVars[kIsMuonUnlikeLowPt7]) {
+    if (ctx->fUsedVars[kIsMuonUnlikeLowPt7]) {
       values[kIsMuonUnlikeLowPt7] = (event.triggerAlias() & (uint32_t(1) << kMuonUnlikeLowPt7)) > 0;
     }
-    if (fgUsedVars[kIsMuonLikeLowPt7]) {
+    if (ctx->fUsedVars[kIsMuonLikeLowPt7]) {
       values[kIsMuonLikeLowPt7] = (event.triggerAlias() & (uint32_t(1) << kMuonLikeLowPt7)) > 0;
     }
-    if (fgUsedVars[kIsCUP8]) {
+    if (ctx->fUsedVars[kIsCUP8]) {
       values[kIsCUP8] = (event.triggerAlias() & (uint32_t(1) << kCUP8)) > 0;
     }
-    if (fgUsedVars[kIsCUP9]) {
+    if (ctx->fUsedVars[kIsCUP9]) {
       values[kIsCUP9] = (event.triggerAlias() & (uint32_t(1) << kCUP9)) > 0;
     }
-    if (fgUsedVars[kIsMUP10]) {
+    if (ctx->fUsedVars[kIsMUP10]) {
       values[kIsMUP10] = (event.triggerAlias() & (uint32_t(1) << kMUP10)) > 0;
     }
-    if (fgUsedVars[kIsMUP11]) {
+    if (ctx->fUsedVars[kIsMUP11]) {
       values[kIsMUP11] = (event.triggerAlias() & (uint32_t(1) << kMUP11)) > 0;
     }
   }
@@ -938,32 +976,55 @@ void VarManager::FillEvent(T const& event, float* values)
     values[kMCEventImpParam] = event.impactParameter();
   }
 
-  FillEventDerived(values);
+  FillEventDerived(values, ctx);
 }
 
 template <uint32_t fillMap, typename T>
-void VarManager::FillTrack(T const& track, float* values)
+void VarManager::FillTrack(T const& track, float* values, VarContext* ctx)
 {
+  if (!ctx) {
+    ctx = &fgDefaultContext;
+  }
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
+  }
+
+  // run the kernel compiled for the variable groups needed in this context
+  switch (ctx->fUsedVarGroups & kVarGroupsTrack) {
+    case 0:
+      FillTrackKernel<fillMap, 0>(track, values, ctx);
+      break;
+    case kVarGroupTrackFlags:
+      FillTrackKernel<fillMap, kVarGroupTrackFlags>(track, values, ctx);
+      break;
+    case kVarGroupTrackPIDCorr:
+      FillTrackKernel<fillMap, kVarGroupTrackPIDCorr>(track, values, ctx);
+      break;
+    default:
+      FillTrackKernel<fillMap, kVarGroupsTrack>(track, values, ctx);
+      break;
   }
+}
 
+template <uint32_t fillMap, uint32_t varGroups, typename T>
+void VarManager::FillTrackKernel(T const& track, float* values, VarContext* ctx)
+{
   // Quantities based on the basic table (contains just kine information and filter bits)
   if constexpr ((fillMap & Track) > 0 || (fillMap & Muon) > 0 || (fillMap & ReducedTrack) > 0 || (fillMap & ReducedMuon) > 0) {
     values[kPt] = track.pt();
-    if (fgUsedVars[kP]) {
+    if (ctx->fUsedVars[kP]) {
       values[kP] = track.p();
     }
-    if (fgUsedVars[kPx]) {
+    if (ctx->fUsedVars[kPx]) {
       values[kPx] = track.px();
     }
-    if (fgUsedVars[kPy]) {
+    if (ctx->fUsedVars[kPy]) {
       values[kPy] = track.py();
     }
-    if (fgUsedVars[kPz]) {
+    if (ctx->fUsedVars[kPz]) {
       values[kPz] = track.pz();
     }
-    if (fgUsedVars[kInvPt]) {
+    if (ctx->fUsedVars[kInvPt]) {
       values[kInvPt] = 1. / track.pt();
     }
     values[kEta] = track.eta();
@@ -993,45 +1054,47 @@ void VarManager::FillTrack(T const& track, float* values)
   if constexpr ((fillMap & TrackExtra) > 0 || (fillMap & ReducedTrackBarrel) > 0) {
     values[kPin] = track.tpcInnerParam();
     values[kSignedPin] = track.tpcInnerParam() * track.sign();
-    if (fgUsedVars[kIsITSrefit]) {
-      values[kIsITSrefit] = (track.flags() & o2::aod::track::ITSrefit) > 0; // NOTE: This is just for Run-2
-    }
-    if (fgUsedVars[kTrackTimeResIsRange]) {
-      values[kTrackTimeResIsRange] = (track.flags() & o2::aod::track::TrackTimeResIsRange) > 0; // NOTE: This is NOT for Run-2
-    }
-    if (fgUsedVars[kIsTPCrefit]) {
-      values[kIsTPCrefit] = (track.flags() & o2::aod::track::TPCrefit) > 0; // NOTE: This is just for Run-2
-    }
-    if (fgUsedVars[kPVContributor]) {
-      values[kPVContributor] = (track.flags() & o2::aod::track::PVContributor) > 0; // NOTE: This is NOT for Run-2
-    }
-    if (fgUsedVars[kIsGoldenChi2]) {
-      values[kIsGoldenChi2] = (track.flags() & o2::aod::track::GoldenChi2) > 0; // NOTE: This is just for Run-2
-    }
-    if (fgUsedVars[kOrphanTrack]) {
-      values[kOrphanTrack] = (track.flags() & o2::aod::track::OrphanTrack) > 0; // NOTE: This is NOT for Run-2
-    }
-    if (fgUsedVars[kIsSPDfirst]) {
-      values[kIsSPDfirst] = (track.itsClusterMap() & uint8_t(1)) > 0;
-    }
-    if (fgUsedVars[kIsSPDboth]) {
-      values[kIsSPDboth] = (track.itsClusterMap() & uint8_t(3)) > 0;
-    }
-    if (fgUsedVars[kIsSPDany]) {
-      values[kIsSPDany] = (track.itsClusterMap() & uint8_t(1)) || (track.itsClusterMap() & uint8_t(2));
-    }
-    if (fgUsedVars[kITSClusterMap]) {
-      values[kITSClusterMap] = track.itsClusterMap();
-    }
+    if constexpr ((varGroups & kVarGroupTrackFlags) > 0) {
+      if (ctx->fUsedVars[kIsITSrefit]) {
+        values[kIsITSrefit] = (track.flags() & o2::aod::track::ITSrefit) > 0; // NOTE: This is just for Run-2
+      }
+      if (ctx->fUsedVars[kTrackTimeResIsRange]) {
+        values[kTrackTimeResIsRange] = (track.flags() & o2::aod::track::TrackTimeResIsRange) > 0; // NOTE: This is NOT for Run-2
+      }
+      if (ctx->fUsedVars[kIsTPCrefit]) {
+        values[kIsTPCrefit] = (track.flags() & o2::aod::track::TPCrefit) > 0; // NOTE: This is just for Run-2
+      }
+      if (ctx->fUsedVars[kPVContributor]) {
+        values[kPVContributor] = (track.flags() & o2::aod::track::PVContributor) > 0; // NOTE: This is NOT for Run-2
+      }
+      if (ctx->fUsedVars[kIsGoldenChi2]) {
+        values[kIsGoldenChi2] = (track.flags() & o2::aod::track::GoldenChi2) > 0; // NOTE: This is just for Run-2
+      }
+      if (ctx->fUsedVars[kOrphanTrack]) {
+        values[kOrphanTrack] = (track.flags() & o2::aod::track::OrphanTrack) > 0; // NOTE: This is NOT for Run-2
+      }
+      if (ctx->fUsedVars[kIsSPDfirst]) {
+        values[kIsSPDfirst] = (track.itsClusterMap() & uint8_t(1)) > 0;
+      }
+      if (ctx->fUsedVars[kIsSPDboth]) {
+        values[kIsSPDboth] = (track.itsClusterMap() & uint8_t(3)) > 0;
+      }
+      if (ctx->fUsedVars[kIsSPDany]) {
+        values[kIsSPDany] = (track.itsClusterMap() & uint8_t(1)) || (track.itsClusterMap() & uint8_t(2));
+      }
+      if (ctx->fUsedVars[kITSClusterMap]) {
+        values[kITSClusterMap] = track.itsClusterMap();
+      }
 
-    if (fgUsedVars[kIsITSibFirst]) {
-      values[kIsITSibFirst] = (track.itsClusterMap() & uint8_t(1)) > 0;
-    }
-    if (fgUsedVars[kIsITSibAny]) {
-      values[kIsITSibAny] = (track.itsClusterMap() & (1 << uint8_t(0))) > 0 || (track.itsClusterMap() & (1 << uint8_t(1))) > 0 || (track.itsClusterMap() & (1 << uint8_t(2))) > 0;
-    }
-    if (fgUsedVars[kIsITSibAll]) {
-      values[kIsITSibAll] = (track.itsClusterMap() & (1 << uint8_t(0))) > 0 && (track.itsClusterMap() & (1 << uint8_t(1))) > 0 && (track.itsClusterMap() & (1 << uint8_t(2))) > 0;
+      if (ctx->fUsedVars[kIsITSibFirst]) {
+        values[kIsITSibFirst] = (track.itsClusterMap() & uint8_t(1)) > 0;
+      }
+      if (ctx->fUsedVars[kIsITSibAny]) {
+        values[kIsITSibAny] = (track.itsClusterMap() & (1 << uint8_t(0))) > 0 || (track.itsClusterMap() & (1 << uint8_t(1))) > 0 || (track.itsClusterMap() & (1 << uint8_t(2))) > 0;
+      }
+      if (ctx->fUsedVars[kIsITSibAll]) {
+        values[kIsITSibAll] = (track.itsClusterMap() & (1 << uint8_t(0))) > 0 && (track.itsClusterMap() & (1 << uint8_t(1))) > 0 && (track.itsClusterMap() & (1 << uint8_t(2))) > 0;
+      }
     }
 
     values[kTrackTime] = track.trackTime();
@@ -1055,12 +1118,12 @@ void VarManager::FillTrack(T const& track, float* values)
     values[kHasTPC] = track.hasTPC();
 
     if constexpr ((fillMap & TrackExtra) > 0) {
-      if (fgUsedVars[kITSncls]) {
+      if (ctx->fUsedVars[kITSncls]) {
         values[kITSncls] = track.itsNCls(); // dynamic column
       }
     }
     if constexpr ((fillMap & ReducedTrackBarrel) > 0) {
-      if (fgUsedVars[kITSncls]) {
+      if (ctx->fUsedVars[kITSncls]) {
         values[kITSncls] = 0.0;
         for (int i = 0; i < 7; ++i) {
           values[kITSncls] += ((track.itsClusterMap() & (1 << i)) ? 1 : 0);
@@ -1069,16 +1132,16 @@ void VarManager::FillTrack(T const& track, float* values)
       values[kTrackDCAxy] = track.dcaXY();
       values[kTrackDCAz] = track.dcaZ();
       if constexpr ((fillMap & ReducedTrackBarrelCov) > 0) {
-        if (fgUsedVars[kTrackDCAsigXY]) {
+        if (ctx->fUsedVars[kTrackDCAsigXY]) {
           values[kTrackDCAsigXY] = track.dcaXY() / std::sqrt(track.cYY());
         }
-        if (fgUsedVars[kTrackDCAsigZ]) {
+        if (ctx->fUsedVars[kTrackDCAsigZ]) {
           values[kTrackDCAsigZ] = track.dcaZ() / std::sqrt(track.cZZ());
         }
-        if (fgUsedVars[kTrackDCAresXY]) {
+        if (ctx->fUsedVars[kTrackDCAresXY]) {
           values[kTrackDCAresXY] = std::sqrt(track.cYY());
         }
-        if (fgUsedVars[kTrackDCAresZ]) {
+        if (ctx->fUsedVars[kTrackDCAresZ]) {
           values[kTrackDCAresZ] = std::sqrt(track.cZZ());
         }
       }
@@ -1090,16 +1153,16 @@ void VarManager::FillTrack(T const& track, float* values)
     values[kTrackDCAxy] = track.dcaXY();
     values[kTrackDCAz] = track.dcaZ();
     if constexpr ((fillMap & TrackCov) > 0) {
-      if (fgUsedVars[kTrackDCAsigXY]) {
+      if (ctx->fUsedVars[kTrackDCAsigXY]) {
         values[kTrackDCAsigXY] = track.dcaXY() / std::sqrt(track.cYY());
       }
-      if (fgUsedVars[kTrackDCAsigZ]) {
+      if (ctx->fUsedVars[kTrackDCAsigZ]) {
         values[kTrackDCAsigZ] = track.dcaZ() / std::sqrt(track.cZZ());
       }
-      if (fgUsedVars[kTrackDCAresXY]) {
+      if (ctx->fUsedVars[kTrackDCAresXY]) {
         values[kTrackDCAresXY] = std::sqrt(track.cYY());
       }
-      if (fgUsedVars[kTrackDCAresZ]) {
+      if (ctx->fUsedVars[kTrackDCAresZ]) {
         values[kTrackDCAresZ] = std::sqrt(track.cZZ());
       }
     }
@@ -1134,100 +1197,104 @@ void VarManager::FillTrack(T const& track, float* values)
     values[kTPCnSigmaKa] = track.tpcNSigmaKa();
     values[kTPCnSigmaPr] = track.tpcNSigmaPr();
 
-    // compute TPC postcalibrated electron nsigma based on calibration histograms from CCDB
-    if (fgUsedVars[kTPCnSigmaEl_Corr] && fgRunTPCPostCalibration[0]) {
-      TH3F* calibMean = reinterpret_cast<TH3F*>(fgCalibs[kTPCElectronMean]);
-      TH3F* calibSigma = reinterpret_cast<TH3F*>(fgCalibs[kTPCElectronSigma]);
-
-      int binTPCncls = calibMean->GetXaxis()->FindBin(values[kTPCncls]);
-      binTPCncls = (binTPCncls == 0 ? 1 : binTPCncls);
-      binTPCncls = (binTPCncls > calibMean->GetXaxis()->GetNbins() ? calibMean->GetXaxis()->GetNbins() : binTPCncls);
-      int binPin = calibMean->GetYaxis()->FindBin(values[kPin]);
-      binPin = (binPin == 0 ? 1 : binPin);
-      binPin = (binPin > calibMean->GetYaxis()->GetNbins() ? calibMean->GetYaxis()->GetNbins() : binPin);
-      int binEta = calibMean->GetZaxis()->FindBin(values[kEta]);
-      binEta = (binEta == 0 ? 1 : binEta);
-      binEta = (binEta > calibMean->GetZaxis()->GetNbins() ? calibMean->GetZaxis()->GetNbins() : binEta);
-
-      double mean = calibMean->GetBinContent(binTPCncls, binPin, binEta);
-      double width = calibSigma->GetBinContent(binTPCncls, binPin, binEta);
-      values[kTPCnSigmaEl_Corr] = (values[kTPCnSigmaEl] - mean) / width;
-    }
-    // compute TPC postcalibrated pion nsigma if required
-    if (fgUsedVars[kTPCnSigmaPi_Corr] && fgRunTPCPostCalibration[1]) {
-      TH3F* calibMean = reinterpret_cast<TH3F*>(fgCalibs[kTPCPionMean]);
-      TH3F* calibSigma = reinterpret_cast<TH3F*>(fgCalibs[kTPCPionSigma]);
-
-      int binTPCncls = calibMean->GetXaxis()->FindBin(values[kTPCncls]);
-      binTPCncls = (binTPCncls == 0 ? 1 : binTPCncls);
-      binTPCncls = (binTPCncls > calibMean->GetXaxis()->GetNbins() ? calibMean->GetXaxis()->GetNbins() : binTPCncls);
-      int binPin = calibMean->GetYaxis()->FindBin(values[kPin]);
-      binPin = (binPin == 0 ? 1 : binPin);
-      binPin = (binPin > calibMean->GetYaxis()->GetNbins() ? calibMean->GetYaxis()->GetNbins() : binPin);
-      int binEta = calibMean->GetZaxis()->FindBin(values[kEta]);
-      binEta = (binEta == 0 ? 1 : binEta);
-      binEta = (binEta > calibMean->GetZaxis()->GetNbins() ? calibMean->GetZaxis()->GetNbins() : binEta);
-
-      double mean = calibMean->GetBinContent(binTPCncls, binPin, binEta);
-      double width = calibSigma->GetBinContent(binTPCncls, binPin, binEta);
-      values[kTPCnSigmaPi_Corr] = (values[kTPCnSigmaPi] - mean) / width;
-    }
-    if (fgUsedVars[kTPCnSigmaKa_Corr] && fgRunTPCPostCalibration[2]) {
-      TH3F* calibMean = reinterpret_cast<TH3F*>(fgCalibs[kTPCKaonMean]);
-      TH3F* calibSigma = reinterpret_cast<TH3F*>(fgCalibs[kTPCKaonSigma]);
-
-      int binTPCncls = calibMean->GetXaxis()->FindBin(values[kTPCncls]);
-      binTPCncls = (binTPCncls == 0 ? 1 : binTPCncls);
-      binTPCncls = (binTPCncls > calibMean->GetXaxis()->GetNbins() ? calibMean->GetXaxis()->GetNbins() : binTPCncls);
-      int binPin = calibMean->GetYaxis()->FindBin(values[kPin]);
-      binPin = (binPin == 0 ? 1 : binPin);
-      binPin = (binPin > calibMean->GetYaxis()->GetNbins() ? calibMean->GetYaxis()->GetNbins() : binPin);
-      int binEta = calibMean->GetZaxis()->FindBin(values[kEta]);
-      binEta = (binEta == 0 ? 1 : binEta);
-      binEta = (binEta > calibMean->GetZaxis()->GetNbins() ? calibMean->GetZaxis()->GetNbins() : binEta);
-
-      double mean = calibMean->GetBinContent(binTPCncls, binPin, binEta);
-      double width = calibSigma->GetBinContent(binTPCncls, binPin, binEta);
-      values[kTPCnSigmaKa_Corr] = (values[kTPCnSigmaKa] - mean) / width;
-    }
-    // compute TPC postcalibrated proton nsigma if required
-    if (fgUsedVars[kTPCnSigmaPr_Corr] && fgRunTPCPostCalibration[3]) {
-      TH3F* calibMean = reinterpret_cast<TH3F*>(fgCalibs[kTPCProtonMean]);
-      TH3F* calibSigma = reinterpret_cast<TH3F*>(fgCalibs[kTPCProtonSigma]);
-
-      int binTPCncls = calibMean->GetXaxis()->FindBin(values[kTPCncls]);
-      binTPCncls = (binTPCncls == 0 ? 1 : binTPCncls);
-      binTPCncls = (binTPCncls > calibMean->GetXaxis()->GetNbins() ? calibMean->GetXaxis()->GetNbins() : binTPCncls);
-      int binPin = calibMean->GetYaxis()->FindBin(values[kPin]);
-      binPin = (binPin == 0 ? 1 : binPin);
-      binPin = (binPin > calibMean->GetYaxis()->GetNbins() ? calibMean->GetYaxis()->GetNbins() : binPin);
-      int binEta = calibMean->GetZaxis()->FindBin(values[kEta]);
-      binEta = (binEta == 0 ? 1 : binEta);
-      binEta = (binEta > calibMean->GetZaxis()->GetNbins() ? calibMean->GetZaxis()->GetNbins() : binEta);
-
-      double mean = calibMean->GetBinContent(binTPCncls, binPin, binEta);
-      double width = calibSigma->GetBinContent(binTPCncls, binPin, binEta);
-      values[kTPCnSigmaPr_Corr] = (values[kTPCnSigmaPr] - mean) / width;
+    if constexpr ((varGroups & kVarGroupTrackPIDCorr) > 0) {
+      // compute TPC postcalibrated electron nsigma based on calibration histograms from CCDB
+      if (ctx->fUsedVars[kTPCnSigmaEl_Corr] && fgRunTPCPostCalibration[0]) {
+        TH3F* calibMean = reinterpret_cast<TH3F*>(fgCalibs[kTPCElectronMean]);
+        TH3F* calibSigma = reinterpret_cast<TH3F*>(fgCalibs[kTPCElectronSigma]);
+
+        int binTPCncls = calibMean->GetXaxis()->FindBin(values[kTPCncls]);
+        binTPCncls = (binTPCncls == 0 ? 1 : binTPCncls);
+        binTPCncls = (binTPCncls > calibMean->GetXaxis()->GetNbins() ? calibMean->GetXaxis()->GetNbins() : binTPCncls);
+        int binPin = calibMean->GetYaxis()->FindBin(values[kPin]);
+        binPin = (binPin == 0 ? 1 : binPin);
+        binPin = (binPin > calibMean->GetYaxis()->GetNbins() ? calibMean->GetYaxis()->GetNbins() : binPin);
+        int binEta = calibMean->GetZaxis()->FindBin(values[kEta]);
+        binEta = (binEta == 0 ? 1 : binEta);
+        binEta = (binEta > calibMean->GetZaxis()->GetNbins() ? calibMean->GetZaxis()->GetNbins() : binEta);
+
+        double mean = calibMean->GetBinContent(binTPCncls, binPin, binEta);
+        double width = calibSigma->GetBinContent(binTPCncls, binPin, binEta);
+        values[kTPCnSigmaEl_Corr] = (values[kTPCnSigmaEl] - mean) / width;
+      }
+      // compute TPC postcalibrated pion nsigma if required
+      if (ctx->fUsedVars[kTPCnSigmaPi_Corr] && fgRunTPCPostCalibration[1]) {
+        TH3F* calibMean = reinterpret_cast<TH3F*>(fgCalibs[kTPCPionMean]);
+        TH3F* calibSigma = reinterpret_cast<TH3F*>(fgCalibs[kTPCPionSigma]);
+
+        int binTPCncls = calibMean->GetXaxis()->FindBin(values[kTPCncls]);
+        binTPCncls = (binTPCncls == 0 ? 1 : binTPCncls);
+        binTPCncls = (binTPCncls > calibMean->GetXaxis()->GetNbins() ? calibMean->GetXaxis()->GetNbins() : binTPCncls);
+        int binPin = calibMean->GetYaxis()->FindBin(values[kPin]);
+        binPin = (binPin == 0 ? 1 : binPin);
+        binPin = (binPin > calibMean->GetYaxis()->GetNbins() ? calibMean->GetYaxis()->GetNbins() : binPin);
+        int binEta = calibMean->GetZaxis()->FindBin(values[kEta]);
+        binEta = (binEta == 0 ? 1 : binEta);
+        binEta = (binEta > calibMean->GetZaxis()->GetNbins() ? calibMean->GetZaxis()->GetNbins() : binEta);
+
+        double mean = calibMean->GetBinContent(binTPCncls, binPin, binEta);
+        double width = calibSigma->GetBinContent(binTPCncls, binPin, binEta);
+        values[kTPCnSigmaPi_Corr] = (values[kTPCnSigmaPi] - mean) / width;
+      }
+      if (ctx->fUsedVars[kTPCnSigmaKa_Corr] && fgRunTPCPostCalibration[2]) {
+        TH3F* calibMean = reinterpret_cast<TH3F*>(fgCalibs[kTPCKaonMean]);
+        TH3F* calibSigma = reinterpret_cast<TH3F*>(fgCalibs[kTPCKaonSigma]);
+
+        int binTPCncls = calibMean->GetXaxis()->FindBin(values[kTPCncls]);
+        binTPCncls = (binTPCncls == 0 ? 1 : binTPCncls);
+        binTPCncls = (binTPCncls > calibMean->GetXaxis()->GetNbins() ? calibMean->GetXaxis()->GetNbins() : binTPCncls);
+        int binPin = calibMean->GetYaxis()->FindBin(values[kPin]);
+        binPin = (binPin == 0 ? 1 : binPin);
+        binPin = (binPin > calibMean->GetYaxis()->GetNbins() ? calibMean->GetYaxis()->GetNbins() : binPin);
+        int binEta = calibMean->GetZaxis()->FindBin(values[kEta]);
+        binEta = (binEta == 0 ? 1 : binEta);
+        binEta = (binEta > calibMean->GetZaxis()->GetNbins() ? calibMean->GetZaxis()->GetNbins() : binEta);
+
+        double mean = calibMean->GetBinContent(binTPCncls, binPin, binEta);
+        double width = calibSigma->GetBinContent(binTPCncls, binPin, binEta);
+        values[kTPCnSigmaKa_Corr] = (values[kTPCnSigmaKa] - mean) / width;
+      }
+      // compute TPC postcalibrated proton nsigma if required
+      if (ctx->fUsedVars[kTPCnSigmaPr_Corr] && fgRunTPCPostCalibration[3]) {
+        TH3F* calibMean = reinterpret_cast<TH3F*>(fgCalibs[kTPCProtonMean]);
+        TH3F* calibSigma = reinterpret_cast<TH3F*>(fgCalibs[kTPCProtonSigma]);
+
+        int binTPCncls = calibMean->GetXaxis()->FindBin(values[kTPCncls]);
+        binTPCncls = (binTPCncls == 0 ? 1 : binTPCncls);
+        binTPCncls = (binTPCncls > calibMean->GetXaxis()->GetNbins() ? calibMean->GetXaxis()->GetNbins() : binTPCncls);
+        int binPin = calibMean->GetYaxis()->FindBin(values[kPin]);
+        binPin = (binPin == 0 ? 1 : binPin);
+        binPin = (binPin > calibMean->GetYaxis()->GetNbins() ? calibMean->GetYaxis()->GetNbins() : binPin);
+        int binEta = calibMean->GetZaxis()->FindBin(values[kEta]);
+        binEta = (binEta == 0 ? 1 : binEta);
+        binEta = (binEta > calibMean->GetZaxis()->GetNbins() ? calibMean->GetZaxis()->GetNbins() : binEta);
+
+        double mean = calibMean->GetBinContent(binTPCncls, binPin, binEta);
+        double width = calibSigma->GetBinContent(binTPCncls, binPin, binEta);
+        values[kTPCnSigmaPr_Corr] = (values[kTPCnSigmaPr] - mean) / width;
+      }
     }
     values[kTOFnSigmaEl] = track.tofNSigmaEl();
     values[kTOFnSigmaPi] = track.tofNSigmaPi();
     values[kTOFnSigmaKa] = track.tofNSigmaKa();
     values[kTOFnSigmaPr] = track.tofNSigmaPr();
 
-    if (fgUsedVars[kTPCsignalRandomized] || fgUsedVars[kTPCnSigmaElRandomized] || fgUsedVars[kTPCnSigmaPiRandomized] || fgUsedVars[kTPCnSigmaPrRandomized]) {
-      // NOTE: this is needed temporarily for the study of the impact of TPC pid degradation on the quarkonium triggers in high lumi pp
-      //     This study involves a degradation from a dE/dx resolution of 5% to one of 6% (20% worsening)
-      //     For this we smear the dE/dx and n-sigmas using a gaus distribution with a width of 3.3%
-      //         which is approx the needed amount to get dE/dx to a resolution of 6%
-      double randomX = gRandom->Gaus(0.0, 0.033);
-      values[kTPCsignalRandomized] = values[kTPCsignal] * (1.0 + randomX);
-      values[kTPCsignalRandomizedDelta] = values[kTPCsignal] * randomX;
-      values[kTPCnSigmaElRandomized] = values[kTPCnSigmaEl] * (1.0 + randomX);
-      values[kTPCnSigmaElRandomizedDelta] = values[kTPCnSigmaEl] * randomX;
-      values[kTPCnSigmaPiRandomized] = values[kTPCnSigmaPi] * (1.0 + randomX);
-      values[kTPCnSigmaPiRandomizedDelta] = values[kTPCnSigmaPi] * randomX;
-      values[kTPCnSigmaPrRandomized] = values[kTPCnSigmaPr] * (1.0 + randomX);
-      values[kTPCnSigmaPrRandomizedDelta] = values[kTPCnSigmaPr] * randomX;
+    if constexpr ((varGroups & kVarGroupTrackPIDCorr) > 0) {
+      if (ctx->fUsedVars[kTPCsignalRandomized] || ctx->fUsedVars[kTPCnSigmaElRandomized] || ctx->fUsedVars[kTPCnSigmaPiRandomized] || ctx->fUsedVars[kTPCnSigmaPrRandomized]) {
+        // NOTE: this is needed temporarily for the study of the impact of TPC pid degradation on the quarkonium triggers in high lumi pp
+        //     This study involves a degradation from a dE/dx resolution of 5% to one of 6% (20% worsening)
+        //     For this we smear the dE/dx and n-sigmas using a gaus distribution with a width of 3.3%
+        //         which is approx the needed amount to get dE/dx to a resolution of 6%
+        double randomX = gRandom->Gaus(0.0, 0.033);
+        values[kTPCsignalRandomized] = values[kTPCsignal] * (1.0 + randomX);
+        values[kTPCsignalRandomizedDelta] = values[kTPCsignal] * randomX;
+        values[kTPCnSigmaElRandomized] = values[kTPCnSigmaEl] * (1.0 + randomX);
+        values[kTPCnSigmaElRandomizedDelta] = values[kTPCnSigmaEl] * randomX;
+        values[kTPCnSigmaPiRandomized] = values[kTPCnSigmaPi] * (1.0 + randomX);
+        values[kTPCnSigmaPiRandomizedDelta] = values[kTPCnSigmaPi] * randomX;
+        values[kTPCnSigmaPrRandomized] = values[kTPCnSigmaPr] * (1.0 + randomX);
+        values[kTPCnSigmaPrRandomizedDelta] = values[kTPCnSigmaPr] * randomX;
+      }
     }
 
     if constexpr ((fillMap & ReducedTrackBarrelPID) > 0) {
@@ -1283,14 +1350,17 @@ void VarManager::FillTrack(T const& track, float* values)
   }
 
   // Derived quantities which can be computed based on already filled variables
-  FillTrackDerived(values);
+  FillTrackDerived(values, ctx);
 }
 
 template <typename U, typename T>
-void VarManager::FillTrackMC(const U& mcStack, T const& track, float* values)
+void VarManager::FillTrackMC(const U& mcStack, T const& track, float* values, VarContext* ctx)
 {
+  if (!ctx) {
+    ctx = &fgDefaultContext;
+  }
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
   }
 
   // Quantities based on the mc particle table
@@ -1313,16 +1383,51 @@ void VarManager::FillTrackMC(const U& mcStack, T const& track, float* values)
     values[kMCMotherPdgCode] = mother.pdgCode();
   }
 
-  FillTrackDerived(values);
+  FillTrackDerived(values, ctx);
 }
 
 template <int pairType, uint32_t fillMap, typename T1, typename T2>
-void VarManager::FillPair(T1 const& t1, T2 const& t2, float* values)
+void VarManager::FillPair(T1 const& t1, T2 const& t2, float* values, VarContext* ctx)
 {
+  if (!ctx) {
+    ctx = &fgDefaultContext;
+  }
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
+  }
+
+  // run the kernel compiled for the variable groups needed in this context
+  switch (ctx->fUsedVarGroups & kVarGroupsPair) {
+    case 0:
+      FillPairKernel<pairType, fillMap, 0>(t1, t2, values, ctx);
+      break;
+    case kVarGroupPairPolarization:
+      FillPairKernel<pairType, fillMap, kVarGroupPairPolarization>(t1, t2, values, ctx);
+      break;
+    case kVarGroupPairQuadDCA:
+      FillPairKernel<pairType, fillMap, kVarGroupPairQuadDCA>(t1, t2, values, ctx);
+      break;
+    case kVarGroupPairPhiV:
+      FillPairKernel<pairType, fillMap, kVarGroupPairPhiV>(t1, t2, values, ctx);
+      break;
+    case kVarGroupPairPolarization | kVarGroupPairQuadDCA:
+      FillPairKernel<pairType, fillMap, kVarGroupPairPolarization | kVarGroupPairQuadDCA>(t1, t2, values, ctx);
+      break;
+    case kVarGroupPairPolarization | kVarGroupPairPhiV:
+      FillPairKernel<pairType, fillMap, kVarGroupPairPolarization | kVarGroupPairPhiV>(t1, t2, values, ctx);
+      break;
+    case kVarGroupPairQuadDCA | kVarGroupPairPhiV:
+      FillPairKernel<pairType, fillMap, kVarGroupPairQuadDCA | kVarGroupPairPhiV>(t1, t2, values, ctx);
+      break;
+    default:
+      FillPairKernel<pairType, fillMap, kVarGroupsPair>(t1, t2, values, ctx);
+      break;
   }
+}
 
+template <int pairType, uint32_t fillMap, uint32_t varGroups, typename T1, typename T2>
+void VarManager::FillPairKernel(T1 const& t1, T2 const& t2, float* values, VarContext* ctx)
+{
   float m1 = o2::constants::physics::MassElectron;
   float m2 = o2::constants::physics::MassElectron;
   if constexpr (pairType == kDecayToMuMu) {
@@ -1351,13 +1456,13 @@ void VarManager::FillPair(T1 const& t1, T2 const& t2, float* values)
   double Ptot2 = TMath::Sqrt(v2.Px() * v2.Px() + v2.Py() * v2.Py() + v2.Pz() * v2.Pz());
   values[kDeltaPtotTracks] = Ptot1 - Ptot2;
 
-  if (fgUsedVars[kPsiPair]) {
-    values[kDeltaPhiPair] = (t1.sign() * fgMagField > 0.) ? (v1.Phi() - v2.Phi()) : (v2.Phi() - v1.Phi());
+  if (ctx->fUsedVars[kPsiPair]) {
+    values[kDeltaPhiPair] = (t1.sign() * ctx->fMagField > 0.) ? (v1.Phi() - v2.Phi()) : (v2.Phi() - v1.Phi());
     double xipair = TMath::ACos((v1.Px() * v2.Px() + v1.Py() * v2.Py() + v1.Pz() * v2.Pz()) / v1.P() / v2.P());
-    values[kPsiPair] = (t1.sign() * fgMagField > 0.) ? TMath::ASin((v1.Theta() - v2.Theta()) / xipair) : TMath::ASin((v2.Theta() - v1.Theta()) / xipair);
+    values[kPsiPair] = (t1.sign() * ctx->fMagField > 0.) ? TMath::ASin((v1.Theta() - v2.Theta()) / xipair) : TMath::ASin((v2.Theta() - v1.Theta()) / xipair);
   }
 
-  if (fgUsedVars[kOpeningAngle]) {
+  if (ctx->fUsedVars[kOpeningAngle]) {
     double scalar = v1.Px() * v2.Px() + v1.Py() * v2.Py() + v1.Pz() * v2.Pz();
     double Ptot12 = Ptot1 * Ptot2;
     if (Ptot12 <= 0) {
@@ -1372,47 +1477,49 @@ void VarManager::FillPair(T1 const& t1, T2 const& t2, float* values)
     }
   }
 
-  // TO DO: get the correct values from CCDB
-  double BeamMomentum = TMath::Sqrt(fgCenterOfMassEnergy * fgCenterOfMassEnergy / 4 - fgMassofCollidingParticle * fgMassofCollidingParticle); // GeV
-  ROOT::Math::PxPyPzEVector Beam1(0., 0., -BeamMomentum, fgCenterOfMassEnergy / 2);
-  ROOT::Math::PxPyPzEVector Beam2(0., 0., BeamMomentum, fgCenterOfMassEnergy / 2);
+  if constexpr ((varGroups & kVarGroupPairPolarization) > 0) {
+    // TO DO: get the correct values from CCDB
+    double BeamMomentum = TMath::Sqrt(fgCenterOfMassEnergy * fgCenterOfMassEnergy / 4 - fgMassofCollidingParticle * fgMassofCollidingParticle); // GeV
+    ROOT::Math::PxPyPzEVector Beam1(0., 0., -BeamMomentum, fgCenterOfMassEnergy / 2);
+    ROOT::Math::PxPyPzEVector Beam2(0., 0., BeamMomentum, fgCenterOfMassEnergy / 2);
 
-  // Boost to center of mass frame
-  ROOT::Math::Boost boostv12{v12.BoostToCM()};
-  ROOT::Math::XYZVectorF v1_CM{(boostv12(v1).Vect()).Unit()};
-  ROOT::Math::XYZVectorF v2_CM{(boostv12(v2).Vect()).Unit()};
-  ROOT::Math::XYZVectorF Beam1_CM{(boostv12(Beam1).Vect()).Unit()};
-  ROOT::Math::XYZVectorF Beam2_CM{(boostv12(Beam2).Vect()).Unit()};
+    // Boost to center of mass frame
+    ROOT::Math::Boost boostv12{v12.BoostToCM()};
+    ROOT::Math::XYZVectorF v1_CM{(boostv12(v1).Vect()).Unit()};
+    ROOT::Math::XYZVectorF v2_CM{(boostv12(v2).Vect()).Unit()};
+    ROOT::Math::XYZVectorF Beam1_CM{(boostv12(Beam1).Vect()).Unit()};
+    ROOT::Math::XYZVectorF Beam2_CM{(boostv12(Beam2).Vect()).Unit()};
 
-  // Helicity frame
-  ROOT::Math::XYZVectorF zaxis_HE{(v12.Vect()).Unit()};
-  ROOT::Math::XYZVectorF yaxis_HE{(Beam1_CM.Cross(Beam2_CM)).Unit()};
-  ROOT::Math::XYZVectorF xaxis_HE{(yaxis_HE.Cross(zaxis_HE)).Unit()};
+    // Helicity frame
+    ROOT::Math::XYZVectorF zaxis_HE{(v12.Vect()).Unit()};
+    ROOT::Math::XYZVectorF yaxis_HE{(Beam1_CM.Cross(Beam2_CM)).Unit()};
+    ROOT::Math::XYZVectorF xaxis_HE{(yaxis_HE.Cross(zaxis_HE)).Unit()};
 
-  // Collins-Soper frame
-  ROOT::Math::XYZVectorF zaxis_CS{((Beam1_CM.Unit() - Beam2_CM.Unit()).Unit())};
-  ROOT::Math::XYZVectorF yaxis_CS{(Beam1_CM.Cross(Beam2_CM)).Unit()};
-  ROOT::Math::XYZVectorF xaxis_CS{(yaxis_CS.Cross(zaxis_CS)).Unit()};
+    // Collins-Soper frame
+    ROOT::Math::XYZVectorF zaxis_CS{((Beam1_CM.Unit() - Beam2_CM.Unit()).Unit())};
+    ROOT::Math::XYZVectorF yaxis_CS{(Beam1_CM.Cross(Beam2_CM)).Unit()};
+    ROOT::Math::XYZVectorF xaxis_CS{(yaxis_CS.Cross(zaxis_CS)).Unit()};
 
-  if (fgUsedVars[kCosThetaHE]) {
-    values[kCosThetaHE] = (t1.sign() > 0 ? zaxis_HE.Dot(v1_CM) : zaxis_HE.Dot(v2_CM));
-  }
+    if (ctx->fUsedVars[kCosThetaHE]) {
+      values[kCosThetaHE] = (t1.sign() > 0 ? zaxis_HE.Dot(v1_CM) : zaxis_HE.Dot(v2_CM));
+    }
 
-  if (fgUsedVars[kPhiHE]) {
-    values[kPhiHE] = (t1.sign() > 0 ? TMath::ATan2(yaxis_HE.Dot(v1_CM), xaxis_HE.Dot(v1_CM)) : TMath::ATan2(yaxis_HE.Dot(v2_CM), xaxis_HE.Dot(v2_CM)));
-  }
+    if (ctx->fUsedVars[kPhiHE]) {
+      values[kPhiHE] = (t1.sign() > 0 ? TMath::ATan2(yaxis_HE.Dot(v1_CM), xaxis_HE.Dot(v1_CM)) : TMath::ATan2(yaxis_HE.Dot(v2_CM), xaxis_HE.Dot(v2_CM)));
+    }
 
-  if (fgUsedVars[kCosThetaCS]) {
-    values[kCosThetaCS] = (t1.sign() > 0 ? zaxis_CS.Dot(v1_CM) : zaxis_CS.Dot(v2_CM));
-  }
+    if (ctx->fUsedVars[kCosThetaCS]) {
+      values[kCosThetaCS] = (t1.sign() > 0 ? zaxis_CS.Dot(v1_CM) : zaxis_CS.Dot(v2_CM));
+    }
 
-  if (fgUsedVars[kPhiCS]) {
-    values[kPhiCS] = (t1.sign() > 0 ? TMath::ATan2(yaxis_CS.Dot(v1_CM), xaxis_CS.Dot(v1_CM)) : TMath::ATan2(yaxis_CS.Dot(v2_CM), xaxis_CS.Dot(v2_CM)));
+    if (ctx->fUsedVars[kPhiCS]) {
+      values[kPhiCS] = (t1.sign() > 0 ? TMath::ATan2(yaxis_CS.Dot(v1_CM), xaxis_CS.Dot(v1_CM)) : TMath::ATan2(yaxis_CS.Dot(v2_CM), xaxis_CS.Dot(v2_CM)));
+    }
   }
 
-  if constexpr ((pairType == kDecayToEE) && ((fillMap & TrackCov) > 0 || (fillMap & ReducedTrackBarrelCov) > 0)) {
+  if constexpr ((pairType == kDecayToEE) && ((fillMap & TrackCov) > 0 || (fillMap & ReducedTrackBarrelCov) > 0) && (varGroups & kVarGroupPairQuadDCA) > 0) {
 
-    if (fgUsedVars[kQuadDCAabsXY] || fgUsedVars[kQuadDCAsigXY] || fgUsedVars[kQuadDCAabsZ] || fgUsedVars[kQuadDCAsigZ] || fgUsedVars[kQuadDCAsigXYZ]) {
+    if (ctx->fUsedVars[kQuadDCAabsXY] || ctx->fUsedVars[kQuadDCAsigXY] || ctx->fUsedVars[kQuadDCAabsZ] || ctx->fUsedVars[kQuadDCAsigZ] || ctx->fUsedVars[kQuadDCAsigXYZ]) {
       // Quantities based on the barrel tables
       double dca1XY = t1.dcaXY();
       double dca2XY = t2.dcaXY();
@@ -1443,105 +1550,110 @@ void VarManager::FillPair(T1 const& t1, T2 const& t2, float* values)
       }
     }
   }
-  if (fgUsedVars[kPairPhiv]) {
-    // cos(phiv) = w*a /|w||a|
-    // with w = u x v
-    // and  a = u x z / |u x z|   , unit vector perpendicular to v12 and z-direction (magnetic field)
-    // u = v12 / |v12|            , the unit vector of v12
-    // v = v1 x v2 / |v1 x v2|    , unit vector perpendicular to v1 and v2
-
-    float bz = fgFitterTwoProngBarrel.getBz();
-
-    bool swapTracks = false;
-    if (v1.Pt() < v2.Pt()) { // ordering of track, pt1 > pt2
-      ROOT::Math::PtEtaPhiMVector v3 = v1;
-      v1 = v2;
-      v2 = v3;
-      swapTracks = true;
-    }
-
-    // momentum of e+ and e- in (ax,ay,az) axis. Note that az=0 by definition.
-    // vector product of pep X pem
-    float vpx = 0, vpy = 0, vpz = 0;
-    if (t1.sign() * t2.sign() > 0) { // Like Sign
-      if (!swapTracks) {
-        if (bz * t1.sign() < 0) {
-          vpx = v1.Py() * v2.Pz() - v1.Pz() * v2.Py();
-          vpy = v1.Pz() * v2.Px() - v1.Px() * v2.Pz();
-          vpz = v1.Px() * v2.Py() - v1.Py() * v2.Px();
-        } else {
-          vpx = v2.Py() * v1.Pz() - v2.Pz() * v1.Py();
-          vpy = v2.Pz() * v1.Px() - v2.Px() * v1.Pz();
-          vpz = v2.Px() * v1.Py() - v2.Py() * v1.Px();
-        }
-      } else { // swaped tracks
-        if (bz * t2.sign() < 0) {
-          vpx = v1.Py() * v2.Pz() - v1.Pz() * v2.Py();
-          vpy = v1.Pz() * v2.Px() - v1.Px() * v2.Pz();
-          vpz = v1.Px() * v2.Py() - v1.Py() * v2.Px();
-        } else {
-          vpx = v2.Py() * v1.Pz() - v2.Pz() * v1.Py();
-          vpy = v2.Pz() * v1.Px() - v2.Px() * v1.Pz();
-          vpz = v2.Px() * v1.Py() - v2.Py() * v1.Px();
-        }
+  if constexpr ((varGroups & kVarGroupPairPhiV) > 0) {
+    if (ctx->fUsedVars[kPairPhiv]) {
+      // cos(phiv) = w*a /|w||a|
+      // with w = u x v
+      // and  a = u x z / |u x z|   , unit vector perpendicular to v12 and z-direction (magnetic field)
+      // u = v12 / |v12|            , the unit vector of v12
+      // v = v1 x v2 / |v1 x v2|    , unit vector perpendicular to v1 and v2
+
+      float bz = ctx->fFitterTwoProngBarrel.getBz();
+
+      bool swapTracks = false;
+      if (v1.Pt() < v2.Pt()) { // ordering of track, pt1 > pt2
+        ROOT::Math::PtEtaPhiMVector v3 = v1;
+        v1 = v2;
+        v2 = v3;
+        swapTracks = true;
       }
-    } else { // Unlike Sign
-      if (!swapTracks) {
-        if (bz * t1.sign() > 0) {
-          vpx = v1.Py() * v2.Pz() - v1.Pz() * v2.Py();
-          vpy = v1.Pz() * v2.Px() - v1.Px() * v2.Pz();
-          vpz = v1.Px() * v2.Py() - v1.Py() * v2.Px();
-        } else {
-          vpx = v2.Py() * v1.Pz() - v2.Pz() * v1.Py();
-          vpy = v2.Pz() * v1.Px() - v2.Px() * v1.Pz();
-          vpz = v2.Px() * v1.Py() - v2.Py() * v1.Px();
+
+      // momentum of e+ and e- in (ax,ay,az) axis. Note that az=0 by definition.
+      // vector product of pep X pem
+      float vpx = 0, vpy = 0, vpz = 0;
+      if (t1.sign() * t2.sign() > 0) { // Like Sign
+        if (!swapTracks) {
+          if (bz * t1.sign() < 0) {
+            vpx = v1.Py() * v2.Pz() - v1.Pz() * v2.Py();
+            vpy = v1.Pz() * v2.Px() - v1.Px() * v2.Pz();
+            vpz = v1.Px() * v2.Py() - v1.Py() * v2.Px();
+          } else {
+            vpx = v2.Py() * v1.Pz() - v2.Pz() * v1.Py();
+            vpy = v2.Pz() * v1.Px() - v2.Px() * v1.Pz();
+            vpz = v2.Px() * v1.Py() - v2.Py() * v1.Px();
+          }
+        } else { // swaped tracks
+          if (bz * t2.sign() < 0) {
+            vpx = v1.Py() * v2.Pz() - v1.Pz() * v2.Py();
+            vpy = v1.Pz() * v2.Px() - v1.Px() * v2.Pz();
+            vpz = v1.Px() * v2.Py() - v1.Py() * v2.Px();
+          } else {
+            vpx = v2.Py() * v1.Pz() - v2.Pz() * v1.Py();
+            vpy = v2.Pz() * v1.Px() - v2.Px() * v1.Pz();
+            vpz = v2.Px() * v1.Py() - v2.Py() * v1.Px();
+          }
         }
-      } else { // swaped tracks
-        if (bz * t2.sign() > 0) {
-          vpx = v1.Py() * v2.Pz() - v1.Pz() * v2.Py();
-          vpy = v1.Pz() * v2.Px() - v1.Px() * v2.Pz();
-          vpz = v1.Px() * v2.Py() - v1.Py() * v2.Px();
-        } else {
-          vpx = v2.Py() * v1.Pz() - v2.Pz() * v1.Py();
-          vpy = v2.Pz() * v1.Px() - v2.Px() * v1.Pz();
-          vpz = v2.Px() * v1.Py() - v2.Py() * v1.Px();
+      } else { // Unlike Sign
+        if (!swapTracks) {
+          if (bz * t1.sign() > 0) {
+            vpx = v1.Py() * v2.Pz() - v1.Pz() * v2.Py();
+            vpy = v1.Pz() * v2.Px() - v1.Px() * v2.Pz();
+            vpz = v1.Px() * v2.Py() - v1.Py() * v2.Px();
+          } else {
+            vpx = v2.Py() * v1.Pz() - v2.Pz() * v1.Py();
+            vpy = v2.Pz() * v1.Px() - v2.Px() * v1.Pz();
+            vpz = v2.Px() * v1.Py() - v2.Py() * v1.Px();
+          }
+        } else { // swaped tracks
+          if (bz * t2.sign() > 0) {
+            vpx = v1.Py() * v2.Pz() - v1.Pz() * v2.Py();
+            vpy = v1.Pz() * v2.Px() - v1.Px() * v2.Pz();
+            vpz = v1.Px() * v2.Py() - v1.Py() * v2.Px();
+          } else {
+            vpx = v2.Py() * v1.Pz() - v2.Pz() * v1.Py();
+            vpy = v2.Pz() * v1.Px() - v2.Px() * v1.Pz();
+            vpz = v2.Px() * v1.Py() - v2.Py() * v1.Px();
+          }
         }
       }
-    }
 
-    // unit vector of pep X pem
-    float vx = vpx / TMath::Sqrt(vpx * vpx + vpy * vpy + vpz * vpz);
-    float vy = vpy / TMath::Sqrt(vpx * vpx + vpy * vpy + vpz * vpz);
-    float vz = vpz / TMath::Sqrt(vpx * vpx + vpy * vpy + vpz * vpz);
+      // unit vector of pep X pem
+      float vx = vpx / TMath::Sqrt(vpx * vpx + vpy * vpy + vpz * vpz);
+      float vy = vpy / TMath::Sqrt(vpx * vpx + vpy * vpy + vpz * vpz);
+      float vz = vpz / TMath::Sqrt(vpx * vpx + vpy * vpy + vpz * vpz);
 
-    float px = v12.Px();
-    float py = v12.Py();
-    float pz = v12.Pz();
+      float px = v12.Px();
+      float py = v12.Py();
+      float pz = v12.Pz();
 
-    // unit vector of (pep+pem)
-    float ux = px / TMath::Sqrt(px * px + py * py + pz * pz);
-    float uy = py / TMath::Sqrt(px * px + py * py + pz * pz);
-    float uz = pz / TMath::Sqrt(px * px + py * py + pz * pz);
-    float ax = uy / TMath::Sqrt(ux * ux + uy * uy);
-    float ay = -ux / TMath::Sqrt(ux * ux + uy * uy);
+      // unit vector of (pep+pem)
+      float ux = px / TMath::Sqrt(px * px + py * py + pz * pz);
+      float uy = py / TMath::Sqrt(px * px + py * py + pz * pz);
+      float uz = pz / TMath::Sqrt(px * px + py * py + pz * pz);
+      float ax = uy / TMath::Sqrt(ux * ux + uy * uy);
+      float ay = -ux / TMath::Sqrt(ux * ux + uy * uy);
 
-    // The third axis defined by vector product (ux,uy,uz)X(vx,vy,vz)
-    float wx = uy * vz - uz * vy;
-    float wy = uz * vx - ux * vz;
-    // by construction, (wx,wy,wz) must be a unit vector. Measure angle between (wx,wy,wz) and (ax,ay,0).
-    // The angle between them should be small if the pair is conversion. This function then returns values close to pi!
-    values[kPairPhiv] = TMath::ACos(wx * ax + wy * ay); // phiv in [0,pi] //cosPhiV = wx * ax + wy * ay;
+      // The third axis defined by vector product (ux,uy,uz)X(vx,vy,vz)
+      float wx = uy * vz - uz * vy;
+      float wy = uz * vx - ux * vz;
+      // by construction, (wx,wy,wz) must be a unit vector. Measure angle between (wx,wy,wz) and (ax,ay,0).
+      // The angle between them should be small if the pair is conversion. This function then returns values close to pi!
+      values[kPairPhiv] = TMath::ACos(wx * ax + wy * ay); // phiv in [0,pi] //cosPhiV = wx * ax + wy * ay;
+    }
   }
 }
 
 template <int pairType, typename T1, typename T2>
-void VarManager::FillPairME(T1 const& t1, T2 const& t2, float* values)
+void VarManager::FillPairME(T1 const& t1, T2 const& t2, float* values, VarContext* ctx)
 {
   //
   // Lightweight fill function called from the innermost event mixing loop
   //
+  if (!ctx) {
+    ctx = &fgDefaultContext;
+  }
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
   }
 
   float m1 = o2::constants::physics::MassElectron;
@@ -1571,10 +1683,13 @@ void VarManager::FillPairME(T1 const& t1, T2 const& t2, float* values)
 }
 
 template <typename T1, typename T2>
-void VarManager::FillPairMC(T1 const& t1, T2 const& t2, float* values, PairCandidateType pairType)
+void VarManager::FillPairMC(T1 const& t1, T2 const& t2, float* values, PairCandidateType pairType, VarContext* ctx)
 {
+  if (!ctx) {
+    ctx = &fgDefaultContext;
+  }
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
   }
 
   float m1 = o2::constants::physics::MassElectron;
@@ -1605,15 +1720,18 @@ void VarManager::FillPairMC(T1 const& t1, T2 const& t2, float* values, PairCandi
 }
 
 template <int pairType, uint32_t collFillMap, uint32_t fillMap, typename C, typename T>
-void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2, bool propToSV, float* values)
+void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2, bool propToSV, float* values, VarContext* ctx)
 {
   // check at compile time that the event and cov matrix have the cov matrix
   constexpr bool eventHasVtxCov = ((collFillMap & Collision) > 0 || (collFillMap & ReducedEventVtxCov) > 0);
   constexpr bool trackHasCov = ((fillMap & TrackCov) > 0 || (fillMap & ReducedTrackBarrelCov) > 0);
   constexpr bool muonHasCov = ((fillMap & MuonCov) > 0 || (fillMap & ReducedMuonCov) > 0);
 
+  if (!ctx) {
+    ctx = &fgDefaultContext;
+  }
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
   }
   float m1 = o2::constants::physics::MassElectron;
   float m2 = o2::constants::physics::MassElectron;
@@ -1625,8 +1743,8 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
   ROOT::Math::PtEtaPhiMVector v2(t2.pt(), t2.eta(), t2.phi(), m2);
   ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
 
-  values[kUsedKF] = fgUsedKF;
-  if (!fgUsedKF) {
+  values[kUsedKF] = ctx->fUsedKF;
+  if (!ctx->fUsedKF) {
     int procCode = 0;
 
     // TODO: use trackUtilities functions to initialize the various matrices to avoid code duplication
@@ -1644,7 +1762,7 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
                                       t2.cSnpSnp(), t2.cTglY(), t2.cTglZ(), t2.cTglSnp(), t2.cTglTgl(),
                                       t2.c1PtY(), t2.c1PtZ(), t2.c1PtSnp(), t2.c1PtTgl(), t2.c1Pt21Pt2()};
       o2::track::TrackParCov pars2{t2.x(), t2.alpha(), t2pars, t2covs};
-      procCode = fgFitterTwoProngBarrel.process(pars1, pars2);
+      procCode = ctx->fFitterTwoProngBarrel.process(pars1, pars2);
     } else if constexpr ((pairType == kDecayToMuMu) && muonHasCov) {
       // Initialize track parameters for forward
       double chi21 = t1.chi2();
@@ -1661,7 +1779,7 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
                              t2.c1PtX(), t2.c1PtY(), t2.c1PtPhi(), t2.c1PtTgl(), t2.c1Pt21Pt2()};
       SMatrix55 t2covs(v2.begin(), v2.end());
       o2::track::TrackParCovFwd pars2{t2.z(), t2pars, t2covs, chi22};
-      procCode = fgFitterTwoProngFwd.process(pars1, pars2);
+      procCode = ctx->fFitterTwoProngFwd.process(pars1, pars2);
     } else {
       return;
     }
@@ -1698,11 +1816,11 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
       auto covMatrixPV = primaryVertex.getCov();
 
       if constexpr (pairType == kDecayToEE && trackHasCov) {
-        secondaryVertex = fgFitterTwoProngBarrel.getPCACandidate();
-        covMatrixPCA = fgFitterTwoProngBarrel.calcPCACovMatrixFlat();
-        auto chi2PCA = fgFitterTwoProngBarrel.getChi2AtPCACandidate();
-        auto trackParVar0 = fgFitterTwoProngBarrel.getTrack(0);
-        auto trackParVar1 = fgFitterTwoProngBarrel.getTrack(1);
+        secondaryVertex = ctx->fFitterTwoProngBarrel.getPCACandidate();
+        covMatrixPCA = ctx->fFitterTwoProngBarrel.calcPCACovMatrixFlat();
+        auto chi2PCA = ctx->fFitterTwoProngBarrel.getChi2AtPCACandidate();
+        auto trackParVar0 = ctx->fFitterTwoProngBarrel.getTrack(0);
+        auto trackParVar1 = ctx->fFitterTwoProngBarrel.getTrack(1);
         values[kVertexingChi2PCA] = chi2PCA;
         v1 = {trackParVar0.getPt(), trackParVar0.getEta(), trackParVar0.getPhi(), m1};
         v2 = {trackParVar1.getPt(), trackParVar1.getEta(), trackParVar1.getPhi(), m2};
@@ -1710,11 +1828,11 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
 
       } else if constexpr (pairType == kDecayToMuMu && muonHasCov) {
         // Get pca candidate from forward DCA fitter
-        secondaryVertex = fgFitterTwoProngFwd.getPCACandidate();
-        covMatrixPCA = fgFitterTwoProngFwd.calcPCACovMatrixFlat();
-        auto chi2PCA = fgFitterTwoProngFwd.getChi2AtPCACandidate();
-        auto trackParVar0 = fgFitterTwoProngFwd.getTrack(0);
-        auto trackParVar1 = fgFitterTwoProngFwd.getTrack(1);
+        secondaryVertex = ctx->fFitterTwoProngFwd.getPCACandidate();
+        covMatrixPCA = ctx->fFitterTwoProngFwd.calcPCACovMatrixFlat();
+        auto chi2PCA = ctx->fFitterTwoProngFwd.getChi2AtPCACandidate();
+        auto trackParVar0 = ctx->fFitterTwoProngFwd.getTrack(0);
+        auto trackParVar1 = ctx->fFitterTwoProngFwd.getTrack(1);
         values[kVertexingChi2PCA] = chi2PCA;
         v1 = {trackParVar0.getPt(), trackParVar0.getEta(), trackParVar0.getPhi(), m1};
         v2 = {trackParVar1.getPt(), trackParVar1.getEta(), trackParVar1.getPhi(), m2};
@@ -1780,7 +1898,7 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
       KFGeoTwoProng.AddDaughter(trk0KF);
       KFGeoTwoProng.AddDaughter(trk1KF);
     }
-    if (fgUsedVars[kKFMass]) {
+    if (ctx->fUsedVars[kKFMass]) {
       values[kKFMass] = KFGeoTwoProng.GetMass();
     }
 
@@ -1788,7 +1906,7 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
       KFPVertex kfpVertex = createKFPVertexFromCollision(collision);
       values[kKFNContributorsPV] = kfpVertex.GetNContributors();
       KFParticle KFPV(kfpVertex);
-      if (fgUsedVars[kVertexingLxy] || fgUsedVars[kVertexingLz] || fgUsedVars[kVertexingLxyz] || fgUsedVars[kVertexingLxyErr] || fgUsedVars[kVertexingLzErr] || fgUsedVars[kVertexingTauxy] || fgUsedVars[kVertexingLxyOverErr] || fgUsedVars[kVertexingLzOverErr] || fgUsedVars[kVertexingLxyzOverErr]) {
+      if (ctx->fUsedVars[kVertexingLxy] || ctx->fUsedVars[kVertexingLz] || ctx->fUsedVars[kVertexingLxyz] || ctx->fUsedVars[kVertexingLxyErr] || ctx->fUsedVars[kVertexingLzErr] || ctx->fUsedVars[kVertexingTauxy] || ctx->fUsedVars[kVertexingLxyOverErr] || ctx->fUsedVars[kVertexingLzOverErr] || ctx->fUsedVars[kVertexingLxyzOverErr]) {
         double dxPair2PV = KFGeoTwoProng.GetX() - KFPV.GetX();
         double dyPair2PV = KFGeoTwoProng.GetY() - KFPV.GetY();
         double dzPair2PV = KFGeoTwoProng.GetZ() - KFPV.GetZ();
@@ -1811,42 +1929,42 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
         values[kVertexingTauz] = dzPair2PV * KFGeoTwoProng.GetMass() / (TMath::Abs(KFGeoTwoProng.GetPz()) * o2::constants::physics::LightSpeedCm2NS);
         values[kVertexingTauxyErr] = values[kVertexingLxyErr] * KFGeoTwoProng.GetMass() / (KFGeoTwoProng.GetPt() * o2::constants::physics::LightSpeedCm2NS);
         values[kVertexingTauzErr] = values[kVertexingLzErr] * KFGeoTwoProng.GetMass() / (TMath::Abs(KFGeoTwoProng.GetPz()) * o2::constants::physics::LightSpeedCm2NS);
-        if (fgUsedVars[kCosPointingAngle]) {
+        if (ctx->fUsedVars[kCosPointingAngle]) {
           values[kCosPointingAngle] = (std::sqrt(dxPair2PV * dxPair2PV) * v12.Px() +
                                        std::sqrt(dyPair2PV * dyPair2PV) * v12.Py() +
                                        std::sqrt(dzPair2PV * dzPair2PV) * v12.Pz()) /
                                       (v12.P() * values[VarManager::kVertexingLxyz]);
         }
       }
-      if (fgUsedVars[kVertexingLxyOverErr] || fgUsedVars[kVertexingLzOverErr] || fgUsedVars[kVertexingLxyzOverErr]) {
+      if (ctx->fUsedVars[kVertexingLxyOverErr] || ctx->fUsedVars[kVertexingLzOverErr] || ctx->fUsedVars[kVertexingLxyzOverErr]) {
         values[kVertexingLxyOverErr] = values[kVertexingLxy] / values[kVertexingLxyErr];
         values[kVertexingLzOverErr] = values[kVertexingLz] / values[kVertexingLzErr];
         values[kVertexingLxyzOverErr] = values[kVertexingLxyz] / values[kVertexingLxyzErr];
       }
 
-      if (fgUsedVars[kKFChi2OverNDFGeo])
+      if (ctx->fUsedVars[kKFChi2OverNDFGeo])
         values[kKFChi2OverNDFGeo] = KFGeoTwoProng.GetChi2() / KFGeoTwoProng.GetNDF();
-      if (fgUsedVars[kKFCosPA])
+      if (ctx->fUsedVars[kKFCosPA])
         values[kKFCosPA] = calculateCosPA(KFGeoTwoProng, KFPV);
 
       // in principle, they should be in FillTrack
-      if (fgUsedVars[kKFTrack0DCAxyz] || fgUsedVars[kKFTrack1DCAxyz]) {
+      if (ctx->fUsedVars[kKFTrack0DCAxyz] || ctx->fUsedVars[kKFTrack1DCAxyz]) {
         values[kKFTrack0DCAxyz] = trk0KF.GetDistanceFromVertex(KFPV);
         values[kKFTrack1DCAxyz] = trk1KF.GetDistanceFromVertex(KFPV);
       }
-      if (fgUsedVars[kKFTrack0DCAxy] || fgUsedVars[kKFTrack1DCAxy]) {
+      if (ctx->fUsedVars[kKFTrack0DCAxy] || ctx->fUsedVars[kKFTrack1DCAxy]) {
         values[kKFTrack0DCAxy] = trk0KF.GetDistanceFromVertexXY(KFPV);
         values[kKFTrack1DCAxy] = trk1KF.GetDistanceFromVertexXY(KFPV);
       }
-      if (fgUsedVars[kKFDCAxyzBetweenProngs])
+      if (ctx->fUsedVars[kKFDCAxyzBetweenProngs])
         values[kKFDCAxyzBetweenProngs] = trk0KF.GetDistanceFromParticle(trk1KF);
-      if (fgUsedVars[kKFDCAxyBetweenProngs])
+      if (ctx->fUsedVars[kKFDCAxyBetweenProngs])
         values[kKFDCAxyBetweenProngs] = trk0KF.GetDistanceFromParticle(trk1KF);
 
-      if (fgUsedVars[kKFTracksDCAxyzMax]) {
+      if (ctx->fUsedVars[kKFTracksDCAxyzMax]) {
         values[kKFTracksDCAxyzMax] = values[kKFTrack0DCAxyz] > values[kKFTrack1DCAxyz] ? values[kKFTrack0DCAxyz] : values[kKFTrack1DCAxyz];
       }
-      if (fgUsedVars[kKFTracksDCAxyMax]) {
+      if (ctx->fUsedVars[kKFTracksDCAxyMax]) {
         values[kKFTracksDCAxyMax] = TMath::Abs(values[kKFTrack0DCAxy]) > TMath::Abs(values[kKFTrack1DCAxy]) ? values[kKFTrack0DCAxy] : values[kKFTrack1DCAxy];
       }
       if (propToSV) {
@@ -1870,8 +1988,8 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
           auto geoMan2 = o2::base::GeometryManager::meanMaterialBudget(t2.x(), t2.y(), t2.z(), KFGeoTwoProng.GetX(), KFGeoTwoProng.GetY(), KFGeoTwoProng.GetZ());
           auto x2x01 = static_cast<float>(geoMan1.meanX2X0);
           auto x2x02 = static_cast<float>(geoMan2.meanX2X0);
-          pars1.propagateToVtxhelixWithMCS(KFGeoTwoProng.GetZ(), {KFGeoTwoProng.GetX(), KFGeoTwoProng.GetY()}, {KFGeoTwoProng.GetCovariance(0, 0), KFGeoTwoProng.GetCovariance(1, 1)}, fgFitterTwoProngFwd.getBz(), x2x01);
-          pars2.propagateToVtxhelixWithMCS(KFGeoTwoProng.GetZ(), {KFGeoTwoProng.GetX(), KFGeoTwoProng.GetY()}, {KFGeoTwoProng.GetCovariance(0, 0), KFGeoTwoProng.GetCovariance(1, 1)}, fgFitterTwoProngFwd.getBz(), x2x02);
+          pars1.propagateToVtxhelixWithMCS(KFGeoTwoProng.GetZ(), {KFGeoTwoProng.GetX(), KFGeoTwoProng.GetY()}, {KFGeoTwoProng.GetCovariance(0, 0), KFGeoTwoProng.GetCovariance(1, 1)}, ctx->fFitterTwoProngFwd.getBz(), x2x01);
+          pars2.propagateToVtxhelixWithMCS(KFGeoTwoProng.GetZ(), {KFGeoTwoProng.GetX(), KFGeoTwoProng.GetY()}, {KFGeoTwoProng.GetCovariance(0, 0), KFGeoTwoProng.GetCovariance(1, 1)}, ctx->fFitterTwoProngFwd.getBz(), x2x02);
           v1 = {pars1.getPt(), pars1.getEta(), pars1.getPhi(), m1};
           v2 = {pars2.getPt(), pars2.getEta(), pars2.getPhi(), m2};
           v12 = v1 + v2;
@@ -1904,14 +2022,17 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
 }
 
 template <int candidateType, uint32_t collFillMap, uint32_t fillMap, typename C, typename T1>
-void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton1, T1 const& lepton2, T1 const& track, float* values)
+void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton1, T1 const& lepton2, T1 const& track, float* values, VarContext* ctx)
 {
 
   constexpr bool eventHasVtxCov = ((collFillMap & Collision) > 0 || (collFillMap & ReducedEventVtxCov) > 0);
   constexpr bool trackHasCov = ((fillMap & TrackCov) > 0 || (fillMap & ReducedTrackBarrelCov) > 0);
   constexpr bool muonHasCov = ((fillMap & MuonCov) > 0 || (fillMap & ReducedMuonCov) > 0);
+  if (!ctx) {
+    ctx = &fgDefaultContext;
+  }
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
   }
 
   float mtrack;
@@ -1947,8 +2068,8 @@ void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton
                            track.c1PtX(), track.c1PtY(), track.c1PtPhi(), track.c1PtTgl(), track.c1Pt21Pt2()};
     SMatrix55 t3covs(v3.begin(), v3.end());
     o2::track::TrackParCovFwd pars3{track.z(), t3pars, t3covs, chi23};
-    procCode = VarManager::fgFitterThreeProngFwd.process(pars1, pars2, pars3);
-    procCodeJpsi = VarManager::fgFitterTwoProngFwd.process(pars1, pars2);
+    procCode = ctx->fFitterThreeProngFwd.process(pars1, pars2, pars3);
+    procCodeJpsi = ctx->fFitterTwoProngFwd.process(pars1, pars2);
   } else if constexpr ((candidateType == kBtoJpsiEEK) && trackHasCov) {
     mlepton = o2::constants::physics::MassElectron;
     mtrack = o2::constants::physics::MassKaonCharged;
@@ -1967,8 +2088,8 @@ void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton
                                          track.cSnpSnp(), track.cTglY(), track.cTglZ(), track.cTglSnp(), track.cTglTgl(),
                                          track.c1PtY(), track.c1PtZ(), track.c1PtSnp(), track.c1PtTgl(), track.c1Pt21Pt2()};
     o2::track::TrackParCov pars3{track.x(), track.alpha(), lepton3pars, lepton3covs};
-    procCode = VarManager::fgFitterThreeProngBarrel.process(pars1, pars2, pars3);
-    procCodeJpsi = VarManager::fgFitterTwoProngBarrel.process(pars1, pars2);
+    procCode = ctx->fFitterThreeProngBarrel.process(pars1, pars2, pars3);
+    procCodeJpsi = ctx->fFitterTwoProngBarrel.process(pars1, pars2);
   } else {
     return;
   }
@@ -2018,11 +2139,11 @@ void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton
     auto covMatrixPV = primaryVertex.getCov();
 
     if constexpr (candidateType == kBtoJpsiEEK && trackHasCov) {
-      secondaryVertex = fgFitterThreeProngBarrel.getPCACandidate();
-      covMatrixPCA = fgFitterThreeProngBarrel.calcPCACovMatrixFlat();
+      secondaryVertex = ctx->fFitterThreeProngBarrel.getPCACandidate();
+      covMatrixPCA = ctx->fFitterThreeProngBarrel.calcPCACovMatrixFlat();
     } else if constexpr (candidateType == kBcToThreeMuons && muonHasCov) {
-      secondaryVertex = fgFitterThreeProngFwd.getPCACandidate();
-      covMatrixPCA = fgFitterThreeProngFwd.calcPCACovMatrixFlat();
+      secondaryVertex = ctx->fFitterThreeProngFwd.getPCACandidate();
+      covMatrixPCA = ctx->fFitterThreeProngFwd.calcPCACovMatrixFlat();
     }
 
     double phi = std::atan2(secondaryVertex[1] - collision.posY(), secondaryVertex[0] - collision.posX());
@@ -2056,10 +2177,13 @@ void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton
 }
 
 template <typename C, typename A>
-void VarManager::FillQVectorFromGFW(C const& collision, A const& compA2, A const& compB2, A const& compC2, A const& compA3, A const& compB3, A const& compC3, float normA, float normB, float normC, float* values)
+void VarManager::FillQVectorFromGFW(C const& collision, A const& compA2, A const& compB2, A const& compC2, A const& compA3, A const& compB3, A const& compC3, float normA, float normB, float normC, float* values, VarContext* ctx)
 {
+  if (!ctx) {
+    ctx = &fgDefaultContext;
+  }
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
   }
 
   // Fill Qn vectors from generic flow framework for different eta gap A, B, C (n=2,3)
@@ -2096,11 +2220,14 @@ void VarManager::FillQVectorFromGFW(C const& collision, A const& compA2, A const
 }
 
 template <int pairType, typename T1, typename T2>
-void VarManager::FillPairVn(T1 const& t1, T2 const& t2, float* values)
+void VarManager::FillPairVn(T1 const& t1, T2 const& t2, float* values, VarContext* ctx)
 {
 
+  if (!ctx) {
+    ctx = &fgDefaultContext;
+  }
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
   }
 
   float m1 = o2::constants::physics::MassElectron;
@@ -2131,7 +2258,7 @@ void VarManager::FillPairVn(T1 const& t1, T2 const& t2, float* values)
   values[kU3Q3] = values[kQ3X0A] * std::cos(3 * v12.Phi()) + values[kQ3Y0A] * std::sin(3 * v12.Phi());
   values[kCos2DeltaPhi] = std::cos(2 * (v12.Phi() - getEventPlane(2, values[kQ2X0A], values[kQ2Y0A])));
   values[kCos3DeltaPhi] = std::cos(3 * (v12.Phi() - getEventPlane(3, values[kQ3X0A], values[kQ3Y0A])));
-  if (isnan(VarManager::fgValues[VarManager::kU2Q2]) == true) {
+  if (isnan(values[kU2Q2]) == true) {
     values[kU2Q2] = -999.;
     values[kU3Q3] = -999.;
     values[kCos2DeltaPhi] = -999.;
@@ -2140,13 +2267,16 @@ void VarManager::FillPairVn(T1 const& t1, T2 const& t2, float* values)
 }
 
 template <typename T1, typename T2>
-void VarManager::FillDileptonHadron(T1 const& dilepton, T2 const& hadron, float* values, float hadronMass)
+void VarManager::FillDileptonHadron(T1 const& dilepton, T2 const& hadron, float* values, float hadronMass, VarContext* ctx)
 {
+  if (!ctx) {
+    ctx = &fgDefaultContext;
+  }
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
   }
 
-  if (fgUsedVars[kPairMass] || fgUsedVars[kPairPt] || fgUsedVars[kPairEta] || fgUsedVars[kPairPhi]) {
+  if (ctx->fUsedVars[kPairMass] || ctx->fUsedVars[kPairPt] || ctx->fUsedVars[kPairEta] || ctx->fUsedVars[kPairPhi]) {
     ROOT::Math::PtEtaPhiMVector v1(dilepton.pt(), dilepton.eta(), dilepton.phi(), dilepton.mass());
     ROOT::Math::PtEtaPhiMVector v2(hadron.pt(), hadron.eta(), hadron.phi(), hadronMass);
     ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
@@ -2157,7 +2287,7 @@ void VarManager::FillDileptonHadron(T1 const& dilepton, T2 const& hadron, float*
     values[kPairMassDau] = dilepton.mass();
     values[kMassDau] = hadronMass;
   }
-  if (fgUsedVars[kDeltaPhi]) {
+  if (ctx->fUsedVars[kDeltaPhi]) {
     double delta = dilepton.phi() - hadron.phi();
     if (delta > 3.0 / 2.0 * M_PI) {
       delta -= 2.0 * M_PI;
@@ -2167,23 +2297,26 @@ void VarManager::FillDileptonHadron(T1 const& dilepton, T2 const& hadron, float*
     }
     values[kDeltaPhi] = delta;
   }
-  if (fgUsedVars[kDeltaPhiSym]) {
+  if (ctx->fUsedVars[kDeltaPhiSym]) {
     double delta = std::abs(dilepton.phi() - hadron.phi());
     if (delta > M_PI) {
       delta = 2 * M_PI - delta;
     }
     values[kDeltaPhiSym] = delta;
   }
-  if (fgUsedVars[kDeltaEta]) {
+  if (ctx->fUsedVars[kDeltaEta]) {
     values[kDeltaEta] = dilepton.eta() - hadron.eta();
   }
 }
 
 template <typename T>
-void VarManager::FillHadron(T const& hadron, float* values, float hadronMass)
+void VarManager::FillHadron(T const& hadron, float* values, float hadronMass, VarContext* ctx)
 {
+  if (!ctx) {
+    ctx = &fgDefaultContext;
+  }
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
   }
 
   ROOT::Math::PtEtaPhiMVector vhadron(hadron.pt(), hadron.eta(), hadron.phi(), hadronMass);
@@ -2195,10 +2328,13 @@ void VarManager::FillHadron(T const& hadron, float* values, float hadronMass)
 }
 
 template <int partType, typename Cand, typename H>
-void VarManager::FillSingleDileptonCharmHadron(Cand const& candidate, H hfHelper, float* values)
+void VarManager::FillSingleDileptonCharmHadron(Cand const& candidate, H hfHelper, float* values, VarContext* ctx)
 {
+  if (!ctx) {
+    ctx = &fgDefaultContext;
+  }
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
   }
 
   if constexpr (partType == kJPsi) {
@@ -2222,10 +2358,10 @@ void VarManager::FillSingleDileptonCharmHadron(Cand const& candidate, H hfHelper
 }
 
 template <int partTypeCharmHad, typename DQ, typename HF, typename H>
-void VarManager::FillDileptonCharmHadron(DQ const& dilepton, HF const& charmHadron, H hfHelper, float* values)
+void VarManager::FillDileptonCharmHadron(DQ const& dilepton, HF const& charmHadron, H hfHelper, float* values, VarContext* ctx)
 {
-  FillSingleDileptonCharmHadron<kJPsi>(dilepton, hfHelper, values);
-  FillSingleDileptonCharmHadron<partTypeCharmHad>(charmHadron, hfHelper, values);
+  FillSingleDileptonCharmHadron<kJPsi>(dilepton, hfHelper, values, ctx);
+  FillSingleDileptonCharmHadron<partTypeCharmHad>(charmHadron, hfHelper, values, ctx);
 }
 
 #endif // PWGDQ_CORE_VARMANAGER_H_
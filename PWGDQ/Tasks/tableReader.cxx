@@ -31,6 +31,7 @@
 #include "PWGDQ/Core/MixingHandler.h"
 #include "PWGDQ/Core/AnalysisCut.h"
 #include "PWGDQ/Core/AnalysisCompositeCut.h"
+#include "PWGDQ/Core/AnalysisCutCompiler.h"
 #include "PWGDQ/Core/HistogramsLibrary.h"
 #include "PWGDQ/Core/CutsLibrary.h"
 #include "PWGDQ/Core/MixingLibrary.h"
@@ -214,11 +215,19 @@ struct AnalysisTrackSelection {
   Configurable<std::string> fConfigRunPeriods{"cfgRunPeriods", "LHC22f", "run periods for used data"};
   Configurable<bool> fConfigDummyRunlist{"cfgDummyRunlist", false, "If true, use dummy runlist"};
   Configurable<int> fConfigInitRunNumber{"cfgInitRunNumber", 543215, "Initial run number used in run by run checks"};
+  Configurable<bool> fConfigCompiledCuts{"cfgCompiledCuts", false, "If true, evaluate all the track cuts at once on the tracks of each event using the flattened cut program (not used if cfgQA is true)"};
+  Configurable<int> fConfigCutGridPoints{"cfgCutGridPoints", 1000, "Number of grid points used to tabulate function cut limits in the compiled cuts (0: evaluate the functions)"};
 
   Service<o2::ccdb::BasicCCDBManager> fCCDB;
 
   HistogramManager* fHistMan;
   std::vector<AnalysisCompositeCut> fTrackCuts;
+  int fHistClassBeforeCuts = -1;   // handle of the histogram class filled before the cuts
+  std::vector<int> fHistClassCuts; // handles of the histogram classes filled for each cut
+
+  bool fUseCompiledCuts = false;       // evaluate the cuts with the compiled program
+  AnalysisCutCompiler fCutCompiler;    // flattened program of all the track cuts
+  std::vector<uint64_t> fCutDecisions; // cut decisions for the tracks of the current event
 
   int fCurrentRun; // needed to detect if the run changed and trigger update of calibrations etc.
 
@@ -236,6 +245,14 @@ struct AnalysisTrackSelection {
 
     VarManager::SetUseVars(AnalysisCut::fgUsedVars); // provide the list of required variables so that VarManager knows what to fill
 
+    fUseCompiledCuts = fConfigCompiledCuts && !fConfigQA;
+    if (fUseCompiledCuts) {
+      fCutCompiler.SetNGridPoints(fConfigCutGridPoints);
+      for (auto& cut : fTrackCuts) {
+        fCutCompiler.AddCut(&cut);
+      }
+    }
+
     if (fConfigQA) {
       VarManager::SetDefaultVarNames();
       fHistMan = new HistogramManager("analysisHistos", "aa", VarManager::kNVars);
@@ -252,6 +269,12 @@ struct AnalysisTrackSelection {
       DefineHistograms(fHistMan, histDirNames.Data(), fConfigAddTrackHistogram); // define all histograms
       VarManager::SetUseVars(fHistMan->GetUsedVars());                           // provide the list of required variables so that VarManager knows what to fill
       fOutputList.setObject(fHistMan->GetMainHistogramList());
+
+      // resolve the histogram classes once, to avoid composing strings in the track loop
+      fHistClassBeforeCuts = fHistMan->GetHistClassHandle("TrackBarrel_BeforeCuts");
+      for (auto& cut : fTrackCuts) {
+        fHistClassCuts.push_back(fHistMan->GetHistClassHandle(Form("TrackBarrel_%s", cut.GetName())));
+      }
     }
     if (fConfigDummyRunlist) {
       VarManager::SetDummyRunlist(fConfigInitRunNumber);
@@ -295,12 +318,31 @@ struct AnalysisTrackSelection {
     bool prefilterSelected = false;
     int iCut = 0;
 
+    if (fUseCompiledCuts) {
+      // fill the variables for all the tracks of the event, then evaluate all the cuts in one go
+      fCutCompiler.ClearObjects();
+      for (auto& track : tracks) {
+        VarManager::FillTrack<TTrackFillMap>(track);
+        fCutCompiler.AddObject(VarManager::fgValues);
+      }
+      fCutDecisions.resize(tracks.size());
+      fCutCompiler.Evaluate(fCutDecisions.data());
+
+      uint64_t prefilterBit = (fConfigPrefilterCutId >= 0 && fConfigPrefilterCutId < AnalysisCutCompiler::kMaxNCuts) ? (uint64_t(1) << fConfigPrefilterCutId) : 0;
+      for (auto decision : fCutDecisions) {
+        filterMap = static_cast<uint32_t>(decision & ~prefilterBit);
+        prefilterSelected = (decision & prefilterBit) != 0;
+        trackSel(static_cast<int>(filterMap), static_cast<int>(prefilterSelected));
+      }
+      return;
+    }
+
     for (auto& track : tracks) {
       filterMap = 0;
       prefilterSelected = false;
       VarManager::FillTrack<TTrackFillMap>(track);
       if (fConfigQA) { // TODO: make this compile time
-        fHistMan->FillHistClass("TrackBarrel_BeforeCuts", VarManager::fgValues);
+        fHistMan->FillHistClass(fHistClassBeforeCuts, VarManager::fgValues);
       }
       iCut = 0;
       for (auto cut = fTrackCuts.begin(); cut != fTrackCuts.end(); cut++, iCut++) {
@@ -312,7 +354,7 @@ struct AnalysisTrackSelection {
             prefilterSelected = true;
           }
           if (fConfigQA) { // TODO: make this compile time
-            fHistMan->FillHistClass(Form("TrackBarrel_%s", (*cut).GetName()), VarManager::fgValues);
+            fHistMan->FillHistClass(fHistClassCuts[iCut], VarManager::fgValues);
           }
         }
       }
@@ -348,6 +390,8 @@ struct AnalysisMuonSelection {
 
   HistogramManager* fHistMan;
   std::vector<AnalysisCompositeCut> fMuonCuts;
+  int fHistClassBeforeCuts = -1;   // handle of the histogram class filled before the cuts
+  std::vector<int> fHistClassCuts; // handles of the histogram classes filled for each cut
 
   void init(o2::framework::InitContext&)
   {
@@ -375,6 +419,12 @@ struct AnalysisMuonSelection {
       DefineHistograms(fHistMan, histDirNames.Data(), fConfigAddMuonHistogram); // define all histograms
       VarManager::SetUseVars(fHistMan->GetUsedVars());                          // provide the list of required variables so that VarManager knows what to fill
       fOutputList.setObject(fHistMan->GetMainHistogramList());
+
+      // resolve the histogram classes once, to avoid composing strings in the muon loop
+      fHistClassBeforeCuts = fHistMan->GetHistClassHandle("TrackMuon_BeforeCuts");
+      for (auto& cut : fMuonCuts) {
+        fHistClassCuts.push_back(fHistMan->GetHistClassHandle(Form("TrackMuon_%s", cut.GetName())));
+      }
     }
   }
 
@@ -392,7 +442,7 @@ struct AnalysisMuonSelection {
       filterMap = 0;
       VarManager::FillTrack<TMuonFillMap>(muon);
       if (fConfigQA) { // TODO: make this compile time
-        fHistMan->FillHistClass("TrackMuon_BeforeCuts", VarManager::fgValues);
+        fHistMan->FillHistClass(fHistClassBeforeCuts, VarManager::fgValues);
       }
 
       iCut = 0;
@@ -400,7 +450,7 @@ struct AnalysisMuonSelection {
         if ((*cut).IsSelected(VarManager::fgValues)) {
           filterMap |= (uint32_t(1) << iCut);
           if (fConfigQA) { // TODO: make this compile time
-            fHistMan->FillHistClass(Form("TrackMuon_%s", (*cut).GetName()), VarManager::fgValues);
+            fHistMan->FillHistClass(fHistClassCuts[iCut], VarManager::fgValues);
           }
         }
       }
@@ -16,6 +16,8 @@
 
 #include <cstring>
 #include <iterator>
+#include <type_traits>
+#include <vector>
 
 #include "TString.h"
 #include "Math/Vector4D.h"
@@ -79,6 +81,8 @@ struct Pi0EtaToGammaGamma {
   Configurable<float> EMC_Eoverp{"EMC_Eoverp", 1.75, "Minimum cluster energy over track momentum for EMCal track matching"};
   Configurable<bool> EMC_UseExoticCut{"EMC_UseExoticCut", true, "FLag to use the EMCal exotic cluster cut"};
 
+  Configurable<bool> useCutBitmask{"useCutBitmask", false, "evaluate the photon cuts once per photon and fill all cut combinations from a single pair loop"};
+
   OutputObj<THashList> fOutputEvent{"Event"};
   OutputObj<THashList> fOutputPair{"Pair"}; // 2-photon pair
   THashList* fMainList = new THashList();
@@ -89,6 +93,24 @@ struct Pi0EtaToGammaGamma {
   std::vector<EMCPhotonCut> fEMCCuts;
   std::vector<PairCut> fPairCuts;
 
+  // histograms of one (cut1, cut2, paircut) combination, resolved once per data frame in the bitmask mode
+  struct PairHistograms {
+    TH2F* hMggPt_Same = nullptr;
+    TH2F* hMggPt_Mixed = nullptr;
+    TH2F* hMggPt_Same_RotatedBkg = nullptr;
+    TH2F* hdEtadPhi = nullptr;
+    TH2F* hdEtaPt = nullptr;
+    TH2F* hdPhiPt = nullptr;
+    TH2F* hEp_E = nullptr;
+  };
+  std::vector<PairHistograms> fPairHistograms; // flat index (icut1 * ncuts2 + icut2) * npaircuts + ipaircut
+  std::vector<int> fSelectedCombinations;      // indices in fPairHistograms of the combinations passed by the current pair
+  std::vector<uint64_t> fPhotonCutBits1;       // bit i is set if the photon passes the i-th cut of the first list, indexed by global index
+  std::vector<uint64_t> fPhotonCutBits2;       // same for the second list
+  int fNCuts1 = 0;
+  int fNCuts2 = 0;
+  int fNPairCuts = 0;
+
   std::vector<std::string> fPairNames;
   void init(InitContext& context)
   {
@@ -121,6 +143,13 @@ struct Pi0EtaToGammaGamma {
     DefinePairCuts();
     addhistograms();
 
+    if (useCutBitmask) {
+      const size_t maxNCuts = 8 * sizeof(uint64_t);
+      if (fPCMCuts.size() > maxNCuts || fDalitzEECuts.size() > maxNCuts || fPHOSCuts.size() > maxNCuts || fEMCCuts.size() > maxNCuts || fPairCuts.size() > maxNCuts) {
+        LOGF(fatal, "At most %d cuts per list are supported with useCutBitmask", static_cast<int>(maxNCuts));
+      }
+    }
+
     fOutputEvent.setObject(reinterpret_cast<THashList*>(fMainList->FindObject("Event")));
     fOutputPair.setObject(reinterpret_cast<THashList*>(fMainList->FindObject("Pair")));
   }
@@ -325,6 +354,207 @@ struct Pi0EtaToGammaGamma {
     return is_selected_pair;
   }
 
+  template <typename TPhoton, typename TCut>
+  bool IsSelectedPhoton(TPhoton const& g, TCut const& cut)
+  {
+    if constexpr (std::is_same_v<TCut, V0PhotonCut>) {
+      return cut.template IsSelected<aod::V0Legs>(g);
+    } else if constexpr (std::is_same_v<TCut, PHOSPhotonCut>) {
+      return cut.template IsSelected<int>(g); // dummy, because track matching is not ready.
+    } else if constexpr (std::is_same_v<TCut, EMCPhotonCut>) {
+      return cut.template IsSelected<aod::SkimEMCMTs>(g);
+    } else if constexpr (std::is_same_v<TCut, DalitzEECut>) {
+      return cut.template IsSelected<aod::EMPrimaryTracks>(g);
+    } else {
+      return true;
+    }
+  }
+
+  template <typename TPhotons, typename TCuts>
+  void EvaluatePhotonCuts(TPhotons const& photons, TCuts const& cuts, std::vector<uint64_t>& cutbits)
+  {
+    cutbits.clear();
+    for (auto& photon : photons) {
+      uint64_t bits = 0;
+      for (size_t icut = 0; icut < cuts.size(); icut++) {
+        if (IsSelectedPhoton(photon, cuts[icut])) {
+          bits |= (uint64_t(1) << icut);
+        }
+      }
+      if (static_cast<size_t>(photon.globalIndex()) >= cutbits.size()) {
+        cutbits.resize(photon.globalIndex() + 1, 0);
+      }
+      cutbits[photon.globalIndex()] = bits;
+    }
+  }
+
+  template <typename TG1, typename TG2, typename TPairCuts>
+  uint64_t EvaluatePairCuts(TG1 const& g1, TG2 const& g2, TPairCuts const& paircuts)
+  {
+    uint64_t bits = 0;
+    for (size_t ipaircut = 0; ipaircut < paircuts.size(); ipaircut++) {
+      if (paircuts[ipaircut].IsSelected(g1, g2)) {
+        bits |= (uint64_t(1) << ipaircut);
+      }
+    }
+    return bits;
+  }
+
+  /// \brief Evaluate all the photon cuts once per photon and resolve the pair histograms of every cut combination
+  template <PairType pairtype, typename TPhotons1, typename TPhotons2, typename TCuts1, typename TCuts2, typename TPairCuts>
+  void PreparePairing(TPhotons1 const& photons1, TPhotons2 const& photons2, TCuts1 const& cuts1, TCuts2 const& cuts2, TPairCuts const& paircuts)
+  {
+    if (!useCutBitmask) {
+      return;
+    }
+    EvaluatePhotonCuts(photons1, cuts1, fPhotonCutBits1);
+    if constexpr (!(pairtype == PairType::kPCMPCM || pairtype == PairType::kPHOSPHOS || pairtype == PairType::kEMCEMC)) {
+      EvaluatePhotonCuts(photons2, cuts2, fPhotonCutBits2);
+    }
+
+    THashList* list_pair_ss = static_cast<THashList*>(fMainList->FindObject("Pair")->FindObject(pairnames[pairtype].data()));
+    fNCuts1 = cuts1.size();
+    fNCuts2 = cuts2.size();
+    fNPairCuts = paircuts.size();
+    fPairHistograms.assign(cuts1.size() * cuts2.size() * paircuts.size(), PairHistograms());
+    for (size_t icut1 = 0; icut1 < cuts1.size(); icut1++) {
+      for (size_t icut2 = 0; icut2 < cuts2.size(); icut2++) {
+        THashList* list_pair_photoncut = static_cast<THashList*>(list_pair_ss->FindObject(Form("%s_%s", cuts1[icut1].GetName(), cuts2[icut2].GetName())));
+        if (!list_pair_photoncut) {
+          continue; // off-diagonal combinations of the same subsystem
+        }
+        for (size_t ipaircut = 0; ipaircut < paircuts.size(); ipaircut++) {
+          THashList* list_pair_paircut = static_cast<THashList*>(list_pair_photoncut->FindObject(paircuts[ipaircut].GetName()));
+          auto& hists = fPairHistograms[(icut1 * fNCuts2 + icut2) * fNPairCuts + ipaircut];
+          hists.hMggPt_Same = reinterpret_cast<TH2F*>(list_pair_paircut->FindObject("hMggPt_Same"));
+          hists.hMggPt_Mixed = reinterpret_cast<TH2F*>(list_pair_paircut->FindObject("hMggPt_Mixed"));
+          hists.hMggPt_Same_RotatedBkg = reinterpret_cast<TH2F*>(list_pair_paircut->FindObject("hMggPt_Same_RotatedBkg"));
+          hists.hdEtadPhi = reinterpret_cast<TH2F*>(list_pair_paircut->FindObject("hdEtadPhi"));
+          hists.hdEtaPt = reinterpret_cast<TH2F*>(list_pair_paircut->FindObject("hdEtaPt"));
+          hists.hdPhiPt = reinterpret_cast<TH2F*>(list_pair_paircut->FindObject("hdPhiPt"));
+          hists.hEp_E = reinterpret_cast<TH2F*>(list_pair_paircut->FindObject("hEp_E"));
+        }
+      }
+    }
+  }
+
+  /// \brief Collect the (cut1, cut2, paircut) combinations passed by a pair into fSelectedCombinations
+  template <PairType pairtype, typename TG1, typename TG2, typename TPairCuts>
+  bool SelectCombinations(TG1 const& g1, TG2 const& g2, TPairCuts const& paircuts)
+  {
+    fSelectedCombinations.clear();
+    constexpr bool isSameSubsystem = (pairtype == PairType::kPCMPCM || pairtype == PairType::kPHOSPHOS || pairtype == PairType::kEMCEMC);
+    const uint64_t cutbits1 = fPhotonCutBits1[g1.globalIndex()];
+    const uint64_t cutbits2 = isSameSubsystem ? fPhotonCutBits1[g2.globalIndex()] : fPhotonCutBits2[g2.globalIndex()];
+    if (!cutbits1 || !cutbits2) {
+      return false;
+    }
+    const uint64_t pairbits = EvaluatePairCuts(g1, g2, paircuts);
+    if (!pairbits) {
+      return false;
+    }
+    for (int icut1 = 0; icut1 < fNCuts1; icut1++) {
+      if (!((cutbits1 >> icut1) & 1)) {
+        continue;
+      }
+      for (int icut2 = 0; icut2 < fNCuts2; icut2++) {
+        if (!((cutbits2 >> icut2) & 1) || (isSameSubsystem && icut1 != icut2)) {
+          continue;
+        }
+        for (int ipaircut = 0; ipaircut < fNPairCuts; ipaircut++) {
+          if ((pairbits >> ipaircut) & 1) {
+            fSelectedCombinations.push_back((icut1 * fNCuts2 + icut2) * fNPairCuts + ipaircut);
+          }
+        }
+      }
+    }
+    return !fSelectedCombinations.empty();
+  }
+
+  /// \brief Same event pairing with the photon cuts evaluated once: every pair is built once and filled into all the cut combinations it passes
+  template <PairType pairtype, typename TPhotons1, typename TPhotons2, typename TCuts1, typename TPairCuts, typename TEMCMTs>
+  void SameEventPairingCutBits(TPhotons1 const& photons1_coll, TPhotons2 const& photons2_coll, TCuts1 const& cuts1, TPairCuts const& paircuts, TEMCMTs const& emcmatchedtracks)
+  {
+    if constexpr (pairtype == PairType::kPCMPCM || pairtype == PairType::kPHOSPHOS || pairtype == PairType::kEMCEMC) {
+      for (auto& [g1, g2] : combinations(CombinationsStrictlyUpperIndexPolicy(photons1_coll, photons2_coll))) {
+        if (!SelectCombinations<pairtype>(g1, g2, paircuts)) {
+          continue;
+        }
+
+        ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
+        ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
+        ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
+        if (abs(v12.Rapidity()) > maxY) {
+          continue;
+        }
+        for (auto& icomb : fSelectedCombinations) {
+          fPairHistograms[icomb].hMggPt_Same->Fill(v12.M(), v12.Pt());
+          if constexpr (pairtype == PairType::kEMCEMC) {
+            const int icut = icomb / (fNCuts2 * fNPairCuts);
+            RotationBackground<aod::SkimEMCClusters>(v12, v1, v2, photons2_coll, g1.globalIndex(), g2.globalIndex(), cuts1[icut], paircuts[icomb % fNPairCuts], emcmatchedtracks, icut, fPairHistograms[icomb].hMggPt_Same_RotatedBkg);
+          }
+        }
+      } // end of combination
+
+    } else { // different subsystem pairs
+      for (auto& [g1, g2] : combinations(CombinationsFullIndexPolicy(photons1_coll, photons2_coll))) {
+        if (!SelectCombinations<pairtype>(g1, g2, paircuts)) {
+          continue;
+        }
+
+        if constexpr (pairtype == PairType::kPCMPHOS || pairtype == PairType::kPCMEMC) {
+          auto pos = g1.template posTrack_as<aod::V0Legs>();
+          auto ele = g1.template negTrack_as<aod::V0Legs>();
+
+          for (auto& v0leg : {pos, ele}) {
+            float deta = v0leg.eta() - g2.eta();
+            float dphi = TVector2::Phi_mpi_pi(TVector2::Phi_0_2pi(v0leg.phi()) - TVector2::Phi_0_2pi(g2.phi()));
+            float Ep = g2.e() / v0leg.p();
+            bool isMatched = pow(deta / 0.02, 2) + pow(dphi / 0.4, 2) < 1;
+            for (auto& icomb : fSelectedCombinations) {
+              fPairHistograms[icomb].hdEtadPhi->Fill(dphi, deta);
+              fPairHistograms[icomb].hdEtaPt->Fill(v0leg.pt(), deta);
+              fPairHistograms[icomb].hdPhiPt->Fill(v0leg.pt(), dphi);
+              if (isMatched) {
+                fPairHistograms[icomb].hEp_E->Fill(g2.e(), Ep);
+              }
+            }
+          }
+
+          if constexpr (pairtype == PairType::kPCMPHOS) {
+            if (o2::aod::photonpair::DoesV0LegMatchWithCluster(pos, g2, 0.02, 0.4, 0.2) || o2::aod::photonpair::DoesV0LegMatchWithCluster(ele, g2, 0.02, 0.4, 0.2)) {
+              continue;
+            }
+          } else if constexpr (pairtype == PairType::kPCMEMC) {
+            if (o2::aod::photonpair::DoesV0LegMatchWithCluster(pos, g2, 0.02, 0.4, 0.5) || o2::aod::photonpair::DoesV0LegMatchWithCluster(ele, g2, 0.02, 0.4, 0.5)) {
+              continue;
+            }
+          }
+        }
+
+        ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
+        ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
+        if constexpr (pairtype == PairType::kPCMDalitz) {
+          v2.SetM(g2.mee());
+          auto pos_sv = g1.template posTrack_as<aod::V0Legs>();
+          auto ele_sv = g1.template negTrack_as<aod::V0Legs>();
+          auto pos_pv = g2.template posTrack_as<aod::EMPrimaryTracks>();
+          auto ele_pv = g2.template negTrack_as<aod::EMPrimaryTracks>();
+          if (pos_sv.trackId() == pos_pv.trackId() || ele_sv.trackId() == ele_pv.trackId()) {
+            continue;
+          }
+        }
+        ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
+        if (abs(v12.Rapidity()) > maxY) {
+          continue;
+        }
+        for (auto& icomb : fSelectedCombinations) {
+          fPairHistograms[icomb].hMggPt_Same->Fill(v12.M(), v12.Pt());
+        }
+      } // end of combination
+    }
+  }
+
   template <PairType pairtype, typename TEvents, typename TPhotons1, typename TPhotons2, typename TPreslice1, typename TPreslice2, typename TCuts1, typename TCuts2, typename TPairCuts, typename TLegs, typename TPrimaryTracks, typename TEMCMTs>
   void SameEventPairing(TEvents const& collisions, TPhotons1 const& photons1, TPhotons2 const& photons2, TPreslice1 const& perCollision1, TPreslice2 const& perCollision2, TCuts1 const& cuts1, TCuts2 const& cuts2, TPairCuts const& paircuts, TLegs const& legs, TPrimaryTracks const& primarytracks, TEMCMTs const& emcmatchedtracks)
   {
@@ -362,6 +592,11 @@ struct Pi0EtaToGammaGamma {
       auto photons1_coll = photons1.sliceBy(perCollision1, collision.globalIndex());
       auto photons2_coll = photons2.sliceBy(perCollision2, collision.globalIndex());
 
+      if (useCutBitmask) {
+        SameEventPairingCutBits<pairtype>(photons1_coll, photons2_coll, cuts1, paircuts, emcmatchedtracks);
+        continue;
+      }
+
       if constexpr (pairtype == PairType::kPCMPCM || pairtype == PairType::kPHOSPHOS || pairtype == PairType::kEMCEMC) {
         for (auto& cut : cuts1) {
           for (auto& paircut : paircuts) {
@@ -474,6 +709,27 @@ struct Pi0EtaToGammaGamma {
       // LOGF(info, "collision1: posZ = %f, numContrib = %d , sel8 = %d | collision2: posZ = %f, numContrib = %d , sel8 = %d",
       //     collision1.posZ(), collision1.numContrib(), collision1.sel8(), collision2.posZ(), collision2.numContrib(), collision2.sel8());
 
+      if (useCutBitmask) {
+        for (auto& [g1, g2] : combinations(soa::CombinationsFullIndexPolicy(photons_coll1, photons_coll2))) {
+          if (!SelectCombinations<pairtype>(g1, g2, paircuts)) {
+            continue;
+          }
+          ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
+          ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
+          if constexpr (pairtype == PairType::kPCMDalitz) {
+            v2.SetM(g2.mee());
+          }
+          ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
+          if (abs(v12.Rapidity()) > maxY) {
+            continue;
+          }
+          for (auto& icomb : fSelectedCombinations) {
+            fPairHistograms[icomb].hMggPt_Mixed->Fill(v12.M(), v12.Pt());
+          }
+        } // end of different photon combinations
+        continue;
+      }
+
       for (auto& cut1 : cuts1) {
         for (auto& cut2 : cuts2) {
           for (auto& paircut : paircuts) {
@@ -509,8 +765,9 @@ struct Pi0EtaToGammaGamma {
   }
 
   /// \brief Calculate background (using rotation background method only for EMCal!)
+  /// If icut >= 0, the photon selection is taken from the precomputed cut bits and the histogram is filled directly
   template <typename TPhotons>
-  void RotationBackground(const ROOT::Math::PtEtaPhiMVector& meson, ROOT::Math::PtEtaPhiMVector photon1, ROOT::Math::PtEtaPhiMVector photon2, TPhotons const& photons_coll, unsigned int ig1, unsigned int ig2, EMCPhotonCut const& cut, PairCut const& paircut, SkimEMCMTs const& emcmatchedtracks)
+  void RotationBackground(const ROOT::Math::PtEtaPhiMVector& meson, ROOT::Math::PtEtaPhiMVector photon1, ROOT::Math::PtEtaPhiMVector photon2, TPhotons const& photons_coll, unsigned int ig1, unsigned int ig2, EMCPhotonCut const& cut, PairCut const& paircut, SkimEMCMTs const& emcmatchedtracks, int icut = -1, TH2F* hRotatedBkg = nullptr)
   {
     // if less than 3 clusters are present skip event since we need at least 3 clusters
     if (photons_coll.size() < 3) {
@@ -538,7 +795,11 @@ struct Pi0EtaToGammaGamma {
         // only combine rotated photons with other photons
         continue;
       }
-      if (!cut.template IsSelected<aod::SkimEMCMTs>(photon)) {
+      if (icut >= 0) {
+        if (!((fPhotonCutBits1[photon.globalIndex()] >> icut) & 1)) {
+          continue;
+        }
+      } else if (!cut.template IsSelected<aod::SkimEMCMTs>(photon)) {
         continue;
       }
 
@@ -561,6 +822,15 @@ struct Pi0EtaToGammaGamma {
       // LOG(info) << "openingAngle2_2 = " << openingAngle2_2;
 
       // Fill histograms
+      if (hRotatedBkg) {
+        if (openingAngle1 > minOpenAngle) {
+          hRotatedBkg->Fill(mother1.M(), mother1.Pt());
+        }
+        if (openingAngle2 > minOpenAngle) {
+          hRotatedBkg->Fill(mother2.M(), mother2.Pt());
+        }
+        continue;
+      }
       if (openingAngle1 > minOpenAngle) {
         reinterpret_cast<TH2F*>(fMainList->FindObject("Pair")->FindObject("EMCEMC")->FindObject(Form("%s_%s", cut.GetName(), cut.GetName()))->FindObject(paircut.GetName())->FindObject("hMggPt_Same_RotatedBkg"))->Fill(mother1.M(), mother1.Pt());
       }
@@ -580,42 +850,49 @@ struct Pi0EtaToGammaGamma {
 
   void processPCMPCM(aod::EMReducedEvents const& collisions, MyFilteredCollisions const& filtered_collisions, MyV0Photons const& v0photons, aod::V0Legs const& legs)
   {
+    PreparePairing<PairType::kPCMPCM>(v0photons, v0photons, fPCMCuts, fPCMCuts, fPairCuts);
     SameEventPairing<PairType::kPCMPCM>(grouped_collisions, v0photons, v0photons, perCollision, perCollision, fPCMCuts, fPCMCuts, fPairCuts, legs, nullptr, nullptr);
     MixedEventPairing<PairType::kPCMPCM>(filtered_collisions, v0photons, v0photons, perCollision, perCollision, fPCMCuts, fPCMCuts, fPairCuts, legs, nullptr, nullptr);
   }
 
   void processPHOSPHOS(aod::EMReducedEvents const& collisions, MyFilteredCollisions const& filtered_collisions, aod::PHOSClusters const& phosclusters)
   {
+    PreparePairing<PairType::kPHOSPHOS>(phosclusters, phosclusters, fPHOSCuts, fPHOSCuts, fPairCuts);
     SameEventPairing<PairType::kPHOSPHOS>(grouped_collisions, phosclusters, phosclusters, perCollision_phos, perCollision_phos, fPHOSCuts, fPHOSCuts, fPairCuts, nullptr, nullptr, nullptr);
     MixedEventPairing<PairType::kPHOSPHOS>(filtered_collisions, phosclusters, phosclusters, perCollision_phos, perCollision_phos, fPHOSCuts, fPHOSCuts, fPairCuts, nullptr, nullptr, nullptr);
   }
 
   void processEMCEMC(aod::EMReducedEvents const& collisions, MyFilteredCollisions const& filtered_collisions, aod::SkimEMCClusters const& emcclusters, aod::SkimEMCMTs const& emcmatchedtracks)
   {
+    PreparePairing<PairType::kEMCEMC>(emcclusters, emcclusters, fEMCCuts, fEMCCuts, fPairCuts);
     SameEventPairing<PairType::kEMCEMC>(grouped_collisions, emcclusters, emcclusters, perCollision_emc, perCollision_emc, fEMCCuts, fEMCCuts, fPairCuts, nullptr, nullptr, emcmatchedtracks);
     MixedEventPairing<PairType::kEMCEMC>(filtered_collisions, emcclusters, emcclusters, perCollision_emc, perCollision_emc, fEMCCuts, fEMCCuts, fPairCuts, nullptr, nullptr, emcmatchedtracks);
   }
 
   void processPCMDalitz(aod::EMReducedEvents const& collisions, MyFilteredCollisions const& filtered_collisions, MyV0Photons const& v0photons, aod::V0Legs const& legs, MyFilteredDalitzEEs const& dileptons, aod::EMPrimaryTracks const& emprimarytracks)
   {
+    PreparePairing<PairType::kPCMDalitz>(v0photons, dileptons, fPCMCuts, fDalitzEECuts, fPairCuts);
     SameEventPairing<PairType::kPCMDalitz>(grouped_collisions, v0photons, dileptons, perCollision, perCollision_dalitz, fPCMCuts, fDalitzEECuts, fPairCuts, legs, emprimarytracks, nullptr);
     MixedEventPairing<PairType::kPCMDalitz>(filtered_collisions, v0photons, dileptons, perCollision, perCollision_dalitz, fPCMCuts, fDalitzEECuts, fPairCuts, legs, emprimarytracks, nullptr);
   }
 
   void processPCMPHOS(aod::EMReducedEvents const& collisions, MyFilteredCollisions const& filtered_collisions, MyV0Photons const& v0photons, aod::PHOSClusters const& phosclusters, aod::V0Legs const& legs)
   {
+    PreparePairing<PairType::kPCMPHOS>(v0photons, phosclusters, fPCMCuts, fPHOSCuts, fPairCuts);
     SameEventPairing<PairType::kPCMPHOS>(grouped_collisions, v0photons, phosclusters, perCollision, perCollision_phos, fPCMCuts, fPHOSCuts, fPairCuts, legs, nullptr, nullptr);
     MixedEventPairing<PairType::kPCMPHOS>(filtered_collisions, v0photons, phosclusters, perCollision, perCollision_phos, fPCMCuts, fPHOSCuts, fPairCuts, legs, nullptr, nullptr);
   }
 
   void processPCMEMC(aod::EMReducedEvents const& collisions, MyFilteredCollisions const& filtered_collisions, MyV0Photons const& v0photons, aod::SkimEMCClusters const& emcclusters, aod::V0Legs const& legs, aod::SkimEMCMTs const& emcmatchedtracks)
   {
+    PreparePairing<PairType::kPCMEMC>(v0photons, emcclusters, fPCMCuts, fEMCCuts, fPairCuts);
     SameEventPairing<PairType::kPCMEMC>(grouped_collisions, v0photons, emcclusters, perCollision, perCollision_emc, fPCMCuts, fEMCCuts, fPairCuts, legs, nullptr, emcmatchedtracks);
     MixedEventPairing<PairType::kPCMEMC>(filtered_collisions, v0photons, emcclusters, perCollision, perCollision_emc, fPCMCuts, fEMCCuts, fPairCuts, legs, nullptr, emcmatchedtracks);
   }
 
   void processPHOSEMC(aod::EMReducedEvents const& collisions, MyFilteredCollisions const& filtered_collisions, aod::PHOSClusters const& phosclusters, aod::SkimEMCClusters const& emcclusters, aod::SkimEMCMTs const& emcmatchedtracks)
   {
+    PreparePairing<PairType::kPHOSEMC>(phosclusters, emcclusters, fPHOSCuts, fEMCCuts, fPairCuts);
     SameEventPairing<PairType::kPHOSEMC>(grouped_collisions, phosclusters, emcclusters, perCollision_phos, perCollision_emc, fPHOSCuts, fEMCCuts, fPairCuts, nullptr, nullptr, emcmatchedtracks);
     MixedEventPairing<PairType::kPHOSEMC>(filtered_collisions, phosclusters, emcclusters, perCollision_phos, perCollision_emc, fPHOSCuts, fEMCCuts, fPairCuts, nullptr, nullptr, emcmatchedtracks);
   }
@@ -186,6 +186,61 @@ DECLARE_SOA_TABLE(HfPvRefitTrack, "AOD", "HFPVREFITTRACK", //!
                   hf_pv_refit_track::PvRefitDcaXY,
                   hf_pv_refit_track::PvRefitDcaZ);
 
+namespace hf_pid_status
+{
+/// Species of the PID statuses
+enum Species : uint8_t {
+  Pi = 0,
+  Ka,
+  Pr,
+  NSpecies
+};
+/// Combinations of PID detectors of the PID statuses
+enum Combination : uint8_t {
+  Tpc = 0,
+  Tof,
+  TpcOrTof,
+  TpcAndTof,
+  NCombinations
+};
+constexpr int NBitsStatus = 2; // TrackSelectorPID::Status
+
+DECLARE_SOA_COLUMN(PidStatus, pidStatus, uint32_t); //! TrackSelectorPID::Status of the track for each species and combination of detectors, 2 bits each
+
+/// Index of the first bit of a PID status in the packed word
+constexpr int bitPidStatus(int species, int combination)
+{
+  return NBitsStatus * (species * NCombinations + combination);
+}
+
+/// Stores a PID status in the packed word
+/// \param word is the packed word
+/// \param species is the species (hf_pid_status::Species)
+/// \param combination is the combination of detectors (hf_pid_status::Combination)
+/// \param status is the TrackSelectorPID::Status
+inline void setPidStatus(uint32_t& word, int species, int combination, int status)
+{
+  word |= static_cast<uint32_t>(status & ((1 << NBitsStatus) - 1)) << bitPidStatus(species, combination);
+}
+
+/// Reads a PID status from the packed word
+/// \return TrackSelectorPID::Status of the species with the combination of detectors
+inline int getPidStatus(uint32_t word, int species, int combination)
+{
+  return (word >> bitPidStatus(species, combination)) & ((1 << NBitsStatus) - 1);
+}
+
+/// Reads a PID status of a track joined with the HfPidStatusTrack table
+template <typename T>
+int getPidStatusTrack(const T& track, int species, int combination)
+{
+  return getPidStatus(track.pidStatus(), species, combination);
+}
+} // namespace hf_pid_status
+
+DECLARE_SOA_TABLE(HfPidStatusTrack, "AOD", "HFPIDSTATUSTRK", //! PID statuses of the tracks evaluated once per track, joinable with Tracks
+                  hf_pid_status::PidStatus);
+
 namespace hf_track_index
 {
 DECLARE_SOA_INDEX_COLUMN(Collision, collision);                   //! Collision index
@@ -350,6 +405,55 @@ DECLARE_SOA_TABLE(HfPvRefitDstar, "AOD", "HFPVREFITDSTAR", //!
                   hf_pv_refit::PvRefitSigmaZ2,
                   o2::soa::Marker<2>);
 
+namespace hf_fit_cache
+{
+DECLARE_SOA_COLUMN(FitterConfigHash, fitterConfigHash, uint32_t); //! hash of the DCAFitterN configuration of the skimming, 0 if the vertex cannot be reused
+DECLARE_SOA_COLUMN(XPca, xPca, float);                            //!
+DECLARE_SOA_COLUMN(YPca, yPca, float);                            //!
+DECLARE_SOA_COLUMN(ZPca, zPca, float);                            //!
+DECLARE_SOA_COLUMN(PcaSigmaX2, pcaSigmaX2, float);                //!
+DECLARE_SOA_COLUMN(PcaSigmaXY, pcaSigmaXY, float);                //!
+DECLARE_SOA_COLUMN(PcaSigmaY2, pcaSigmaY2, float);                //!
+DECLARE_SOA_COLUMN(PcaSigmaXZ, pcaSigmaXZ, float);                //!
+DECLARE_SOA_COLUMN(PcaSigmaYZ, pcaSigmaYZ, float);                //!
+DECLARE_SOA_COLUMN(PcaSigmaZ2, pcaSigmaZ2, float);                //!
+DECLARE_SOA_COLUMN(Chi2Pca, chi2Pca, float);                      //!
+DECLARE_SOA_COLUMN(XProng0AtPca, xProng0AtPca, float);            //! x of the first prong propagated to the PCA, in its tracking frame
+DECLARE_SOA_COLUMN(XProng1AtPca, xProng1AtPca, float);            //! x of the second prong propagated to the PCA, in its tracking frame
+DECLARE_SOA_COLUMN(XProng2AtPca, xProng2AtPca, float);            //! x of the third prong propagated to the PCA, in its tracking frame
+} // namespace hf_fit_cache
+
+DECLARE_SOA_TABLE(HfFitCache2Prong, "AOD", "HFFITCACHE2P", //! Secondary vertices of the 2-prong candidates fitted in the skimming
+                  hf_fit_cache::FitterConfigHash,
+                  hf_fit_cache::XPca,
+                  hf_fit_cache::YPca,
+                  hf_fit_cache::ZPca,
+                  hf_fit_cache::PcaSigmaX2,
+                  hf_fit_cache::PcaSigmaXY,
+                  hf_fit_cache::PcaSigmaY2,
+                  hf_fit_cache::PcaSigmaXZ,
+                  hf_fit_cache::PcaSigmaYZ,
+                  hf_fit_cache::PcaSigmaZ2,
+                  hf_fit_cache::Chi2Pca,
+                  hf_fit_cache::XProng0AtPca,
+                  hf_fit_cache::XProng1AtPca);
+
+DECLARE_SOA_TABLE(HfFitCache3Prong, "AOD", "HFFITCACHE3P", //! Secondary vertices of the 3-prong candidates fitted in the skimming
+                  hf_fit_cache::FitterConfigHash,
+                  hf_fit_cache::XPca,
+                  hf_fit_cache::YPca,
+                  hf_fit_cache::ZPca,
+                  hf_fit_cache::PcaSigmaX2,
+                  hf_fit_cache::PcaSigmaXY,
+                  hf_fit_cache::PcaSigmaY2,
+                  hf_fit_cache::PcaSigmaXZ,
+                  hf_fit_cache::PcaSigmaYZ,
+                  hf_fit_cache::PcaSigmaZ2,
+                  hf_fit_cache::Chi2Pca,
+                  hf_fit_cache::XProng0AtPca,
+                  hf_fit_cache::XProng1AtPca,
+                  hf_fit_cache::XProng2AtPca);
+
 // general decay properties
 namespace hf_cand
 {
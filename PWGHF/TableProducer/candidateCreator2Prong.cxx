@@ -37,6 +37,7 @@
 #include "Tools/KFparticle/KFUtilities.h"
 
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
+#include "PWGHF/Utils/utilsAnalysis.h"
 #include "PWGHF/Utils/utilsBfieldCCDB.h"
 
 using namespace o2;
@@ -93,7 +94,7 @@ struct HfCandidateCreator2Prong {
 
   void init(InitContext const&)
   {
-    std::array<bool, 2> doprocessDF{doprocessPvRefitWithDCAFitterN, doprocessNoPvRefitWithDCAFitterN};
+    std::array<bool, 4> doprocessDF{doprocessPvRefitWithDCAFitterN, doprocessNoPvRefitWithDCAFitterN, doprocessPvRefitWithDCAFitterNFitCache, doprocessNoPvRefitWithDCAFitterNFitCache};
     std::array<bool, 2> doprocessKF{doprocessPvRefitWithKFParticle, doprocessNoPvRefitWithKFParticle};
     if ((std::accumulate(doprocessDF.begin(), doprocessDF.end(), 0) + std::accumulate(doprocessKF.begin(), doprocessKF.end(), 0)) != 1) {
       LOGP(fatal, "Only one process function can be enabled at a time.");
@@ -114,7 +115,7 @@ struct HfCandidateCreator2Prong {
     runNumber = 0;
   }
 
-  template <bool doPvRefit, typename CandType, typename TTracks>
+  template <bool doPvRefit, bool useFitCache = false, typename CandType, typename TTracks>
   void runCreator2ProngWithDCAFitterN(aod::Collisions const& collisions,
                                       CandType const& rowsTrackIndexProng2,
                                       TTracks const& tracks,
@@ -130,6 +131,7 @@ struct HfCandidateCreator2Prong {
     df.setMinRelChi2Change(minRelChi2Change);
     df.setUseAbsDCA(useAbsDCA);
     df.setWeightedFinalPCA(useWeightedFinalPCA);
+    const uint32_t fitterConfigHash = getDcaFitterConfigHash(propagateToPCA, useAbsDCA, useWeightedFinalPCA, maxR, maxDZIni, minParamChange, minRelChi2Change);
 
     // loop over pairs of track indices
     for (const auto& rowTrackIndexProng2 : rowsTrackIndexProng2) {
@@ -153,19 +155,39 @@ struct HfCandidateCreator2Prong {
       }
       df.setBz(bz);
 
-      // reconstruct the 2-prong secondary vertex
-      if (df.process(trackParVarPos1, trackParVarNeg1) == 0) {
-        continue;
+      // reconstruct the 2-prong secondary vertex, or take it from the skimming if fitted there with the same configuration
+      std::array<double, 3> secondaryVertex;
+      std::array<float, 6> covMatrixPCA;
+      float chi2PCA;
+      auto trackParVar0 = trackParVarPos1;
+      auto trackParVar1 = trackParVarNeg1;
+      bool isFitCached = false;
+      if constexpr (useFitCache) {
+        if (rowTrackIndexProng2.fitterConfigHash() == fitterConfigHash) {
+          // prongs propagated to the PCA as in DCAFitterN
+          isFitCached = trackParVar0.propagateTo(rowTrackIndexProng2.xProng0AtPca(), bz) && trackParVar1.propagateTo(rowTrackIndexProng2.xProng1AtPca(), bz);
+        }
+        if (isFitCached) {
+          secondaryVertex = {rowTrackIndexProng2.xPca(), rowTrackIndexProng2.yPca(), rowTrackIndexProng2.zPca()};
+          covMatrixPCA = {rowTrackIndexProng2.pcaSigmaX2(), rowTrackIndexProng2.pcaSigmaXY(), rowTrackIndexProng2.pcaSigmaY2(), rowTrackIndexProng2.pcaSigmaXZ(), rowTrackIndexProng2.pcaSigmaYZ(), rowTrackIndexProng2.pcaSigmaZ2()};
+          chi2PCA = rowTrackIndexProng2.chi2Pca();
+        }
+      }
+      if (!isFitCached) {
+        if (df.process(trackParVarPos1, trackParVarNeg1) == 0) {
+          continue;
+        }
+        const auto& pca = df.getPCACandidate();
+        secondaryVertex = {pca[0], pca[1], pca[2]};
+        chi2PCA = df.getChi2AtPCACandidate();
+        covMatrixPCA = df.calcPCACovMatrixFlat();
+        trackParVar0 = df.getTrack(0);
+        trackParVar1 = df.getTrack(1);
       }
-      const auto& secondaryVertex = df.getPCACandidate();
-      auto chi2PCA = df.getChi2AtPCACandidate();
-      auto covMatrixPCA = df.calcPCACovMatrixFlat();
       hCovSVXX->Fill(covMatrixPCA[0]); // FIXME: Calculation of errorDecayLength(XY) gives wrong values without this line.
       hCovSVYY->Fill(covMatrixPCA[2]);
       hCovSVXZ->Fill(covMatrixPCA[3]);
       hCovSVZZ->Fill(covMatrixPCA[5]);
-      auto trackParVar0 = df.getTrack(0);
-      auto trackParVar1 = df.getTrack(1);
 
       // get track momenta
       std::array<float, 3> pvec0;
@@ -379,6 +401,26 @@ struct HfCandidateCreator2Prong {
 
   PROCESS_SWITCH(HfCandidateCreator2Prong, processNoPvRefitWithDCAFitterN, "Run candidate creator without PV refit", true);
 
+  void processPvRefitWithDCAFitterNFitCache(aod::Collisions const& collisions,
+                                            soa::Join<aod::Hf2Prongs, aod::HfPvRefit2Prong, aod::HfFitCache2Prong> const& rowsTrackIndexProng2,
+                                            aod::TracksWCov const& tracks,
+                                            aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator2ProngWithDCAFitterN<true, true>(collisions, rowsTrackIndexProng2, tracks, bcWithTimeStamps);
+  }
+
+  PROCESS_SWITCH(HfCandidateCreator2Prong, processPvRefitWithDCAFitterNFitCache, "Run candidate creator with PV refit, reusing the secondary vertices fitted in the skimming", false);
+
+  void processNoPvRefitWithDCAFitterNFitCache(aod::Collisions const& collisions,
+                                              soa::Join<aod::Hf2Prongs, aod::HfFitCache2Prong> const& rowsTrackIndexProng2,
+                                              aod::TracksWCov const& tracks,
+                                              aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator2ProngWithDCAFitterN<false, true>(collisions, rowsTrackIndexProng2, tracks, bcWithTimeStamps);
+  }
+
+  PROCESS_SWITCH(HfCandidateCreator2Prong, processNoPvRefitWithDCAFitterNFitCache, "Run candidate creator without PV refit, reusing the secondary vertices fitted in the skimming", false);
+
   void processPvRefitWithKFParticle(aod::Collisions const& collisions,
                                     soa::Join<aod::Hf2Prongs, aod::HfPvRefit2Prong> const& rowsTrackIndexProng2,
                                     soa::Join<aod::TracksWCov, aod::TracksExtra> const& tracks,
@@ -15,6 +15,8 @@
 ///
 /// \author Vít Kučera <vit.kucera@cern.ch>, CERN
 
+#include <numeric> // std::accumulate
+
 #include <TPDGCode.h>
 
 #include "DCAFitter/DCAFitterN.h"
@@ -25,6 +27,7 @@
 #include "Common/Core/trackUtilities.h"
 
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
+#include "PWGHF/Utils/utilsAnalysis.h"
 #include "PWGHF/Utils/utilsBfieldCCDB.h"
 
 using namespace o2;
@@ -77,8 +80,9 @@ struct HfCandidateCreator3Prong {
 
   void init(InitContext const&)
   {
-    if (doprocessPvRefit && doprocessNoPvRefit) {
-      LOGP(fatal, "Only one process function between processPvRefit and processNoPvRefit can be enabled at a time.");
+    std::array<bool, 4> doprocess{doprocessPvRefit, doprocessNoPvRefit, doprocessPvRefitFitCache, doprocessNoPvRefitFitCache};
+    if (std::accumulate(doprocess.begin(), doprocess.end(), 0) > 1) {
+      LOGP(fatal, "Only one process function can be enabled at a time.");
     }
 
     massPi = o2::analysis::pdg::MassPiPlus;
@@ -90,7 +94,7 @@ struct HfCandidateCreator3Prong {
     runNumber = 0;
   }
 
-  template <bool doPvRefit = false, typename Cand>
+  template <bool doPvRefit = false, bool useFitCache = false, typename Cand>
   void runCreator3Prong(aod::Collisions const& collisions,
                         Cand const& rowsTrackIndexProng3,
                         aod::TracksWCov const& tracks,
@@ -106,6 +110,7 @@ struct HfCandidateCreator3Prong {
     df.setMinRelChi2Change(minRelChi2Change);
     df.setUseAbsDCA(useAbsDCA);
     df.setWeightedFinalPCA(useWeightedFinalPCA);
+    const uint32_t fitterConfigHash = getDcaFitterConfigHash(propagateToPCA, useAbsDCA, useWeightedFinalPCA, maxR, maxDZIni, minParamChange, minRelChi2Change);
 
     // loop over triplets of track indices
     for (const auto& rowTrackIndexProng3 : rowsTrackIndexProng3) {
@@ -131,20 +136,44 @@ struct HfCandidateCreator3Prong {
       }
       df.setBz(bz);
 
-      // reconstruct the 3-prong secondary vertex
-      if (df.process(trackParVar0, trackParVar1, trackParVar2) == 0) {
-        continue;
+      // reconstruct the 3-prong secondary vertex, or take it from the skimming if fitted there with the same configuration
+      std::array<double, 3> secondaryVertex;
+      std::array<float, 6> covMatrixPCA;
+      float chi2PCA;
+      bool isFitCached = false;
+      if constexpr (useFitCache) {
+        if (rowTrackIndexProng3.fitterConfigHash() == fitterConfigHash) {
+          // prongs propagated to the PCA as in DCAFitterN
+          auto trackParVarPca0 = trackParVar0;
+          auto trackParVarPca1 = trackParVar1;
+          auto trackParVarPca2 = trackParVar2;
+          isFitCached = trackParVarPca0.propagateTo(rowTrackIndexProng3.xProng0AtPca(), bz) && trackParVarPca1.propagateTo(rowTrackIndexProng3.xProng1AtPca(), bz) && trackParVarPca2.propagateTo(rowTrackIndexProng3.xProng2AtPca(), bz);
+          if (isFitCached) {
+            secondaryVertex = {rowTrackIndexProng3.xPca(), rowTrackIndexProng3.yPca(), rowTrackIndexProng3.zPca()};
+            covMatrixPCA = {rowTrackIndexProng3.pcaSigmaX2(), rowTrackIndexProng3.pcaSigmaXY(), rowTrackIndexProng3.pcaSigmaY2(), rowTrackIndexProng3.pcaSigmaXZ(), rowTrackIndexProng3.pcaSigmaYZ(), rowTrackIndexProng3.pcaSigmaZ2()};
+            chi2PCA = rowTrackIndexProng3.chi2Pca();
+            trackParVar0 = trackParVarPca0;
+            trackParVar1 = trackParVarPca1;
+            trackParVar2 = trackParVarPca2;
+          }
+        }
+      }
+      if (!isFitCached) {
+        if (df.process(trackParVar0, trackParVar1, trackParVar2) == 0) {
+          continue;
+        }
+        const auto& pca = df.getPCACandidate();
+        secondaryVertex = {pca[0], pca[1], pca[2]};
+        chi2PCA = df.getChi2AtPCACandidate();
+        covMatrixPCA = df.calcPCACovMatrixFlat();
+        trackParVar0 = df.getTrack(0);
+        trackParVar1 = df.getTrack(1);
+        trackParVar2 = df.getTrack(2);
       }
-      const auto& secondaryVertex = df.getPCACandidate();
-      auto chi2PCA = df.getChi2AtPCACandidate();
-      auto covMatrixPCA = df.calcPCACovMatrixFlat();
       hCovSVXX->Fill(covMatrixPCA[0]); // FIXME: Calculation of errorDecayLength(XY) gives wrong values without this line.
       hCovSVYY->Fill(covMatrixPCA[2]);
       hCovSVXZ->Fill(covMatrixPCA[3]);
       hCovSVZZ->Fill(covMatrixPCA[5]);
-      trackParVar0 = df.getTrack(0);
-      trackParVar1 = df.getTrack(1);
-      trackParVar2 = df.getTrack(2);
 
       // get track momenta
       std::array<float, 3> pvec0;
@@ -240,6 +269,26 @@ struct HfCandidateCreator3Prong {
   }
 
   PROCESS_SWITCH(HfCandidateCreator3Prong, processNoPvRefit, "Run candidate creator without PV refit", true);
+
+  void processPvRefitFitCache(aod::Collisions const& collisions,
+                              soa::Join<aod::Hf3Prongs, aod::HfPvRefit3Prong, aod::HfFitCache3Prong> const& rowsTrackIndexProng3,
+                              aod::TracksWCov const& tracks,
+                              aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator3Prong<true, true>(collisions, rowsTrackIndexProng3, tracks, bcWithTimeStamps);
+  }
+
+  PROCESS_SWITCH(HfCandidateCreator3Prong, processPvRefitFitCache, "Run candidate creator with PV refit, reusing the secondary vertices fitted in the skimming", false);
+
+  void processNoPvRefitFitCache(aod::Collisions const& collisions,
+                                soa::Join<aod::Hf3Prongs, aod::HfFitCache3Prong> const& rowsTrackIndexProng3,
+                                aod::TracksWCov const& tracks,
+                                aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator3Prong<false, true>(collisions, rowsTrackIndexProng3, tracks, bcWithTimeStamps);
+  }
+
+  PROCESS_SWITCH(HfCandidateCreator3Prong, processNoPvRefitFitCache, "Run candidate creator without PV refit, reusing the secondary vertices fitted in the skimming", false);
 };
 
 /// Extends the base table with expression columns.
@@ -76,6 +76,7 @@ struct HfCandidateSelectorD0 {
   HfHelper hfHelper;
 
   using TracksSel = soa::Join<aod::TracksWDcaExtra, aod::TracksPidPi, aod::TracksPidKa>;
+  using TracksSelWithPidStatus = soa::Join<aod::TracksWDcaExtra, aod::HfPidStatusTrack>;
 
   // Define histograms
   AxisSpec axisMassDmeson{200, 1.7f, 2.1f};
@@ -85,7 +86,7 @@ struct HfCandidateSelectorD0 {
 
   void init(InitContext& initContext)
   {
-    std::array<bool, 2> doprocess{doprocessWithDCAFitterN, doprocessWithKFParticle};
+    std::array<bool, 4> doprocess{doprocessWithDCAFitterN, doprocessWithKFParticle, doprocessWithDCAFitterNPidStatus, doprocessWithKFParticlePidStatus};
     if ((std::accumulate(doprocess.begin(), doprocess.end(), 0)) != 1) {
       LOGP(fatal, "Only one process function can be enabled at a time.");
     }
@@ -245,9 +246,10 @@ struct HfCandidateSelectorD0 {
 
     return true;
   }
-  template <int reconstructionType, typename CandType>
+  /// \tparam usePidStatus reads the PID statuses of the prongs from the HfPidStatusTrack table instead of evaluating them
+  template <int reconstructionType, bool usePidStatus, typename TTracks, typename CandType>
   void processSel(CandType const& candidates,
-                  TracksSel const&)
+                  TTracks const&)
   {
     // looping over 2-prong candidates
     for (const auto& candidate : candidates) {
@@ -270,8 +272,8 @@ struct HfCandidateSelectorD0 {
       statusHFFlag = 1;
 
       auto ptCand = candidate.pt();
-      auto trackPos = candidate.template prong0_as<TracksSel>(); // positive daughter
-      auto trackNeg = candidate.template prong1_as<TracksSel>(); // negative daughter
+      auto trackPos = candidate.template prong0_as<TTracks>(); // positive daughter
+      auto trackNeg = candidate.template prong1_as<TTracks>(); // negative daughter
 
       // conjugate-independent topological selection
       if (!selectionTopol<reconstructionType>(candidate)) {
@@ -306,7 +308,14 @@ struct HfCandidateSelectorD0 {
       int pidTrackNegKaon = -1;
       int pidTrackNegPion = -1;
 
-      if (usePidTpcAndTof) {
+      if constexpr (usePidStatus) {
+        // statuses evaluated once per track by the PID status creator
+        int combination = usePidTpcAndTof ? aod::hf_pid_status::TpcAndTof : aod::hf_pid_status::TpcOrTof;
+        pidTrackPosKaon = aod::hf_pid_status::getPidStatusTrack(trackPos, aod::hf_pid_status::Ka, combination);
+        pidTrackPosPion = aod::hf_pid_status::getPidStatusTrack(trackPos, aod::hf_pid_status::Pi, combination);
+        pidTrackNegKaon = aod::hf_pid_status::getPidStatusTrack(trackNeg, aod::hf_pid_status::Ka, combination);
+        pidTrackNegPion = aod::hf_pid_status::getPidStatusTrack(trackNeg, aod::hf_pid_status::Pi, combination);
+      } else if (usePidTpcAndTof) {
         pidTrackPosKaon = selectorKaon.statusTpcAndTof(trackPos);
         pidTrackPosPion = selectorPion.statusTpcAndTof(trackPos);
         pidTrackNegKaon = selectorKaon.statusTpcAndTof(trackNeg);
@@ -394,15 +403,27 @@ struct HfCandidateSelectorD0 {
 
   void processWithDCAFitterN(aod::HfCand2Prong const& candidates, TracksSel const& tracks)
   {
-    processSel<aod::hf_cand::VertexerType::DCAFitter>(candidates, tracks);
+    processSel<aod::hf_cand::VertexerType::DCAFitter, false>(candidates, tracks);
   }
   PROCESS_SWITCH(HfCandidateSelectorD0, processWithDCAFitterN, "process candidates selection with DCAFitterN", true);
 
+  void processWithDCAFitterNPidStatus(aod::HfCand2Prong const& candidates, TracksSelWithPidStatus const& tracks)
+  {
+    processSel<aod::hf_cand::VertexerType::DCAFitter, true>(candidates, tracks);
+  }
+  PROCESS_SWITCH(HfCandidateSelectorD0, processWithDCAFitterNPidStatus, "process candidates selection with DCAFitterN and PID statuses from the track PID status table", false);
+
   void processWithKFParticle(soa::Join<aod::HfCand2Prong, aod::HfCand2ProngKF> const& candidates, TracksSel const& tracks)
   {
-    processSel<aod::hf_cand::VertexerType::KfParticle>(candidates, tracks);
+    processSel<aod::hf_cand::VertexerType::KfParticle, false>(candidates, tracks);
   }
   PROCESS_SWITCH(HfCandidateSelectorD0, processWithKFParticle, "process candidates selection with KFParticle", false);
+
+  void processWithKFParticlePidStatus(soa::Join<aod::HfCand2Prong, aod::HfCand2ProngKF> const& candidates, TracksSelWithPidStatus const& tracks)
+  {
+    processSel<aod::hf_cand::VertexerType::KfParticle, true>(candidates, tracks);
+  }
+  PROCESS_SWITCH(HfCandidateSelectorD0, processWithKFParticlePidStatus, "process candidates selection with KFParticle and PID statuses from the track PID status table", false);
 };
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
@@ -66,6 +66,7 @@ struct HfCandidateSelectorDplusToPiKPi {
   Configurable<LabeledArray<double>> cutsMl{"cutsMl", {hf_cuts_ml::cuts[0], hf_cuts_ml::nBinsPt, hf_cuts_ml::nCutScores, hf_cuts_ml::labelsPt, hf_cuts_ml::labelsCutScore}, "ML selections per pT bin"};
   Configurable<int8_t> nClassesMl{"nClassesMl", (int8_t)hf_cuts_ml::nCutScores, "Number of classes in ML model"};
   Configurable<std::vector<std::string>> namesInputFeatures{"namesInputFeatures", std::vector<std::string>{"feature1", "feature2"}, "Names of ML model input features"};
+  Configurable<int> batchSizeMl{"batchSizeMl", 0, "Maximum number of candidates evaluated in one ML inference (0: all the candidates of a pT bin at once)"};
   // CCDB configuration
   Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
   Configurable<std::string> modelPathsCCDB{"modelPathsCCDB", "EventFiltering/PWGHF/BDTD0", "Path on CCDB"};
@@ -76,17 +77,24 @@ struct HfCandidateSelectorDplusToPiKPi {
   o2::analysis::HfMlResponseDplusToPiKPi<float> hfMlResponse;
   std::vector<float> outputMlNotPreselected = {};
   std::vector<float> outputMl = {};
+  std::vector<int> statusCandidates = {}; // selection status of the candidates before the ML selection
+  std::vector<int> indicesBatchMl = {};   // index of the candidates in the ML batch (-1 if not preselected)
   o2::ccdb::CcdbApi ccdbApi;
   TrackSelectorPi selectorPion;
   TrackSelectorKa selectorKaon;
   HfHelper hfHelper;
 
   using TracksSel = soa::Join<aod::TracksWExtra, aod::TracksPidPiExt, aod::TracksPidKaExt>;
+  using TracksSelWithPidStatus = soa::Join<aod::TracksWExtra, aod::TracksPidPiExt, aod::TracksPidKaExt, aod::HfPidStatusTrack>;
 
   HistogramRegistry registry{"registry"};
 
   void init(InitContext const&)
   {
+    if (doprocessWithTrackSelectorPid == doprocessWithPidStatus) {
+      LOGP(fatal, "One and only one process function can be enabled at a time.");
+    }
+
     selectorPion.setRangePtTpc(ptPidTpcMin, ptPidTpcMax);
     selectorPion.setRangeNSigmaTpc(-nSigmaTpcMax, nSigmaTpcMax);
     selectorPion.setRangeNSigmaTpcCondTof(-nSigmaTpcCombinedMax, nSigmaTpcCombinedMax);
@@ -120,6 +128,7 @@ struct HfCandidateSelectorDplusToPiKPi {
         hfMlResponse.setModelPathsLocal(onnxFileNames);
       }
       hfMlResponse.cacheInputFeaturesIndices(namesInputFeatures);
+      hfMlResponse.setBatchChunkSize(batchSizeMl);
       hfMlResponse.init();
     }
   }
@@ -192,85 +201,137 @@ struct HfCandidateSelectorDplusToPiKPi {
     return true;
   }
 
-  void process(aod::HfCand3Prong const& candidates,
-               TracksSel const&)
+  /// Skim, topological and PID selections of a candidate, the ML input features are added to the ML batch
+  /// \tparam usePidStatus reads the PID statuses of the prongs from the HfPidStatusTrack table instead of evaluating them
+  /// \param candidate is the D+ candidate
+  /// \param indexBatchMl is set to the index of the candidate in the ML batch (-1 if it does not reach the ML selection)
+  /// \return selection status of the candidate before the ML selection
+  template <bool usePidStatus, typename TTracks, typename T>
+  int preselectCandidate(const T& candidate, int& indexBatchMl)
   {
-    // looping over 3-prong candidates
-    for (const auto& candidate : candidates) {
+    // final selection flag:
+    auto statusDplusToPiKPi = 0;
+    indexBatchMl = -1;
 
-      // final selection flag:
-      auto statusDplusToPiKPi = 0;
+    auto ptCand = candidate.pt();
 
-      auto ptCand = candidate.pt();
-
-      if (!TESTBIT(candidate.hfflag(), aod::hf_cand_3prong::DecayType::DplusToPiKPi)) {
-        hfSelDplusToPiKPiCandidate(statusDplusToPiKPi);
-        if (applyMl) {
-          hfMlDplusToPiKPiCandidate(outputMlNotPreselected);
-        }
-        if (activateQA) {
-          registry.fill(HIST("hSelections"), 1, ptCand);
-        }
-        continue;
-      }
-      SETBIT(statusDplusToPiKPi, aod::SelectionStep::RecoSkims);
+    if (!TESTBIT(candidate.hfflag(), aod::hf_cand_3prong::DecayType::DplusToPiKPi)) {
       if (activateQA) {
-        registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoSkims, ptCand);
+        registry.fill(HIST("hSelections"), 1, ptCand);
       }
+      return statusDplusToPiKPi;
+    }
+    SETBIT(statusDplusToPiKPi, aod::SelectionStep::RecoSkims);
+    if (activateQA) {
+      registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoSkims, ptCand);
+    }
 
-      auto trackPos1 = candidate.prong0_as<TracksSel>(); // positive daughter (negative for the antiparticles)
-      auto trackNeg = candidate.prong1_as<TracksSel>();  // negative daughter (positive for the antiparticles)
-      auto trackPos2 = candidate.prong2_as<TracksSel>(); // positive daughter (negative for the antiparticles)
+    auto trackPos1 = candidate.template prong0_as<TTracks>(); // positive daughter (negative for the antiparticles)
+    auto trackNeg = candidate.template prong1_as<TTracks>();  // negative daughter (positive for the antiparticles)
+    auto trackPos2 = candidate.template prong2_as<TTracks>(); // positive daughter (negative for the antiparticles)
 
-      // topological selection
-      if (!selection(candidate, trackPos1, trackNeg, trackPos2)) {
-        hfSelDplusToPiKPiCandidate(statusDplusToPiKPi);
-        if (applyMl) {
-          hfMlDplusToPiKPiCandidate(outputMlNotPreselected);
-        }
-        continue;
-      }
-      SETBIT(statusDplusToPiKPi, aod::SelectionStep::RecoTopol);
-      if (activateQA) {
-        registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoTopol, ptCand);
-      }
+    // topological selection
+    if (!selection(candidate, trackPos1, trackNeg, trackPos2)) {
+      return statusDplusToPiKPi;
+    }
+    SETBIT(statusDplusToPiKPi, aod::SelectionStep::RecoTopol);
+    if (activateQA) {
+      registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoTopol, ptCand);
+    }
 
-      // track-level PID selection
-      int pidTrackPos1Pion = selectorPion.statusTpcAndTof(trackPos1);
-      int pidTrackNegKaon = selectorKaon.statusTpcAndTof(trackNeg);
-      int pidTrackPos2Pion = selectorPion.statusTpcAndTof(trackPos2);
+    // track-level PID selection
+    int pidTrackPos1Pion = TrackSelectorPID::NotApplicable;
+    int pidTrackNegKaon = TrackSelectorPID::NotApplicable;
+    int pidTrackPos2Pion = TrackSelectorPID::NotApplicable;
+    if constexpr (usePidStatus) {
+      // statuses evaluated once per track by the PID status creator
+      pidTrackPos1Pion = aod::hf_pid_status::getPidStatusTrack(trackPos1, aod::hf_pid_status::Pi, aod::hf_pid_status::TpcAndTof);
+      pidTrackNegKaon = aod::hf_pid_status::getPidStatusTrack(trackNeg, aod::hf_pid_status::Ka, aod::hf_pid_status::TpcAndTof);
+      pidTrackPos2Pion = aod::hf_pid_status::getPidStatusTrack(trackPos2, aod::hf_pid_status::Pi, aod::hf_pid_status::TpcAndTof);
+    } else {
+      pidTrackPos1Pion = selectorPion.statusTpcAndTof(trackPos1);
+      pidTrackNegKaon = selectorKaon.statusTpcAndTof(trackNeg);
+      pidTrackPos2Pion = selectorPion.statusTpcAndTof(trackPos2);
+    }
 
-      if (!selectionPID(pidTrackPos1Pion, pidTrackNegKaon, pidTrackPos2Pion)) { // exclude D±
-        hfSelDplusToPiKPiCandidate(statusDplusToPiKPi);
-        if (applyMl) {
-          hfMlDplusToPiKPiCandidate(outputMlNotPreselected);
-        }
-        continue;
-      }
-      SETBIT(statusDplusToPiKPi, aod::SelectionStep::RecoPID);
-      if (activateQA) {
-        registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoPID, ptCand);
-      }
+    if (!selectionPID(pidTrackPos1Pion, pidTrackNegKaon, pidTrackPos2Pion)) { // exclude D±
+      return statusDplusToPiKPi;
+    }
+    SETBIT(statusDplusToPiKPi, aod::SelectionStep::RecoPID);
+    if (activateQA) {
+      registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoPID, ptCand);
+    }
+
+    if (applyMl) {
+      // ML input features, the models are evaluated for all the candidates at once
+      std::vector<float> inputFeatures = hfMlResponse.getInputFeatures(candidate, trackPos1, trackNeg, trackPos2);
+      indexBatchMl = hfMlResponse.addToBatch(inputFeatures, ptCand);
+    }
+    return statusDplusToPiKPi;
+  }
+
+  template <bool usePidStatus, typename TTracks>
+  void runSelection(aod::HfCand3Prong const& candidates,
+                    TTracks const&)
+  {
+    statusCandidates.clear();
+    indicesBatchMl.clear();
+    if (applyMl) {
+      hfMlResponse.clearBatch();
+    }
+
+    // looping over 3-prong candidates
+    for (const auto& candidate : candidates) {
+      int indexBatchMl{-1};
+      statusCandidates.push_back(preselectCandidate<usePidStatus, TTracks>(candidate, indexBatchMl));
+      indicesBatchMl.push_back(indexBatchMl);
+    }
+
+    // ML selections, one inference per model
+    if (applyMl) {
+      hfMlResponse.evaluateBatch();
+    }
+
+    // filling the tables in the order of the candidates
+    int iCandidate{0};
+    for (const auto& candidate : candidates) {
+      auto statusDplusToPiKPi = statusCandidates[iCandidate];
+      const auto indexBatchMl = indicesBatchMl[iCandidate];
+      ++iCandidate;
 
       if (applyMl) {
-        // ML selections
-        std::vector<float> inputFeatures = hfMlResponse.getInputFeatures(candidate, trackPos1, trackNeg, trackPos2);
-        bool isSelectedMl = hfMlResponse.isSelectedMl(inputFeatures, ptCand, outputMl);
-        hfMlDplusToPiKPiCandidate(outputMl);
-
-        if (!isSelectedMl) {
-          hfSelDplusToPiKPiCandidate(statusDplusToPiKPi);
-          continue;
-        }
-        SETBIT(statusDplusToPiKPi, aod::SelectionStep::RecoMl);
-        if (activateQA) {
-          registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoMl, ptCand);
+        if (indexBatchMl < 0) {
+          hfMlDplusToPiKPiCandidate(outputMlNotPreselected);
+        } else {
+          auto scores = hfMlResponse.getBatchOutputs(indexBatchMl);
+          outputMl.assign(scores.begin(), scores.end());
+          hfMlDplusToPiKPiCandidate(outputMl);
+          if (hfMlResponse.getBatchSelected()[indexBatchMl]) {
+            SETBIT(statusDplusToPiKPi, aod::SelectionStep::RecoMl);
+            if (activateQA) {
+              registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoMl, candidate.pt());
+            }
+          }
         }
       }
 
       hfSelDplusToPiKPiCandidate(statusDplusToPiKPi);
     }
   }
+
+  void processWithTrackSelectorPid(aod::HfCand3Prong const& candidates,
+                                   TracksSel const& tracks)
+  {
+    runSelection<false>(candidates, tracks);
+  }
+  PROCESS_SWITCH(HfCandidateSelectorDplusToPiKPi, processWithTrackSelectorPid, "process candidates selection with the PID statuses evaluated for each prong", true);
+
+  void processWithPidStatus(aod::HfCand3Prong const& candidates,
+                            TracksSelWithPidStatus const& tracks)
+  {
+    runSelection<true>(candidates, tracks);
+  }
+  PROCESS_SWITCH(HfCandidateSelectorDplusToPiKPi, processWithPidStatus, "process candidates selection with the PID statuses from the track PID status table", false);
 };
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
@@ -20,10 +20,14 @@
 /// \author Fabrizio Grosa <fgrosa@cern.ch>, CERN
 
 #include <algorithm> // std::find
+#include <cmath>     // std::sqrt
 #include <iterator>  // std::distance
+#include <limits>    // std::numeric_limits
 #include <string>    // std::string
 #include <vector>    // std::vector
 
+#include "Math/SMatrix.h"                      // for incremental PV refit
+#include "Math/SVector.h"                      // for incremental PV refit
 #include "CCDB/BasicCCDBManager.h"             // for PV refit
 #include "DataFormatsParameters/GRPMagField.h" // for PV refit
 #include "DataFormatsParameters/GRPObject.h"   // for PV refit
@@ -74,6 +78,16 @@ enum EventRejection {
   NEventRejection
 };
 
+// PV refit methods
+enum PvRefitMethod {
+  FullRefit = 0,          // full vertex fit without the track
+  IncrementalRefit,       // contribution of the track removed from the linearised fit of all the contributors
+  IncrementalRefitChecked // incremental refit compared with the full one, which is used in output
+};
+
+using SMatrix33Sym = ROOT::Math::SMatrix<double, 3, 3, ROOT::Math::MatRepSym<double, 3>>;
+using SVector3 = ROOT::Math::SVector<double, 3>;
+
 // #define MY_DEBUG
 
 #ifdef MY_DEBUG
@@ -259,6 +273,8 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
   Configurable<bool> doPvRefit{"doPvRefit", false, "do PV refit excluding the considered track"};
   Configurable<bool> fillHistograms{"fillHistograms", true, "fill histograms"};
   Configurable<bool> debugPvRefit{"debugPvRefit", false, "debug lines for primary vertex refit"};
+  Configurable<int> pvRefitMethod{"pvRefitMethod", 0, "PV refit method: 0 full refit for each track, 1 incremental refit from the fit of all the contributors, 2 incremental refit checked against the full one"};
+  Configurable<int> pvRefitIncrementalNContribMin{"pvRefitIncrementalNContribMin", 3, "min. number of PV contributors left for the incremental PV refit, otherwise the full refit is done"};
   // Configurable<double> bz{"bz", 5., "bz field"};
   // quality cut
   Configurable<bool> doCutQuality{"doCutQuality", true, "apply quality cuts"};
@@ -309,6 +325,19 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
   o2::base::Propagator::MatCorrType noMatCorr = o2::base::Propagator::MatCorrType::USEMatCorrNONE;
   int runNumber;
 
+  // PV contributors of the current collision, retrieved once per collision
+  int64_t pvContributorsCollId{-1};
+  std::vector<int64_t> pvContributorGlobIds{};
+  std::vector<o2::track::TrackParCov> pvContributorTrackParCovs{};
+  // contributions of the PV contributors to the linearised vertex fit, for the incremental PV refit
+  std::vector<SMatrix33Sym> pvContributorWeightMatrices{};
+  std::vector<SVector3> pvContributorWeightedPositions{};
+  SMatrix33Sym pvWeightMatrix{};  // sum of the contributions
+  SVector3 pvWeightedPos{};       // sum of the contributions
+  SMatrix33Sym pvLinearisedCov{}; // covariance matrix of the linearised fit with all the contributors
+  SVector3 pvLinearisedPos{};     // vertex of the linearised fit with all the contributors
+  bool isPvLinearisedFitValid{false};
+
   // single-track cuts
   static const int nCuts = 4;
   // array of 2-prong and 3-prong cuts
@@ -396,6 +425,14 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
         registry.add("PvRefit/hPvRefitZChi2Minus1", "PV refit with #it{#chi}^{2}==#minus1", kTH2F, {axisCollisionZ, axisCollisionZOriginal});
         registry.add("PvRefit/hNContribPvRefitNotDoable", "N. contributors for PV refit not doable", kTH1F, {axisCollisionNContrib});
         registry.add("PvRefit/hNContribPvRefitChi2Minus1", "N. contributors original PV for PV refit #it{#chi}^{2}==#minus1", kTH1F, {axisCollisionNContrib});
+        if (pvRefitMethod == PvRefitMethod::IncrementalRefitChecked) {
+          AxisSpec axisIncrementalDeltaX{axisPvRefitDeltaX, "x_{PV}^{incremental} #minus x_{PV}^{full} (cm)"};
+          AxisSpec axisIncrementalDeltaY{axisPvRefitDeltaY, "y_{PV}^{incremental} #minus y_{PV}^{full} (cm)"};
+          AxisSpec axisIncrementalDeltaZ{axisPvRefitDeltaZ, "z_{PV}^{incremental} #minus z_{PV}^{full} (cm)"};
+          registry.add("PvRefit/hIncrementalMinusFullXvsNContrib", "", kTH2F, {axisCollisionNContrib, axisIncrementalDeltaX});
+          registry.add("PvRefit/hIncrementalMinusFullYvsNContrib", "", kTH2F, {axisCollisionNContrib, axisIncrementalDeltaY});
+          registry.add("PvRefit/hIncrementalMinusFullZvsNContrib", "", kTH2F, {axisCollisionNContrib, axisIncrementalDeltaZ});
+        }
       }
 
       ccdb->setURL(ccdbUrl);
@@ -610,6 +647,160 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
     }
   }
 
+  /// Contribution of a PV contributor to the linearised vertex fit
+  /// The track is approximated by a straight line at its reference point, which constrains the two coordinates
+  /// transverse to its direction in the tracking frame with the covariance of its y and z
+  /// \param trackParCov is the TrackParCov of the PV contributor
+  /// \param weightMatrix is the contribution to the inverse covariance matrix of the vertex
+  /// \param weightedPos is the contribution to the vertex position weighted by the inverse covariance matrix
+  void getPvContribution(o2::track::TrackParCov const& trackParCov, SMatrix33Sym& weightMatrix, SVector3& weightedPos)
+  {
+    const double sinAlpha = std::sin(trackParCov.getAlpha());
+    const double cosAlpha = std::cos(trackParCov.getAlpha());
+    const double snp = trackParCov.getSnp();
+    const double csp = std::sqrt((1. - snp) * (1. + snp));
+    const double slopeY = snp / csp;
+    const double slopeZ = trackParCov.getTgl() / csp;
+    // derivatives of the track y and z at the vertex x (tracking frame) w.r.t. the vertex coordinates (global frame)
+    ROOT::Math::SMatrix<double, 2, 3> derivatives;
+    derivatives(0, 0) = -sinAlpha - slopeY * cosAlpha;
+    derivatives(0, 1) = cosAlpha - slopeY * sinAlpha;
+    derivatives(1, 0) = -slopeZ * cosAlpha;
+    derivatives(1, 1) = -slopeZ * sinAlpha;
+    derivatives(1, 2) = 1.;
+    ROOT::Math::SVector<double, 2> measurement(trackParCov.getY() - slopeY * trackParCov.getX(), trackParCov.getZ() - slopeZ * trackParCov.getX());
+    ROOT::Math::SMatrix<double, 2, 2, ROOT::Math::MatRepSym<double, 2>> weight;
+    weight(0, 0) = trackParCov.getSigmaY2();
+    weight(0, 1) = trackParCov.getSigmaZY();
+    weight(1, 1) = trackParCov.getSigmaZ2();
+    if (!weight.Invert()) {
+      weightMatrix = SMatrix33Sym();
+      weightedPos = SVector3();
+      return;
+    }
+    weightMatrix = ROOT::Math::SimilarityT(derivatives, weight);
+    weightedPos = ROOT::Math::Transpose(derivatives) * (weight * measurement);
+  }
+
+  /// Retrieve the PV contributors of a collision, once per collision
+  /// For the incremental PV refit, the contributions of all the contributors to the linearised vertex fit are also cached
+  /// \param collision is a collision
+  void fillPvContributors(aod::Collision const& collision)
+  {
+    if (pvContributorsCollId == collision.globalIndex()) {
+      return;
+    }
+    pvContributorsCollId = collision.globalIndex();
+    pvContributorGlobIds.clear();
+    pvContributorTrackParCovs.clear();
+
+    /// contributors for the current collision
+    auto pvContrCollision = pvContributors->sliceByCached(aod::track::collisionId, pvContributorsCollId, cache);
+    for (const auto& contributor : pvContrCollision) {
+      pvContributorGlobIds.push_back(contributor.globalIndex());
+      pvContributorTrackParCovs.push_back(getTrackParCov(contributor));
+    }
+    if (debugPvRefit) {
+      LOG(info) << "### vecPvContributorGlobId.size()=" << pvContributorGlobIds.size() << ", vecPvContributorTrackParCov.size()=" << pvContributorTrackParCovs.size() << ", N. original contributors=" << collision.numContrib();
+    }
+    if (pvRefitMethod == PvRefitMethod::FullRefit) {
+      return;
+    }
+
+    pvContributorWeightMatrices.resize(pvContributorTrackParCovs.size());
+    pvContributorWeightedPositions.resize(pvContributorTrackParCovs.size());
+    pvWeightMatrix = SMatrix33Sym();
+    pvWeightedPos = SVector3();
+    for (auto iContrib{0u}; iContrib < pvContributorTrackParCovs.size(); ++iContrib) {
+      getPvContribution(pvContributorTrackParCovs[iContrib], pvContributorWeightMatrices[iContrib], pvContributorWeightedPositions[iContrib]);
+      pvWeightMatrix += pvContributorWeightMatrices[iContrib];
+      pvWeightedPos += pvContributorWeightedPositions[iContrib];
+    }
+    pvLinearisedCov = pvWeightMatrix;
+    isPvLinearisedFitValid = pvLinearisedCov.Invert();
+    if (isPvLinearisedFitValid) {
+      pvLinearisedPos = pvLinearisedCov * pvWeightedPos;
+    }
+  }
+
+  /// Incremental PV refit: the contribution of the track is subtracted from the linearised fit of all the contributors
+  /// and the resulting shifts of the vertex position and covariance matrix are applied to the original PV
+  /// \param collision is a collision
+  /// \param entry is the position of the track in the vectors of PV contributors
+  /// \param primVtxRefit is the refitted PV
+  /// \return false if the incremental refit is not possible, so that the full one has to be done
+  bool refitPvIncremental(aod::Collision const& collision, const int entry, o2::dataformats::VertexBase& primVtxRefit)
+  {
+    if (!isPvLinearisedFitValid || static_cast<int>(pvContributorGlobIds.size()) - 1 < pvRefitIncrementalNContribMin) {
+      return false;
+    }
+    SMatrix33Sym covRefit = pvWeightMatrix - pvContributorWeightMatrices[entry];
+    if (!covRefit.Invert()) {
+      return false;
+    }
+    const SVector3 deltaPos = covRefit * (pvWeightedPos - pvContributorWeightedPositions[entry]) - pvLinearisedPos;
+    const SMatrix33Sym deltaCov = covRefit - pvLinearisedCov;
+    primVtxRefit.setX(collision.posX() + deltaPos[0]);
+    primVtxRefit.setY(collision.posY() + deltaPos[1]);
+    primVtxRefit.setZ(collision.posZ() + deltaPos[2]);
+    primVtxRefit.setCov(collision.covXX() + deltaCov(0, 0), collision.covXY() + deltaCov(0, 1), collision.covYY() + deltaCov(1, 1),
+                        collision.covXZ() + deltaCov(0, 2), collision.covYZ() + deltaCov(1, 2), collision.covZZ() + deltaCov(2, 2));
+    return true;
+  }
+
+  /// Propagation of a track to the refitted PV and DCA recalculation
+  /// \param myTrack is the track
+  /// \param primVtxBaseRecalc is the refitted PV
+  /// \param pvCoord is an array containing the coordinates of the refitted PV
+  /// \param pvCovMatrix is an array containing the covariance matrix values of the refitted PV
+  /// \param dcaXYdcaZ is an array containing the dcaXY and dcaZ of myTrack with respect to the refitted PV
+  void propagateTrackToPvRefit(TracksWithSelAndDCA::iterator const& myTrack,
+                               o2::dataformats::VertexBase const& primVtxBaseRecalc,
+                               std::array<float, 3>& pvCoord,
+                               std::array<float, 6>& pvCovMatrix,
+                               std::array<float, 2>& dcaXYdcaZ)
+  {
+    /// Track propagation to the PV refit considering also the material budget
+    /// Mandatory for tracks updated at most only to the innermost ITS layer
+    auto trackPar = getTrackPar(myTrack);
+    o2::gpu::gpustd::array<float, 2> dcaInfo{-999., -999.};
+    if (o2::base::Propagator::Instance()->propagateToDCABxByBz({primVtxBaseRecalc.getX(), primVtxBaseRecalc.getY(), primVtxBaseRecalc.getZ()}, trackPar, 2.f, noMatCorr, &dcaInfo)) {
+      pvCoord[0] = primVtxBaseRecalc.getX();
+      pvCoord[1] = primVtxBaseRecalc.getY();
+      pvCoord[2] = primVtxBaseRecalc.getZ();
+      pvCovMatrix[0] = primVtxBaseRecalc.getSigmaX2();
+      pvCovMatrix[1] = primVtxBaseRecalc.getSigmaXY();
+      pvCovMatrix[2] = primVtxBaseRecalc.getSigmaY2();
+      pvCovMatrix[3] = primVtxBaseRecalc.getSigmaXZ();
+      pvCovMatrix[4] = primVtxBaseRecalc.getSigmaYZ();
+      pvCovMatrix[5] = primVtxBaseRecalc.getSigmaZ2();
+      dcaXYdcaZ[0] = dcaInfo[0]; // [cm]
+      dcaXYdcaZ[1] = dcaInfo[1]; // [cm]
+      // TODO: add DCAxy and DCAz uncertainties?
+    }
+
+    /// Track propagation to the PV refit done only ia geometrical way
+    /// Correct only if no further material budget is crossed, namely for tracks already propagated to the original PV
+    // o2::dataformats::DCA impactParameter;
+    // if (getTrackParCov(myTrack).propagateToDCA(primVtxBaseRecalc, o2::base::Propagator::Instance()->getNominalBz(), &impactParameter)) {
+    //   if (debug) {
+    //     LOG(info) << "===> nominal Bz: " << o2::base::Propagator::Instance()->getNominalBz();
+    //   }
+    //   pvCoord[0] = primVtxBaseRecalc.getX();
+    //   pvCoord[1] = primVtxBaseRecalc.getY();
+    //   pvCoord[2] = primVtxBaseRecalc.getZ();
+    //   pvCovMatrix[0] = primVtxBaseRecalc.getSigmaX2();
+    //   pvCovMatrix[1] = primVtxBaseRecalc.getSigmaXY();
+    //   pvCovMatrix[2] = primVtxBaseRecalc.getSigmaY2();
+    //   pvCovMatrix[3] = primVtxBaseRecalc.getSigmaXZ();
+    //   pvCovMatrix[4] = primVtxBaseRecalc.getSigmaYZ();
+    //   pvCovMatrix[5] = primVtxBaseRecalc.getSigmaZ2();
+    //   dcaXYdcaZ[0] = impactParameter.getY(); // [cm]
+    //   dcaXYdcaZ[1] = impactParameter.getZ();    // [cm]
+    //   // TODO: add DCAxy and DCAz uncertainties?
+    // }
+  }
+
   /// Method for the PV refit and DCA recalculation for tracks with a collision assigned
   /// \param collision is a collision
   /// \param bcWithTimeStamps is a table of bunch crossing joined with timestamps used to query the CCDB for B and material budget
@@ -621,8 +812,8 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
   /// \param dcaXYdcaZ is an array containing the dcaXY and dcaZ of myTrack with respect to the refitted PV
   void performPvRefitTrack(aod::Collision const& collision,
                            aod::BCsWithTimestamps const& bcWithTimeStamps,
-                           std::vector<int64_t> vecPvContributorGlobId,
-                           std::vector<o2::track::TrackParCov> vecPvContributorTrackParCov,
+                           std::vector<int64_t> const& vecPvContributorGlobId,
+                           std::vector<o2::track::TrackParCov> const& vecPvContributorTrackParCov,
                            TracksWithSelAndDCA::iterator const& myTrack,
                            std::array<float, 3>& pvCoord,
                            std::array<float, 6>& pvCovMatrix,
@@ -659,6 +850,32 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
       runNumber = bc.runNumber();
     }*/
 
+    /// incremental PV refit, the full one is done if not possible or if the incremental one has to be checked
+    o2::dataformats::VertexBase primVtxIncremental;
+    bool isPvRefitIncrementalDone = false;
+    if (pvRefitMethod != PvRefitMethod::FullRefit) {
+      auto trackIterator = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), myTrack.globalIndex()); /// track global index
+      if (trackIterator != vecPvContributorGlobId.end()) {
+        isPvRefitIncrementalDone = refitPvIncremental(collision, std::distance(vecPvContributorGlobId.begin(), trackIterator), primVtxIncremental);
+      }
+      if (isPvRefitIncrementalDone && pvRefitMethod == PvRefitMethod::IncrementalRefit) {
+        if (debugPvRefit) {
+          LOG(info) << "incremental refit for track with global index " << static_cast<int>(myTrack.globalIndex()) << " " << primVtxIncremental.asString();
+        }
+        if (fillHistograms) {
+          const int nContribRefit = vecPvContributorGlobId.size() - 1;
+          registry.fill(HIST("PvRefit/hVerticesPerTrack"), 1);
+          registry.fill(HIST("PvRefit/hVerticesPerTrack"), 2);
+          registry.fill(HIST("PvRefit/hVerticesPerTrack"), 3);
+          registry.fill(HIST("PvRefit/hPvDeltaXvsNContrib"), nContribRefit, collision.posX() - primVtxIncremental.getX());
+          registry.fill(HIST("PvRefit/hPvDeltaYvsNContrib"), nContribRefit, collision.posY() - primVtxIncremental.getY());
+          registry.fill(HIST("PvRefit/hPvDeltaZvsNContrib"), nContribRefit, collision.posZ() - primVtxIncremental.getZ());
+        }
+        propagateTrackToPvRefit(myTrack, primVtxIncremental, pvCoord, pvCovMatrix, dcaXYdcaZ);
+        return;
+      }
+    }
+
     // build the VertexBase to initialize the vertexer
     o2::dataformats::VertexBase primVtx;
     primVtx.setX(collision.posX());
@@ -733,6 +950,11 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
             registry.fill(HIST("PvRefit/hPvDeltaXvsNContrib"), primVtxRefitted.getNContributors(), deltaX);
             registry.fill(HIST("PvRefit/hPvDeltaYvsNContrib"), primVtxRefitted.getNContributors(), deltaY);
             registry.fill(HIST("PvRefit/hPvDeltaZvsNContrib"), primVtxRefitted.getNContributors(), deltaZ);
+            if (isPvRefitIncrementalDone) {
+              registry.fill(HIST("PvRefit/hIncrementalMinusFullXvsNContrib"), primVtxRefitted.getNContributors(), primVtxIncremental.getX() - primVtxRefitted.getX());
+              registry.fill(HIST("PvRefit/hIncrementalMinusFullYvsNContrib"), primVtxRefitted.getNContributors(), primVtxIncremental.getY() - primVtxRefitted.getY());
+              registry.fill(HIST("PvRefit/hIncrementalMinusFullZvsNContrib"), primVtxRefitted.getNContributors(), primVtxIncremental.getZ() - primVtxRefitted.getZ());
+            }
           }
 
           // fill the newly calculated PV
@@ -748,46 +970,7 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
 
     // updated value after PV recalculation
     if (recalcImpPar) {
-
-      /// Track propagation to the PV refit considering also the material budget
-      /// Mandatory for tracks updated at most only to the innermost ITS layer
-      auto trackPar = getTrackPar(myTrack);
-      o2::gpu::gpustd::array<float, 2> dcaInfo{-999., -999.};
-      if (o2::base::Propagator::Instance()->propagateToDCABxByBz({primVtxBaseRecalc.getX(), primVtxBaseRecalc.getY(), primVtxBaseRecalc.getZ()}, trackPar, 2.f, noMatCorr, &dcaInfo)) {
-        pvCoord[0] = primVtxBaseRecalc.getX();
-        pvCoord[1] = primVtxBaseRecalc.getY();
-        pvCoord[2] = primVtxBaseRecalc.getZ();
-        pvCovMatrix[0] = primVtxBaseRecalc.getSigmaX2();
-        pvCovMatrix[1] = primVtxBaseRecalc.getSigmaXY();
-        pvCovMatrix[2] = primVtxBaseRecalc.getSigmaY2();
-        pvCovMatrix[3] = primVtxBaseRecalc.getSigmaXZ();
-        pvCovMatrix[4] = primVtxBaseRecalc.getSigmaYZ();
-        pvCovMatrix[5] = primVtxBaseRecalc.getSigmaZ2();
-        dcaXYdcaZ[0] = dcaInfo[0]; // [cm]
-        dcaXYdcaZ[1] = dcaInfo[1]; // [cm]
-        // TODO: add DCAxy and DCAz uncertainties?
-      }
-
-      /// Track propagation to the PV refit done only ia geometrical way
-      /// Correct only if no further material budget is crossed, namely for tracks already propagated to the original PV
-      // o2::dataformats::DCA impactParameter;
-      // if (getTrackParCov(myTrack).propagateToDCA(primVtxBaseRecalc, o2::base::Propagator::Instance()->getNominalBz(), &impactParameter)) {
-      //   if (debug) {
-      //     LOG(info) << "===> nominal Bz: " << o2::base::Propagator::Instance()->getNominalBz();
-      //   }
-      //   pvCoord[0] = primVtxBaseRecalc.getX();
-      //   pvCoord[1] = primVtxBaseRecalc.getY();
-      //   pvCoord[2] = primVtxBaseRecalc.getZ();
-      //   pvCovMatrix[0] = primVtxBaseRecalc.getSigmaX2();
-      //   pvCovMatrix[1] = primVtxBaseRecalc.getSigmaXY();
-      //   pvCovMatrix[2] = primVtxBaseRecalc.getSigmaY2();
-      //   pvCovMatrix[3] = primVtxBaseRecalc.getSigmaXZ();
-      //   pvCovMatrix[4] = primVtxBaseRecalc.getSigmaYZ();
-      //   pvCovMatrix[5] = primVtxBaseRecalc.getSigmaZ2();
-      //   dcaXYdcaZ[0] = impactParameter.getY(); // [cm]
-      //   dcaXYdcaZ[1] = impactParameter.getZ();    // [cm]
-      //   // TODO: add DCAxy and DCAz uncertainties?
-      // }
+      propagateTrackToPvRefit(myTrack, primVtxBaseRecalc, pvCoord, pvCovMatrix, dcaXYdcaZ);
     }
 
     return;
@@ -824,6 +1007,7 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
       }
       tabPvRefitTrack.reserve(tracks.size());
     }
+    pvContributorsCollId = -1; // the collision indices refer to the current data frame
 
     for (const auto& collision : collisions) {
       auto thisCollId = collision.globalIndex();
@@ -851,24 +1035,13 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
           pvRefitPvCovMatrix = {collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ()};
 
           /// retrieve PV contributors for the current collision
-          std::vector<int64_t> vecPvContributorGlobId = {};
-          std::vector<o2::track::TrackParCov> vecPvContributorTrackParCov = {};
-
-          /// contributors for the current collision
-          auto pvContrCollision = pvContributors->sliceByCached(aod::track::collisionId, thisCollId, cache);
-          for (const auto& contributor : pvContrCollision) {
-            vecPvContributorGlobId.push_back(contributor.globalIndex());
-            vecPvContributorTrackParCov.push_back(getTrackParCov(contributor));
-          }
-          if (debugPvRefit) {
-            LOG(info) << "### vecPvContributorGlobId.size()=" << vecPvContributorGlobId.size() << ", vecPvContributorTrackParCov.size()=" << vecPvContributorTrackParCov.size() << ", N. original contributors=" << collision.numContrib();
-          }
+          fillPvContributors(collision);
 
           /// Perform the PV refit only for tracks with an assigned collision
           if (debugPvRefit) {
             LOG(info) << "[BEFORE performPvRefitTrack] track.collision().globalIndex(): " << collision.globalIndex();
           }
-          performPvRefitTrack(collision, bcWithTimeStamps, vecPvContributorGlobId, vecPvContributorTrackParCov, track, pvRefitPvCoord, pvRefitPvCovMatrix, pvRefitDcaXYDcaZ);
+          performPvRefitTrack(collision, bcWithTimeStamps, pvContributorGlobIds, pvContributorTrackParCovs, track, pvRefitPvCoord, pvRefitPvCovMatrix, pvRefitDcaXYDcaZ);
           pvRefitDcaPerTrack[trackIdx] = pvRefitDcaXYDcaZ;
           pvRefitPvCoordPerTrack[trackIdx] = pvRefitPvCoord;
           pvRefitPvCovMatrixPerTrack[trackIdx] = pvRefitPvCovMatrix;
@@ -920,6 +1093,8 @@ struct HfTrackIndexSkimCreator {
   Produces<aod::Hf3Prongs> rowTrackIndexProng3;
   Produces<aod::HfCutStatus3Prong> rowProng3CutStatus;
   Produces<aod::HfPvRefit3Prong> rowProng3PVrefit;
+  Produces<aod::HfFitCache2Prong> rowProng2FitCache;
+  Produces<aod::HfFitCache3Prong> rowProng3FitCache;
   Produces<aod::HfDstars> rowTrackIndexDstar;
   Produces<aod::HfCutStatusDstar> rowDstarCutStatus;
   Produces<aod::HfPvRefitDstar> rowDstarPVrefit;
@@ -930,6 +1105,7 @@ struct HfTrackIndexSkimCreator {
   Configurable<bool> debug{"debug", false, "debug mode"};
   Configurable<bool> debugPvRefit{"debugPvRefit", false, "debug lines for primary vertex refit"};
   Configurable<bool> fillHistograms{"fillHistograms", true, "fill histograms"};
+  Configurable<bool> fillFitCache{"fillFitCache", false, "fill tables with the fitted 2-prong and 3-prong secondary vertices, to be reused by the candidate creators"};
   ConfigurableAxis axisNumTracks{"axisNumTracks", {250, -0.5f, 249.5f}, "Number of tracks"};
   ConfigurableAxis axisNumCands{"axisNumCands", {200, -0.5f, 199.f}, "Number of candidates"};
   // Configurable<int> nCollsMax{"nCollsMax", -1, "Max collisions per file"}; //can be added to run over limited collisions per file - for tesing purposes
@@ -1002,6 +1178,14 @@ struct HfTrackIndexSkimCreator {
   std::array<std::vector<double>, kN2ProngDecays> pTBins2Prong;
   std::array<LabeledArray<double>, kN3ProngDecays> cut3Prong;
   std::array<std::vector<double>, kN3ProngDecays> pTBins3Prong;
+  // loosest squared mass windows and pT ranges of the 3-prong decays over their pT bins, used by the 3-prong pre-filter
+  std::array<double, kN3ProngDecays> mass2Min3ProngPreFilter;
+  std::array<double, kN3ProngDecays> mass2Max3ProngPreFilter;
+  std::array<double, kN3ProngDecays> ptMin3ProngPreFilter;
+  std::array<double, kN3ProngDecays> ptMax3ProngPreFilter;
+  std::vector<uint8_t> passPreFilter3ProngPos{}; // pre-filter outcome for the positive third prongs of the current pair
+  std::vector<uint8_t> passPreFilter3ProngNeg{}; // pre-filter outcome for the negative third prongs of the current pair
+  uint32_t fitterConfigHash{0};                  // hash of the DCAFitterN configuration, stored with the fitted secondary vertices
 
   using SelectedCollisions = soa::Filtered<soa::Join<aod::Collisions, aod::HfSelCollision>>;
   using TracksWithPVRefitAndDCA = soa::Join<aod::TracksWCovDcaExtra, aod::HfPvRefitTrack>;
@@ -1041,6 +1225,8 @@ struct HfTrackIndexSkimCreator {
     massMuon = o2::analysis::pdg::MassMuonPlus;
     massDzero = o2::analysis::pdg::MassD0;
 
+    fitterConfigHash = getDcaFitterConfigHash(propagateToPCA, useAbsDCA, useWeightedFinalPCA, maxR, maxDZIni, minParamChange, minRelChi2Change);
+
     arrMass2Prong[hf_cand_2prong::DecayType::D0ToPiK] = std::array{std::array{massPi, massK},
                                                                    std::array{massK, massPi}};
 
@@ -1069,6 +1255,30 @@ struct HfTrackIndexSkimCreator {
     cut3Prong = {cutsDplusToPiKPi, cutsLcToPKPi, cutsDsToKKPi, cutsXicToPKPi};
     pTBins3Prong = {binsPtDplusToPiKPi, binsPtLcToPKPi, binsPtDsToKKPi, binsPtXicToPKPi};
 
+    // loosest 3-prong selections before vertex reconstruction, a bin without mass cut opens the mass window
+    for (int iDecay3P = 0; iDecay3P < kN3ProngDecays; iDecay3P++) {
+      auto massMinIndex = cut3Prong[iDecay3P].colmap.find("massMin")->second;
+      auto massMaxIndex = cut3Prong[iDecay3P].colmap.find("massMax")->second;
+      double massMin = std::numeric_limits<double>::max();
+      double massMax = 0.;
+      for (auto iBin{0u}; iBin + 1 < pTBins3Prong[iDecay3P].size(); ++iBin) {
+        auto massMinBin = cut3Prong[iDecay3P].get(iBin, massMinIndex);
+        auto massMaxBin = cut3Prong[iDecay3P].get(iBin, massMaxIndex);
+        if (massMinBin >= 0. && massMaxBin > 0.) {
+          massMin = std::min(massMin, massMinBin);
+          massMax = std::max(massMax, massMaxBin);
+        } else {
+          massMin = 0.;
+          massMax = std::numeric_limits<double>::max();
+        }
+      }
+      // small margins, so that rounding differences with the preselections cannot reject a candidate
+      mass2Min3ProngPreFilter[iDecay3P] = massMin < std::numeric_limits<double>::max() ? 0.999 * massMin * massMin : 0.;
+      mass2Max3ProngPreFilter[iDecay3P] = massMax < std::numeric_limits<double>::max() ? 1.001 * massMax * massMax : std::numeric_limits<double>::max();
+      ptMin3ProngPreFilter[iDecay3P] = pTBins3Prong[iDecay3P].empty() ? 0. : pTBins3Prong[iDecay3P].front() - 1.e-3;
+      ptMax3ProngPreFilter[iDecay3P] = pTBins3Prong[iDecay3P].empty() ? 0. : pTBins3Prong[iDecay3P].back() + 1.e-3;
+    }
+
     if (fillHistograms) {
       registry.add("hNTracks", "Number of selected tracks;# of selected tracks;entries", {HistType::kTH1F, {axisNumTracks}});
       // 2-prong histograms
@@ -1086,6 +1296,11 @@ struct HfTrackIndexSkimCreator {
       registry.add("hVtx3ProngZ", "3-prong candidates;#it{z}_{sec. vtx.} (cm);entries", {HistType::kTH1F, {{1000, -20., 20.}}});
       registry.add("hNCand3Prong", "3-prong candidates preselected;# of candidates;entries", {HistType::kTH1F, {axisNumCands}});
       registry.add("hNCand3ProngVsNTracks", "3-prong candidates preselected;# of selected tracks;# of candidates;entries", {HistType::kTH2F, {axisNumTracks, axisNumCands}});
+      registry.add("hTriplets3Prong", "3-prong triplets;;entries", {HistType::kTH1F, {{4, 0.5, 4.5}}});
+      registry.get<TH1>(HIST("hTriplets3Prong"))->GetXaxis()->SetBinLabel(1, "attempted");
+      registry.get<TH1>(HIST("hTriplets3Prong"))->GetXaxis()->SetBinLabel(2, "pruned by pre-filter");
+      registry.get<TH1>(HIST("hTriplets3Prong"))->GetXaxis()->SetBinLabel(3, "preselected");
+      registry.get<TH1>(HIST("hTriplets3Prong"))->GetXaxis()->SetBinLabel(4, "vertex fitted");
       registry.add("hMassDPlusToPiKPi", "D^{#plus} candidates;inv. mass (#pi K #pi) (GeV/#it{c}^{2});entries", {HistType::kTH1F, {{500, 0., 5.}}});
       registry.add("hMassLcToPKPi", "#Lambda_{c}^{#plus} candidates;inv. mass (p K #pi) (GeV/#it{c}^{2});entries", {HistType::kTH1F, {{500, 0., 5.}}});
       registry.add("hMassDsToKKPi", "D_{s}^{#plus} candidates;inv. mass (K K #pi) (GeV/#it{c}^{2});entries", {HistType::kTH1F, {{500, 0., 5.}}});
@@ -1275,6 +1490,67 @@ struct HfTrackIndexSkimCreator {
     }
   }
 
+  /// Kinematic pre-filter of 3-prong candidates with two given prongs, before the 3-prong preselections
+  /// A third prong passes if the triplet can be within the pT range and the loosest mass window of at least one 3-prong decay hypothesis.
+  /// The hypotheses for which the mass of the first two prongs plus the mass of the third one is already above the window are dropped
+  /// for all the third prongs, the other ones are checked for all the third prongs in a branch-free loop.
+  /// \param pVecTrack0 is the momentum array of the first daughter track
+  /// \param pVecTrack1 is the momentum array of the second daughter track
+  /// \param pVecTracks2 are the momentum arrays of the third daughter tracks
+  /// \param first is the index of the first third daughter track to check
+  /// \param passPreFilter is set to 1 for the third daughter tracks passing the pre-filter, 0 otherwise
+  template <typename T1, typename T2>
+  void preFilter3Prong(T1 const& pVecTrack0, T1 const& pVecTrack1, T2 const& pVecTracks2, std::size_t first, std::vector<uint8_t>& passPreFilter)
+  {
+    passPreFilter.assign(pVecTracks2.size(), 0);
+
+    constexpr int kNHypos = 2 * kN3ProngDecays;
+    double energy01[kNHypos], mass2Track2[kNHypos], mass2Min[kNHypos], mass2Max[kNHypos], ptMin[kNHypos], ptMax[kNHypos];
+    int nHypos = 0;
+    const double px01 = pVecTrack0[0] + pVecTrack1[0];
+    const double py01 = pVecTrack0[1] + pVecTrack1[1];
+    const double pz01 = pVecTrack0[2] + pVecTrack1[2];
+    const double p2Track0 = RecoDecay::p2(pVecTrack0);
+    const double p2Track1 = RecoDecay::p2(pVecTrack1);
+    for (int iDecay3P = 0; iDecay3P < kN3ProngDecays; iDecay3P++) {
+      for (int iHypo = 0; iHypo < 2; iHypo++) {
+        const auto& masses = arrMass3Prong[iDecay3P][iHypo];
+        double energy = std::sqrt(p2Track0 + masses[0] * masses[0]) + std::sqrt(p2Track1 + masses[1] * masses[1]);
+        double mass01 = std::sqrt(std::max(0., energy * energy - (px01 * px01 + py01 * py01 + pz01 * pz01)));
+        if ((mass01 + masses[2]) * (mass01 + masses[2]) >= mass2Max3ProngPreFilter[iDecay3P]) {
+          continue;
+        }
+        energy01[nHypos] = energy;
+        mass2Track2[nHypos] = masses[2] * masses[2];
+        mass2Min[nHypos] = mass2Min3ProngPreFilter[iDecay3P];
+        mass2Max[nHypos] = mass2Max3ProngPreFilter[iDecay3P];
+        ptMin[nHypos] = ptMin3ProngPreFilter[iDecay3P];
+        ptMax[nHypos] = ptMax3ProngPreFilter[iDecay3P];
+        nHypos++;
+      }
+    }
+    if (nHypos == 0) {
+      return;
+    }
+
+    for (auto iTrack2{first}; iTrack2 < pVecTracks2.size(); ++iTrack2) {
+      const auto& pVecTrack2 = pVecTracks2[iTrack2];
+      const double px = px01 + pVecTrack2[0];
+      const double py = py01 + pVecTrack2[1];
+      const double pz = pz01 + pVecTrack2[2];
+      const double pt = std::sqrt(px * px + py * py) + ptTolerance; // same tolerance as in the preselections
+      const double p2 = px * px + py * py + pz * pz;
+      const double p2Track2 = RecoDecay::p2(pVecTrack2);
+      bool pass = false;
+      for (int iHypo = 0; iHypo < nHypos; iHypo++) {
+        const double energy = energy01[iHypo] + std::sqrt(p2Track2 + mass2Track2[iHypo]);
+        const double mass2 = energy * energy - p2;
+        pass |= (pt >= ptMin[iHypo]) & (pt < ptMax[iHypo]) & (mass2 >= mass2Min[iHypo]) & (mass2 < mass2Max[iHypo]);
+      }
+      passPreFilter[iTrack2] = pass;
+    }
+  }
+
   /// Method to perform selections for 2-prong candidates after vertex reconstruction
   /// \param pVecCand is the array for the candidate momentum after reconstruction of secondary vertex
   /// \param secVtx is the secondary vertex
@@ -1585,6 +1861,68 @@ struct HfTrackIndexSkimCreator {
     return;
   } /// end of performPvRefitCandProngs function
 
+  /// Selected prongs of one charge in the current collision, stored as arrays
+  /// The track parameters, momenta and DCAs are propagated to the collision once, before the 2- and 3-prong combinatorics
+  struct SkimProngs {
+    std::vector<int64_t> globalIndex{};
+    std::vector<int> isSelProng{};
+    std::vector<o2::track::TrackParCov> trackParVar{};
+    std::vector<std::array<float, 3>> pVec{};
+    std::vector<o2::gpu::gpustd::array<float, 2>> dcaInfo{};
+    std::vector<bool> isPropagatedToColl{};               // track parameters re-propagated to a collision other than the default one
+    std::vector<std::array<float, 3>> pvRefitCoord{};     // PV refitted without the track, only with PV refit
+    std::vector<std::array<float, 6>> pvRefitCovMatrix{}; // covariance matrix of the PV refitted without the track, only with PV refit
+
+    std::size_t size() const { return globalIndex.size(); }
+    void clear()
+    {
+      globalIndex.clear();
+      isSelProng.clear();
+      trackParVar.clear();
+      pVec.clear();
+      dcaInfo.clear();
+      isPropagatedToColl.clear();
+      pvRefitCoord.clear();
+      pvRefitCovMatrix.clear();
+    }
+  };
+  SkimProngs prongsPos{};
+  SkimProngs prongsNeg{};
+
+  /// Split the selected prongs of a collision into positive and negative ones
+  /// \param collision is the collision
+  /// \param trackIndices are the indices of the selected tracks associated to the collision
+  template <bool doPvRefit, typename TTracks, typename TCollision, typename TTrackIndices>
+  void fillSkimProngs(TCollision const& collision, TTrackIndices const& trackIndices)
+  {
+    prongsPos.clear();
+    prongsNeg.clear();
+    auto thisCollId = collision.globalIndex();
+    for (const auto& trackIndex : trackIndices) {
+      auto track = trackIndex.template track_as<TTracks>();
+      auto& prongs = track.signed1Pt() < 0 ? prongsNeg : prongsPos;
+
+      auto trackParVar = getTrackParCov(track);
+      std::array<float, 3> pVecTrack{track.px(), track.py(), track.pz()};
+      o2::gpu::gpustd::array<float, 2> dcaInfo{track.dcaXY(), track.dcaZ()};
+      if (thisCollId != track.collisionId()) { // this is not the "default" collision for this track, we have to re-propagate it
+        o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVar, 2.f, noMatCorr, &dcaInfo);
+        getPxPyPz(trackParVar, pVecTrack);
+      }
+
+      prongs.globalIndex.push_back(track.globalIndex());
+      prongs.isSelProng.push_back(trackIndex.isSelProng());
+      prongs.trackParVar.push_back(trackParVar);
+      prongs.pVec.push_back(pVecTrack);
+      prongs.dcaInfo.push_back(dcaInfo);
+      prongs.isPropagatedToColl.push_back(thisCollId != track.collisionId());
+      if constexpr (doPvRefit) {
+        prongs.pvRefitCoord.push_back({track.pvRefitX(), track.pvRefitY(), track.pvRefitZ()});
+        prongs.pvRefitCovMatrix.push_back({track.pvRefitSigmaX2(), track.pvRefitSigmaXY(), track.pvRefitSigmaY2(), track.pvRefitSigmaXZ(), track.pvRefitSigmaYZ(), track.pvRefitSigmaZ2()});
+      }
+    }
+  }
+
   template <bool doPvRefit = false, typename TTracks>
   void run2And3Prongs(SelectedCollisions const& collisions,
                       aod::BCsWithTimestamps const& bcWithTimeStamps,
@@ -1680,64 +2018,43 @@ struct HfTrackIndexSkimCreator {
       // used to calculate number of candidiates per event
       auto nCand2 = rowTrackIndexProng2.lastIndex();
       auto nCand3 = rowTrackIndexProng3.lastIndex();
-
-      // if there isn't at least a positive and a negative track, continue immediately
-      // if (tracksPos.size() < 1 || tracksNeg.size() < 1) {
-      //  return;
-      //}
-
-      // first loop over positive tracks
-      // for (auto trackPos1 = tracksPos.begin(); trackPos1 != tracksPos.end(); ++trackPos1) {
+      int nTriplets3ProngAttempted{0}, nTriplets3ProngPruned{0}, nTriplets3ProngPreselected{0}, nTriplets3ProngFitted{0};
 
       auto thisCollId = collision.globalIndex();
       auto groupedTrackIndices = trackIndices.sliceBy(trackIndicesPerCollision, thisCollId);
 
-      for (auto trackIndexPos1 = groupedTrackIndices.begin(); trackIndexPos1 != groupedTrackIndices.end(); ++trackIndexPos1) {
-        auto trackPos1 = trackIndexPos1.template track_as<TTracks>();
-
-        if (trackPos1.signed1Pt() < 0) {
-          continue;
-        }
+      // split the selected prongs by charge, with the track parameters propagated to this collision
+      fillSkimProngs<doPvRefit, TTracks>(collision, groupedTrackIndices);
 
+      // first loop over positive tracks
+      for (auto iPos1{0u}; iPos1 < prongsPos.size(); ++iPos1) {
         // retrieve the selection flag that corresponds to this collision
-        auto isSelProngPos1 = trackIndexPos1.isSelProng();
+        auto isSelProngPos1 = prongsPos.isSelProng[iPos1];
         bool sel2ProngStatusPos = TESTBIT(isSelProngPos1, CandidateType::Cand2Prong);
         bool sel3ProngStatusPos1 = TESTBIT(isSelProngPos1, CandidateType::Cand3Prong);
         if (!sel2ProngStatusPos && !sel3ProngStatusPos1) {
           continue;
         }
 
-        auto trackParVarPos1 = getTrackParCov(trackPos1);
-        std::array<float, 3> pVecTrackPos1{trackPos1.px(), trackPos1.py(), trackPos1.pz()};
-        o2::gpu::gpustd::array<float, 2> dcaInfoPos1{trackPos1.dcaXY(), trackPos1.dcaZ()};
-        if (thisCollId != trackPos1.collisionId()) { // this is not the "default" collision for this track, we have to re-propagate it
-          o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarPos1, 2.f, noMatCorr, &dcaInfoPos1);
-          getPxPyPz(trackParVarPos1, pVecTrackPos1);
-        }
+        auto globalIndexPos1 = prongsPos.globalIndex[iPos1];
+        const auto& trackParVarPos1 = prongsPos.trackParVar[iPos1];
+        const auto& pVecTrackPos1 = prongsPos.pVec[iPos1];
+        const auto& dcaInfoPos1 = prongsPos.dcaInfo[iPos1];
 
         // first loop over negative tracks
-        // for (auto trackNeg1 = tracksNeg.begin(); trackNeg1 != tracksNeg.end(); ++trackNeg1) {
-        for (auto trackIndexNeg1 = groupedTrackIndices.begin(); trackIndexNeg1 != groupedTrackIndices.end(); ++trackIndexNeg1) {
-          auto trackNeg1 = trackIndexNeg1.template track_as<TTracks>();
-          if (trackNeg1.signed1Pt() > 0) {
-            continue;
-          }
-
+        for (auto iNeg1{0u}; iNeg1 < prongsNeg.size(); ++iNeg1) {
           // retrieve the selection flag that corresponds to this collision
-          auto isSelProngNeg1 = trackIndexNeg1.isSelProng();
+          auto isSelProngNeg1 = prongsNeg.isSelProng[iNeg1];
           bool sel2ProngStatusNeg = TESTBIT(isSelProngNeg1, CandidateType::Cand2Prong);
           bool sel3ProngStatusNeg1 = TESTBIT(isSelProngNeg1, CandidateType::Cand3Prong);
           if (!sel2ProngStatusNeg && !sel3ProngStatusNeg1) {
             continue;
           }
 
-          auto trackParVarNeg1 = getTrackParCov(trackNeg1);
-          std::array<float, 3> pVecTrackNeg1{trackNeg1.px(), trackNeg1.py(), trackNeg1.pz()};
-          o2::gpu::gpustd::array<float, 2> dcaInfoNeg1{trackNeg1.dcaXY(), trackNeg1.dcaZ()};
-          if (thisCollId != trackNeg1.collisionId()) { // this is not the "default" collision for this track, we have to re-propagate it
-            o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarNeg1, 2.f, noMatCorr, &dcaInfoNeg1);
-            getPxPyPz(trackParVarNeg1, pVecTrackNeg1);
-          }
+          auto globalIndexNeg1 = prongsNeg.globalIndex[iNeg1];
+          const auto& trackParVarNeg1 = prongsNeg.trackParVar[iNeg1];
+          const auto& pVecTrackNeg1 = prongsNeg.pVec[iNeg1];
+          const auto& dcaInfoNeg1 = prongsNeg.dcaInfo[iNeg1];
 
           int isSelected2ProngCand = n2ProngBit; // bitmap for checking status of two-prong candidates (1 is true, 0 is rejected)
 
@@ -1774,14 +2091,14 @@ struct HfTrackIndexSkimCreator {
                   registry.fill(HIST("PvRefit/verticesPerCandidate"), 1);
                 }
                 int nCandContr = 2;
-                auto trackFirstIt = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), trackPos1.globalIndex());
-                auto trackSecondIt = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), trackNeg1.globalIndex());
+                auto trackFirstIt = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), globalIndexPos1);
+                auto trackSecondIt = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), globalIndexNeg1);
                 bool isTrackFirstContr = true;
                 bool isTrackSecondContr = true;
                 if (trackFirstIt == vecPvContributorGlobId.end()) {
                   /// This track did not contribute to the original PV refit
                   if (debugPvRefit) {
-                    LOG(info) << "--- [2 Prong] trackPos1 with globalIndex " << trackPos1.globalIndex() << " was not a PV contributor";
+                    LOG(info) << "--- [2 Prong] trackPos1 with globalIndex " << globalIndexPos1 << " was not a PV contributor";
                   }
                   nCandContr--;
                   isTrackFirstContr = false;
@@ -1789,7 +2106,7 @@ struct HfTrackIndexSkimCreator {
                 if (trackSecondIt == vecPvContributorGlobId.end()) {
                   /// This track did not contribute to the original PV refit
                   if (debugPvRefit) {
-                    LOG(info) << "--- [2 Prong] trackNeg1 with globalIndex " << trackNeg1.globalIndex() << " was not a PV contributor";
+                    LOG(info) << "--- [2 Prong] trackNeg1 with globalIndex " << globalIndexNeg1 << " was not a PV contributor";
                   }
                   nCandContr--;
                   isTrackSecondContr = false;
@@ -1799,7 +2116,7 @@ struct HfTrackIndexSkimCreator {
                   if (debugPvRefit) {
                     LOG(info) << "### [2 Prong] Calling performPvRefitCandProngs for HF 2 prong candidate";
                   }
-                  performPvRefitCandProngs(collision, bcWithTimeStamps, vecPvContributorGlobId, vecPvContributorTrackParCov, {trackPos1.globalIndex(), trackNeg1.globalIndex()}, pvRefitCoord2Prong, pvRefitCovMatrix2Prong);
+                  performPvRefitCandProngs(collision, bcWithTimeStamps, vecPvContributorGlobId, vecPvContributorTrackParCov, {globalIndexPos1, globalIndexNeg1}, pvRefitCoord2Prong, pvRefitCovMatrix2Prong);
                 } else if (nCandContr == 1) {
                   /// Only one daughter was a contributor, let's use then the PV recalculated by excluding only it
                   if (debugPvRefit) {
@@ -1810,12 +2127,12 @@ struct HfTrackIndexSkimCreator {
                   }
                   if (isTrackFirstContr && !isTrackSecondContr) {
                     /// the first daughter is contributor, the second is not
-                    pvRefitCoord2Prong = {trackPos1.pvRefitX(), trackPos1.pvRefitY(), trackPos1.pvRefitZ()};
-                    pvRefitCovMatrix2Prong = {trackPos1.pvRefitSigmaX2(), trackPos1.pvRefitSigmaXY(), trackPos1.pvRefitSigmaY2(), trackPos1.pvRefitSigmaXZ(), trackPos1.pvRefitSigmaYZ(), trackPos1.pvRefitSigmaZ2()};
+                    pvRefitCoord2Prong = prongsPos.pvRefitCoord[iPos1];
+                    pvRefitCovMatrix2Prong = prongsPos.pvRefitCovMatrix[iPos1];
                   } else if (!isTrackFirstContr && isTrackSecondContr) {
                     ///  the second daughter is contributor, the first is not
-                    pvRefitCoord2Prong = {trackNeg1.pvRefitX(), trackNeg1.pvRefitY(), trackNeg1.pvRefitZ()};
-                    pvRefitCovMatrix2Prong = {trackNeg1.pvRefitSigmaX2(), trackNeg1.pvRefitSigmaXY(), trackNeg1.pvRefitSigmaY2(), trackNeg1.pvRefitSigmaXZ(), trackNeg1.pvRefitSigmaYZ(), trackNeg1.pvRefitSigmaZ2()};
+                    pvRefitCoord2Prong = prongsNeg.pvRefitCoord[iNeg1];
+                    pvRefitCovMatrix2Prong = prongsNeg.pvRefitCovMatrix[iNeg1];
                   }
                 } else {
                   /// 0 contributors among the HF candidate daughters
@@ -1840,7 +2157,7 @@ struct HfTrackIndexSkimCreator {
 
               if (isSelected2ProngCand > 0) {
                 // fill table row
-                rowTrackIndexProng2(thisCollId, trackPos1.globalIndex(), trackNeg1.globalIndex(), isSelected2ProngCand);
+                rowTrackIndexProng2(thisCollId, globalIndexPos1, globalIndexNeg1, isSelected2ProngCand);
 
                 if constexpr (doPvRefit) {
                   // fill table row with coordinates of PV refit
@@ -1848,6 +2165,16 @@ struct HfTrackIndexSkimCreator {
                                    pvRefitCovMatrix2Prong[0], pvRefitCovMatrix2Prong[1], pvRefitCovMatrix2Prong[2], pvRefitCovMatrix2Prong[3], pvRefitCovMatrix2Prong[4], pvRefitCovMatrix2Prong[5]);
                 }
 
+                if (fillFitCache) {
+                  // fill table row with the fitted secondary vertex, reusable only if the prongs were not re-propagated to this collision
+                  auto covMatrixPca = df2.calcPCACovMatrixFlat();
+                  bool isFitReusable = !prongsPos.isPropagatedToColl[iPos1] && !prongsNeg.isPropagatedToColl[iNeg1];
+                  rowProng2FitCache(isFitReusable ? fitterConfigHash : 0u,
+                                    secondaryVertex2[0], secondaryVertex2[1], secondaryVertex2[2],
+                                    covMatrixPca[0], covMatrixPca[1], covMatrixPca[2], covMatrixPca[3], covMatrixPca[4], covMatrixPca[5],
+                                    df2.getChi2AtPCACandidate(), df2.getTrack(0).getX(), df2.getTrack(1).getX());
+                }
+
                 if (debug) {
                   int Prong2CutStatus[kN2ProngDecays];
                   for (int iDecay2P = 0; iDecay2P < kN2ProngDecays; iDecay2P++) {
@@ -1902,34 +2229,29 @@ struct HfTrackIndexSkimCreator {
               continue;
             }
 
-            // second loop over positive tracks
-            // for (auto trackPos2 = trackPos1 + 1; trackPos2 != tracksPos.end(); ++trackPos2) {
-            for (auto trackIndexPos2 = trackIndexPos1 + 1; trackIndexPos2 != groupedTrackIndices.end(); ++trackIndexPos2) {
-              auto trackPos2 = trackIndexPos2.template track_as<TTracks>();
-              if (trackPos2.signed1Pt() < 0) {
-                continue;
-              }
+            // kinematic pre-filter of the third prongs, not applied in debug mode to keep the full cut status
+            bool applyPreFilter3Prong = do3Prong && sel3ProngStatusPos1 && sel3ProngStatusNeg1 && !debug;
+            if (applyPreFilter3Prong) {
+              preFilter3Prong(pVecTrackPos1, pVecTrackNeg1, prongsPos.pVec, iPos1 + 1, passPreFilter3ProngPos);
+              preFilter3Prong(pVecTrackNeg1, pVecTrackPos1, prongsNeg.pVec, iNeg1 + 1, passPreFilter3ProngNeg);
+            }
 
-              auto trackParVarPos2 = getTrackParCov(trackPos2);
-              std::array<float, 3> pVecTrackPos2{trackPos2.px(), trackPos2.py(), trackPos2.pz()};
-              o2::gpu::gpustd::array<float, 2> dcaInfoPos2{trackPos2.dcaXY(), trackPos2.dcaZ()};
-              bool propagatedPos2{false};
+            // second loop over positive tracks
+            for (auto iPos2{iPos1 + 1}; iPos2 < prongsPos.size(); ++iPos2) {
+              auto globalIndexPos2 = prongsPos.globalIndex[iPos2];
+              const auto& trackParVarPos2 = prongsPos.trackParVar[iPos2];
+              const auto& pVecTrackPos2 = prongsPos.pVec[iPos2];
 
               // first we build D*+ candidates if enabled
-              auto isSelProngPos2 = trackIndexPos2.isSelProng();
+              auto isSelProngPos2 = prongsPos.isSelProng[iPos2];
               uint8_t isSelectedDstar{0};
               if (doDstar && TESTBIT(isSelected2ProngCand, hf_cand_2prong::DecayType::D0ToPiK) && (whichHypo2Prong[0] == 1 || whichHypo2Prong[0] == 3)) { // the 2-prong decay is compatible with a D0
                 if (TESTBIT(isSelProngPos2, CandidateType::CandDstar)) {                                                                                  // compatible with a soft pion
-                  if (thisCollId != trackPos2.collisionId()) {                                                                                            // this is not the "default" collision for this track, we have to re-propagate it
-                    o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarPos2, 2.f, noMatCorr, &dcaInfoPos2);
-                    getPxPyPz(trackParVarPos2, pVecTrackPos2);
-                    propagatedPos2 = true;
-                  }
                   uint8_t cutStatus{BIT(kNCutsDstar) - 1};
                   float deltaMass{-1.};
                   isSelectedDstar = isDstarSelected(pVecTrackPos1, pVecTrackNeg1, pVecTrackPos2, cutStatus, deltaMass); // we do not compute the D* decay vertex at this stage because we are not interested in applying topological selections
                   if (isSelectedDstar) {
-                    rowTrackIndexDstar(thisCollId, trackPos2.globalIndex(), rowTrackIndexProng2.lastIndex());
+                    rowTrackIndexDstar(thisCollId, globalIndexPos2, rowTrackIndexProng2.lastIndex());
                     if (fillHistograms) {
                       registry.fill(HIST("hMassDstarToD0Pi"), deltaMass);
                     }
@@ -1943,9 +2265,10 @@ struct HfTrackIndexSkimCreator {
               // preselection of 3-prong candidates
               int isSelected3ProngCand = n3ProngBit;
               if (do3Prong && TESTBIT(isSelProngPos2, CandidateType::Cand3Prong) && (sel3ProngStatusPos1 && sel3ProngStatusNeg1)) {
-                if (thisCollId != trackPos2.collisionId() && !propagatedPos2) { // this is not the "default" collision for this track and we still did not re-propagate it, we have to re-propagate it
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarPos2, 2.f, noMatCorr, &dcaInfoPos2);
-                  getPxPyPz(trackParVarPos2, pVecTrackPos2);
+                nTriplets3ProngAttempted++;
+                if (applyPreFilter3Prong && !passPreFilter3ProngPos[iPos2]) {
+                  nTriplets3ProngPruned++;
+                  continue;
                 }
 
                 if (debug) {
@@ -1958,6 +2281,9 @@ struct HfTrackIndexSkimCreator {
 
                 // 3-prong preselections
                 is3ProngPreselected(pVecTrackPos1, pVecTrackNeg1, pVecTrackPos2, cutStatus3Prong, whichHypo3Prong, isSelected3ProngCand);
+                if (isSelected3ProngCand > 0) {
+                  nTriplets3ProngPreselected++;
+                }
                 if (!debug && isSelected3ProngCand == 0) {
                   continue;
                 }
@@ -1978,16 +2304,16 @@ struct HfTrackIndexSkimCreator {
                   registry.fill(HIST("PvRefit/verticesPerCandidate"), 1);
                 }
                 int nCandContr = 3;
-                auto trackFirstIt = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), trackPos1.globalIndex());
-                auto trackSecondIt = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), trackNeg1.globalIndex());
-                auto trackThirdIt = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), trackPos2.globalIndex());
+                auto trackFirstIt = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), globalIndexPos1);
+                auto trackSecondIt = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), globalIndexNeg1);
+                auto trackThirdIt = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), globalIndexPos2);
                 bool isTrackFirstContr = true;
                 bool isTrackSecondContr = true;
                 bool isTrackThirdContr = true;
                 if (trackFirstIt == vecPvContributorGlobId.end()) {
                   /// This track did not contribute to the original PV refit
                   if (debugPvRefit) {
-                    LOG(info) << "--- [3 prong] trackPos1 with globalIndex " << trackPos1.globalIndex() << " was not a PV contributor";
+                    LOG(info) << "--- [3 prong] trackPos1 with globalIndex " << globalIndexPos1 << " was not a PV contributor";
                   }
                   nCandContr--;
                   isTrackFirstContr = false;
@@ -1995,7 +2321,7 @@ struct HfTrackIndexSkimCreator {
                 if (trackSecondIt == vecPvContributorGlobId.end()) {
                   /// This track did not contribute to the original PV refit
                   if (debugPvRefit) {
-                    LOG(info) << "--- [3 prong] trackNeg1 with globalIndex " << trackNeg1.globalIndex() << " was not a PV contributor";
+                    LOG(info) << "--- [3 prong] trackNeg1 with globalIndex " << globalIndexNeg1 << " was not a PV contributor";
                   }
                   nCandContr--;
                   isTrackSecondContr = false;
@@ -2003,7 +2329,7 @@ struct HfTrackIndexSkimCreator {
                 if (trackThirdIt == vecPvContributorGlobId.end()) {
                   /// This track did not contribute to the original PV refit
                   if (debugPvRefit) {
-                    LOG(info) << "--- [3 prong] trackPos2 with globalIndex " << trackPos2.globalIndex() << " was not a PV contributor";
+                    LOG(info) << "--- [3 prong] trackPos2 with globalIndex " << globalIndexPos2 << " was not a PV contributor";
                   }
                   nCandContr--;
                   isTrackThirdContr = false;
@@ -2012,13 +2338,13 @@ struct HfTrackIndexSkimCreator {
                 // Fill a vector with global ID of candidate daughters that are contributors
                 std::vector<int64_t> vecCandPvContributorGlobId = {};
                 if (isTrackFirstContr) {
-                  vecCandPvContributorGlobId.push_back(trackPos1.globalIndex());
+                  vecCandPvContributorGlobId.push_back(globalIndexPos1);
                 }
                 if (isTrackSecondContr) {
-                  vecCandPvContributorGlobId.push_back(trackNeg1.globalIndex());
+                  vecCandPvContributorGlobId.push_back(globalIndexNeg1);
                 }
                 if (isTrackThirdContr) {
-                  vecCandPvContributorGlobId.push_back(trackPos2.globalIndex());
+                  vecCandPvContributorGlobId.push_back(globalIndexPos2);
                 }
 
                 if (nCandContr == 3 || nCandContr == 2) {
@@ -2037,16 +2363,16 @@ struct HfTrackIndexSkimCreator {
                   }
                   if (isTrackFirstContr && !isTrackSecondContr && !isTrackThirdContr) {
                     /// the first daughter is contributor, the second and the third are not
-                    pvRefitCoord3Prong2Pos1Neg = {trackPos1.pvRefitX(), trackPos1.pvRefitY(), trackPos1.pvRefitZ()};
-                    pvRefitCovMatrix3Prong2Pos1Neg = {trackPos1.pvRefitSigmaX2(), trackPos1.pvRefitSigmaXY(), trackPos1.pvRefitSigmaY2(), trackPos1.pvRefitSigmaXZ(), trackPos1.pvRefitSigmaYZ(), trackPos1.pvRefitSigmaZ2()};
+                    pvRefitCoord3Prong2Pos1Neg = prongsPos.pvRefitCoord[iPos1];
+                    pvRefitCovMatrix3Prong2Pos1Neg = prongsPos.pvRefitCovMatrix[iPos1];
                   } else if (!isTrackFirstContr && isTrackSecondContr && !isTrackThirdContr) {
                     /// the second daughter is contributor, the first and the third are not
-                    pvRefitCoord3Prong2Pos1Neg = {trackNeg1.pvRefitX(), trackNeg1.pvRefitY(), trackNeg1.pvRefitZ()};
-                    pvRefitCovMatrix3Prong2Pos1Neg = {trackNeg1.pvRefitSigmaX2(), trackNeg1.pvRefitSigmaXY(), trackNeg1.pvRefitSigmaY2(), trackNeg1.pvRefitSigmaXZ(), trackNeg1.pvRefitSigmaYZ(), trackNeg1.pvRefitSigmaZ2()};
+                    pvRefitCoord3Prong2Pos1Neg = prongsNeg.pvRefitCoord[iNeg1];
+                    pvRefitCovMatrix3Prong2Pos1Neg = prongsNeg.pvRefitCovMatrix[iNeg1];
                   } else if (!isTrackFirstContr && !isTrackSecondContr && isTrackThirdContr) {
                     /// the third daughter is contributor, the first and the second are not
-                    pvRefitCoord3Prong2Pos1Neg = {trackPos2.pvRefitX(), trackPos2.pvRefitY(), trackPos2.pvRefitZ()};
-                    pvRefitCovMatrix3Prong2Pos1Neg = {trackPos2.pvRefitSigmaX2(), trackPos2.pvRefitSigmaXY(), trackPos2.pvRefitSigmaY2(), trackPos2.pvRefitSigmaXZ(), trackPos2.pvRefitSigmaYZ(), trackPos2.pvRefitSigmaZ2()};
+                    pvRefitCoord3Prong2Pos1Neg = prongsPos.pvRefitCoord[iPos2];
+                    pvRefitCovMatrix3Prong2Pos1Neg = prongsPos.pvRefitCovMatrix[iPos2];
                   }
                 } else {
                   /// 0 contributors among the HF candidate daughters
@@ -2071,6 +2397,7 @@ struct HfTrackIndexSkimCreator {
               if (df3.process(trackParVarPos1, trackParVarNeg1, trackParVarPos2) == 0) {
                 continue;
               }
+              nTriplets3ProngFitted++;
               // get secondary vertex
               const auto& secondaryVertex3 = df3.getPCACandidate();
               // get track momenta
@@ -2089,12 +2416,21 @@ struct HfTrackIndexSkimCreator {
               }
 
               // fill table row
-              rowTrackIndexProng3(thisCollId, trackPos1.globalIndex(), trackNeg1.globalIndex(), trackPos2.globalIndex(), isSelected3ProngCand);
+              rowTrackIndexProng3(thisCollId, globalIndexPos1, globalIndexNeg1, globalIndexPos2, isSelected3ProngCand);
               if constexpr (doPvRefit) {
                 // fill table row of coordinates of PV refit
                 rowProng3PVrefit(pvRefitCoord3Prong2Pos1Neg[0], pvRefitCoord3Prong2Pos1Neg[1], pvRefitCoord3Prong2Pos1Neg[2],
                                  pvRefitCovMatrix3Prong2Pos1Neg[0], pvRefitCovMatrix3Prong2Pos1Neg[1], pvRefitCovMatrix3Prong2Pos1Neg[2], pvRefitCovMatrix3Prong2Pos1Neg[3], pvRefitCovMatrix3Prong2Pos1Neg[4], pvRefitCovMatrix3Prong2Pos1Neg[5]);
               }
+              if (fillFitCache) {
+                // fill table row with the fitted secondary vertex, reusable only if the prongs were not re-propagated to this collision
+                auto covMatrixPca = df3.calcPCACovMatrixFlat();
+                bool isFitReusable = !prongsPos.isPropagatedToColl[iPos1] && !prongsNeg.isPropagatedToColl[iNeg1] && !prongsPos.isPropagatedToColl[iPos2];
+                rowProng3FitCache(isFitReusable ? fitterConfigHash : 0u,
+                                  secondaryVertex3[0], secondaryVertex3[1], secondaryVertex3[2],
+                                  covMatrixPca[0], covMatrixPca[1], covMatrixPca[2], covMatrixPca[3], covMatrixPca[4], covMatrixPca[5],
+                                  df3.getChi2AtPCACandidate(), df3.getTrack(0).getX(), df3.getTrack(1).getX(), df3.getTrack(2).getX());
+              }
 
               if (debug) {
                 int Prong3CutStatus[kN3ProngDecays];
@@ -2154,33 +2490,21 @@ struct HfTrackIndexSkimCreator {
             }
 
             // second loop over negative tracks
-            // for (auto trackNeg2 = trackNeg1 + 1; trackNeg2 != tracksNeg.end(); ++trackNeg2) {
-            for (auto trackIndexNeg2 = trackIndexNeg1 + 1; trackIndexNeg2 != groupedTrackIndices.end(); ++trackIndexNeg2) {
-              auto trackNeg2 = trackIndexNeg2.template track_as<TTracks>();
-              if (trackNeg2.signed1Pt() > 0) {
-                continue;
-              }
-
-              auto trackParVarNeg2 = getTrackParCov(trackNeg2);
-              std::array<float, 3> pVecTrackNeg2{trackNeg2.px(), trackNeg2.py(), trackNeg2.pz()};
-              o2::gpu::gpustd::array<float, 2> dcaInfoNeg2{trackNeg2.dcaXY(), trackNeg2.dcaZ()};
-              bool propagatedNeg2{false};
+            for (auto iNeg2{iNeg1 + 1}; iNeg2 < prongsNeg.size(); ++iNeg2) {
+              auto globalIndexNeg2 = prongsNeg.globalIndex[iNeg2];
+              const auto& trackParVarNeg2 = prongsNeg.trackParVar[iNeg2];
+              const auto& pVecTrackNeg2 = prongsNeg.pVec[iNeg2];
 
               // first we build D*+ candidates if enabled
-              auto isSelProngNeg2 = trackIndexNeg2.isSelProng();
+              auto isSelProngNeg2 = prongsNeg.isSelProng[iNeg2];
               uint8_t isSelectedDstar{0};
               if (doDstar && TESTBIT(isSelected2ProngCand, hf_cand_2prong::DecayType::D0ToPiK) && (whichHypo2Prong[0] >= 2)) { // the 2-prong decay is compatible with a D0bar
                 if (TESTBIT(isSelProngNeg2, CandidateType::CandDstar)) {                                                       // compatible with a soft pion
-                  if (thisCollId != trackNeg2.collisionId()) {                                                                 // this is not the "default" collision for this track, we have to re-propagate it
-                    o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarNeg2, 2.f, noMatCorr, &dcaInfoNeg2);
-                    getPxPyPz(trackParVarNeg2, pVecTrackNeg2);
-                    propagatedNeg2 = true;
-                  }
                   uint8_t cutStatus{BIT(kNCutsDstar) - 1};
                   float deltaMass{-1.};
                   isSelectedDstar = isDstarSelected(pVecTrackNeg1, pVecTrackPos1, pVecTrackNeg2, cutStatus, deltaMass); // we do not compute the D* decay vertex at this stage because we are not interested in applying topological selections
                   if (isSelectedDstar) {
-                    rowTrackIndexDstar(thisCollId, trackNeg2.globalIndex(), rowTrackIndexProng2.lastIndex());
+                    rowTrackIndexDstar(thisCollId, globalIndexNeg2, rowTrackIndexProng2.lastIndex());
                     if (fillHistograms) {
                       registry.fill(HIST("hMassDstarToD0Pi"), deltaMass);
                     }
@@ -2194,9 +2518,10 @@ struct HfTrackIndexSkimCreator {
               // preselection of 3-prong candidates
               int isSelected3ProngCand = n3ProngBit;
               if (do3Prong && TESTBIT(isSelProngNeg2, CandidateType::Cand3Prong) && (sel3ProngStatusPos1 && sel3ProngStatusNeg1)) {
-                if (thisCollId != trackNeg2.collisionId() && !propagatedNeg2) { // this is not the "default" collision for this track and we still did not re-propagate it, we have to re-propagate it
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarNeg2, 2.f, noMatCorr, &dcaInfoNeg2);
-                  getPxPyPz(trackParVarNeg2, pVecTrackNeg2);
+                nTriplets3ProngAttempted++;
+                if (applyPreFilter3Prong && !passPreFilter3ProngNeg[iNeg2]) {
+                  nTriplets3ProngPruned++;
+                  continue;
                 }
 
                 if (debug) {
@@ -2209,6 +2534,9 @@ struct HfTrackIndexSkimCreator {
 
                 // 3-prong preselections
                 is3ProngPreselected(pVecTrackNeg1, pVecTrackPos1, pVecTrackNeg2, cutStatus3Prong, whichHypo3Prong, isSelected3ProngCand);
+                if (isSelected3ProngCand > 0) {
+                  nTriplets3ProngPreselected++;
+                }
                 if (!debug && isSelected3ProngCand == 0) {
                   continue;
                 }
@@ -2229,16 +2557,16 @@ struct HfTrackIndexSkimCreator {
                   registry.fill(HIST("PvRefit/verticesPerCandidate"), 1);
                 }
                 int nCandContr = 3;
-                auto trackFirstIt = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), trackPos1.globalIndex());
-                auto trackSecondIt = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), trackNeg1.globalIndex());
-                auto trackThirdIt = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), trackNeg2.globalIndex());
+                auto trackFirstIt = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), globalIndexPos1);
+                auto trackSecondIt = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), globalIndexNeg1);
+                auto trackThirdIt = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), globalIndexNeg2);
                 bool isTrackFirstContr = true;
                 bool isTrackSecondContr = true;
                 bool isTrackThirdContr = true;
                 if (trackFirstIt == vecPvContributorGlobId.end()) {
                   /// This track did not contribute to the original PV refit
                   if (debugPvRefit) {
-                    LOG(info) << "--- [3 prong] trackPos1 with globalIndex " << trackPos1.globalIndex() << " was not a PV contributor";
+                    LOG(info) << "--- [3 prong] trackPos1 with globalIndex " << globalIndexPos1 << " was not a PV contributor";
                   }
                   nCandContr--;
                   isTrackFirstContr = false;
@@ -2246,7 +2574,7 @@ struct HfTrackIndexSkimCreator {
                 if (trackSecondIt == vecPvContributorGlobId.end()) {
                   /// This track did not contribute to the original PV refit
                   if (debugPvRefit) {
-                    LOG(info) << "--- [3 prong] trackNeg1 with globalIndex " << trackNeg1.globalIndex() << " was not a PV contributor";
+                    LOG(info) << "--- [3 prong] trackNeg1 with globalIndex " << globalIndexNeg1 << " was not a PV contributor";
                   }
                   nCandContr--;
                   isTrackSecondContr = false;
@@ -2254,7 +2582,7 @@ struct HfTrackIndexSkimCreator {
                 if (trackThirdIt == vecPvContributorGlobId.end()) {
                   /// This track did not contribute to the original PV refit
                   if (debugPvRefit) {
-                    LOG(info) << "--- [3 prong] trackNeg2 with globalIndex " << trackNeg2.globalIndex() << " was not a PV contributor";
+                    LOG(info) << "--- [3 prong] trackNeg2 with globalIndex " << globalIndexNeg2 << " was not a PV contributor";
                   }
                   nCandContr--;
                   isTrackThirdContr = false;
@@ -2263,13 +2591,13 @@ struct HfTrackIndexSkimCreator {
                 // Fill a vector with global ID of candidate daughters that are contributors
                 std::vector<int64_t> vecCandPvContributorGlobId = {};
                 if (isTrackFirstContr) {
-                  vecCandPvContributorGlobId.push_back(trackPos1.globalIndex());
+                  vecCandPvContributorGlobId.push_back(globalIndexPos1);
                 }
                 if (isTrackSecondContr) {
-                  vecCandPvContributorGlobId.push_back(trackNeg1.globalIndex());
+                  vecCandPvContributorGlobId.push_back(globalIndexNeg1);
                 }
                 if (isTrackThirdContr) {
-                  vecCandPvContributorGlobId.push_back(trackNeg2.globalIndex());
+                  vecCandPvContributorGlobId.push_back(globalIndexNeg2);
                 }
 
                 if (nCandContr == 3 || nCandContr == 2) {
@@ -2288,16 +2616,16 @@ struct HfTrackIndexSkimCreator {
                   }
                   if (isTrackFirstContr && !isTrackSecondContr && !isTrackThirdContr) {
                     /// the first daughter is contributor, the second and the third are not
-                    pvRefitCoord3Prong1Pos2Neg = {trackPos1.pvRefitX(), trackPos1.pvRefitY(), trackPos1.pvRefitZ()};
-                    pvRefitCovMatrix3Prong1Pos2Neg = {trackPos1.pvRefitSigmaX2(), trackPos1.pvRefitSigmaXY(), trackPos1.pvRefitSigmaY2(), trackPos1.pvRefitSigmaXZ(), trackPos1.pvRefitSigmaYZ(), trackPos1.pvRefitSigmaZ2()};
+                    pvRefitCoord3Prong1Pos2Neg = prongsPos.pvRefitCoord[iPos1];
+                    pvRefitCovMatrix3Prong1Pos2Neg = prongsPos.pvRefitCovMatrix[iPos1];
                   } else if (!isTrackFirstContr && isTrackSecondContr && !isTrackThirdContr) {
                     /// the second daughter is contributor, the first and the third are not
-                    pvRefitCoord3Prong1Pos2Neg = {trackNeg1.pvRefitX(), trackNeg1.pvRefitY(), trackNeg1.pvRefitZ()};
-                    pvRefitCovMatrix3Prong1Pos2Neg = {trackNeg1.pvRefitSigmaX2(), trackNeg1.pvRefitSigmaXY(), trackNeg1.pvRefitSigmaY2(), trackNeg1.pvRefitSigmaXZ(), trackNeg1.pvRefitSigmaYZ(), trackNeg1.pvRefitSigmaZ2()};
+                    pvRefitCoord3Prong1Pos2Neg = prongsNeg.pvRefitCoord[iNeg1];
+                    pvRefitCovMatrix3Prong1Pos2Neg = prongsNeg.pvRefitCovMatrix[iNeg1];
                   } else if (!isTrackFirstContr && !isTrackSecondContr && isTrackThirdContr) {
                     /// the third daughter is contributor, the first and the second are not
-                    pvRefitCoord3Prong1Pos2Neg = {trackNeg2.pvRefitX(), trackNeg2.pvRefitY(), trackNeg2.pvRefitZ()};
-                    pvRefitCovMatrix3Prong1Pos2Neg = {trackNeg2.pvRefitSigmaX2(), trackNeg2.pvRefitSigmaXY(), trackNeg2.pvRefitSigmaY2(), trackNeg2.pvRefitSigmaXZ(), trackNeg2.pvRefitSigmaYZ(), trackNeg2.pvRefitSigmaZ2()};
+                    pvRefitCoord3Prong1Pos2Neg = prongsNeg.pvRefitCoord[iNeg2];
+                    pvRefitCovMatrix3Prong1Pos2Neg = prongsNeg.pvRefitCovMatrix[iNeg2];
                   }
                 } else {
                   /// 0 contributors among the HF candidate daughters
@@ -2322,6 +2650,7 @@ struct HfTrackIndexSkimCreator {
               if (df3.process(trackParVarNeg1, trackParVarPos1, trackParVarNeg2) == 0) {
                 continue;
               }
+              nTriplets3ProngFitted++;
               // get secondary vertex
               const auto& secondaryVertex3 = df3.getPCACandidate();
               // get track momenta
@@ -2340,12 +2669,21 @@ struct HfTrackIndexSkimCreator {
               }
 
               // fill table row
-              rowTrackIndexProng3(thisCollId, trackNeg1.globalIndex(), trackPos1.globalIndex(), trackNeg2.globalIndex(), isSelected3ProngCand);
+              rowTrackIndexProng3(thisCollId, globalIndexNeg1, globalIndexPos1, globalIndexNeg2, isSelected3ProngCand);
               // fill table row of coordinates of PV refit
               if constexpr (doPvRefit) {
                 rowProng3PVrefit(pvRefitCoord3Prong1Pos2Neg[0], pvRefitCoord3Prong1Pos2Neg[1], pvRefitCoord3Prong1Pos2Neg[2],
                                  pvRefitCovMatrix3Prong1Pos2Neg[0], pvRefitCovMatrix3Prong1Pos2Neg[1], pvRefitCovMatrix3Prong1Pos2Neg[2], pvRefitCovMatrix3Prong1Pos2Neg[3], pvRefitCovMatrix3Prong1Pos2Neg[4], pvRefitCovMatrix3Prong1Pos2Neg[5]);
               }
+              if (fillFitCache) {
+                // fill table row with the fitted secondary vertex, reusable only if the prongs were not re-propagated to this collision
+                auto covMatrixPca = df3.calcPCACovMatrixFlat();
+                bool isFitReusable = !prongsNeg.isPropagatedToColl[iNeg1] && !prongsPos.isPropagatedToColl[iPos1] && !prongsNeg.isPropagatedToColl[iNeg2];
+                rowProng3FitCache(isFitReusable ? fitterConfigHash : 0u,
+                                  secondaryVertex3[0], secondaryVertex3[1], secondaryVertex3[2],
+                                  covMatrixPca[0], covMatrixPca[1], covMatrixPca[2], covMatrixPca[3], covMatrixPca[4], covMatrixPca[5],
+                                  df3.getChi2AtPCACandidate(), df3.getTrack(0).getX(), df3.getTrack(1).getX(), df3.getTrack(2).getX());
+              }
 
               if (debug) {
                 int Prong3CutStatus[kN3ProngDecays];
@@ -2418,6 +2756,10 @@ struct HfTrackIndexSkimCreator {
         registry.fill(HIST("hNCand3Prong"), nCand3);
         registry.fill(HIST("hNCand2ProngVsNTracks"), nTracks, nCand2);
         registry.fill(HIST("hNCand3ProngVsNTracks"), nTracks, nCand3);
+        registry.fill(HIST("hTriplets3Prong"), 1, nTriplets3ProngAttempted);
+        registry.fill(HIST("hTriplets3Prong"), 2, nTriplets3ProngPruned);
+        registry.fill(HIST("hTriplets3Prong"), 3, nTriplets3ProngPreselected);
+        registry.fill(HIST("hTriplets3Prong"), 4, nTriplets3ProngFitted);
       }
     }
   } /// end of run2And3Prongs function
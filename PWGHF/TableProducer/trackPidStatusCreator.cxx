@@ -0,0 +1,95 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file trackPidStatusCreator.cxx
+/// \brief Evaluation of the track PID statuses used by the HF candidate selectors, once per track
+///
+/// The TrackSelectorPID statuses of all the combinations of detectors are packed in the HfPidStatusTrack table,
+/// which the candidate selectors read by the prong indices instead of evaluating the PID for each candidate.
+
+#include "Framework/AnalysisTask.h"
+#include "Framework/runDataProcessing.h"
+
+#include "Common/Core/TrackSelectorPID.h"
+
+#include "PWGHF/DataModel/CandidateReconstructionTables.h"
+
+using namespace o2;
+using namespace o2::aod::hf_pid_status;
+using namespace o2::framework;
+
+/// Struct for the evaluation of the track PID statuses
+struct HfTrackPidStatusCreator {
+  Produces<aod::HfPidStatusTrack> rowPidStatusTrack;
+
+  // TPC PID
+  Configurable<double> ptPidTpcMin{"ptPidTpcMin", 0.15, "Lower bound of track pT for TPC PID"};
+  Configurable<double> ptPidTpcMax{"ptPidTpcMax", 5., "Upper bound of track pT for TPC PID"};
+  Configurable<double> nSigmaTpcMax{"nSigmaTpcMax", 3., "Nsigma cut on TPC only"};
+  Configurable<double> nSigmaTpcCombinedMax{"nSigmaTpcCombinedMax", 5., "Nsigma cut on TPC combined with TOF"};
+  // TOF PID
+  Configurable<double> ptPidTofMin{"ptPidTofMin", 0.15, "Lower bound of track pT for TOF PID"};
+  Configurable<double> ptPidTofMax{"ptPidTofMax", 5., "Upper bound of track pT for TOF PID"};
+  Configurable<double> nSigmaTofMax{"nSigmaTofMax", 3., "Nsigma cut on TOF only"};
+  Configurable<double> nSigmaTofCombinedMax{"nSigmaTofCombinedMax", 5., "Nsigma cut on TOF combined with TPC"};
+
+  TrackSelectorPi selectorPion;
+  TrackSelectorKa selectorKaon;
+  TrackSelectorPr selectorProton;
+
+  using TracksPid = soa::Join<aod::TracksWExtra, aod::TracksPidPi, aod::TracksPidKa, aod::TracksPidPr>;
+
+  void init(InitContext const&)
+  {
+    selectorPion.setRangePtTpc(ptPidTpcMin, ptPidTpcMax);
+    selectorPion.setRangeNSigmaTpc(-nSigmaTpcMax, nSigmaTpcMax);
+    selectorPion.setRangeNSigmaTpcCondTof(-nSigmaTpcCombinedMax, nSigmaTpcCombinedMax);
+    selectorPion.setRangePtTof(ptPidTofMin, ptPidTofMax);
+    selectorPion.setRangeNSigmaTof(-nSigmaTofMax, nSigmaTofMax);
+    selectorPion.setRangeNSigmaTofCondTpc(-nSigmaTofCombinedMax, nSigmaTofCombinedMax);
+    selectorKaon = selectorPion;
+    selectorProton = selectorPion;
+  }
+
+  /// Packs the PID statuses of one species
+  /// \param selector is the TrackSelectorPID of the species
+  /// \param track is the track
+  /// \param species is the species (hf_pid_status::Species)
+  /// \param word is the packed word
+  template <typename TSelector, typename T>
+  void fillPidStatus(TSelector& selector, const T& track, int species, uint32_t& word)
+  {
+    int pidTpc = track.hasTPC() ? selector.statusTpc(track) : TrackSelectorPID::NotApplicable;
+    int pidTof = track.hasTOF() ? selector.statusTof(track) : TrackSelectorPID::NotApplicable;
+    setPidStatus(word, species, Combination::Tpc, pidTpc);
+    setPidStatus(word, species, Combination::Tof, pidTof);
+    setPidStatus(word, species, Combination::TpcOrTof, selector.statusTpcOrTof(track));
+    setPidStatus(word, species, Combination::TpcAndTof, selector.statusTpcAndTof(track));
+  }
+
+  void process(TracksPid const& tracks)
+  {
+    rowPidStatusTrack.reserve(tracks.size());
+    for (const auto& track : tracks) {
+      uint32_t pidStatus = 0;
+      fillPidStatus(selectorPion, track, Species::Pi, pidStatus);
+      fillPidStatus(selectorKaon, track, Species::Ka, pidStatus);
+      fillPidStatus(selectorProton, track, Species::Pr, pidStatus);
+      rowPidStatusTrack(pidStatus);
+    }
+  }
+};
+
+WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
+{
+  return WorkflowSpec{
+    adaptAnalysisTask<HfTrackPidStatusCreator>(cfgc)};
+}
@@ -16,6 +16,8 @@
 #define PWGHF_UTILS_UTILSANALYSIS_H_
 
 #include <algorithm> // std::upper_bound
+#include <cstddef>   // std::size_t
+#include <cstdint>   // uint32_t
 #include <iterator>  // std::distance
 
 namespace o2::analysis
@@ -36,6 +38,23 @@ int findBin(T1 const& binsPt, T2 value)
   }
   return std::distance(binsPt->begin(), std::upper_bound(binsPt->begin(), binsPt->end(), value)) - 1;
 }
+
+/// Computes a hash of the DCAFitterN configuration.
+/// Used to check that a secondary vertex fitted in the skimming can be reused by the candidate creators.
+/// \note The magnetic field is not included, since it is taken from the CCDB in both cases.
+/// \return non-zero FNV-1a hash of the fitter settings
+inline uint32_t getDcaFitterConfigHash(bool propagateToPCA, bool useAbsDCA, bool useWeightedFinalPCA,
+                                       double maxR, double maxDZIni, double minParamChange, double minRelChi2Change)
+{
+  const double settings[] = {static_cast<double>(propagateToPCA), static_cast<double>(useAbsDCA), static_cast<double>(useWeightedFinalPCA),
+                             maxR, maxDZIni, minParamChange, minRelChi2Change};
+  const auto* bytes = reinterpret_cast<const unsigned char*>(settings);
+  uint32_t hash = 2166136261u;
+  for (std::size_t iByte = 0; iByte < sizeof(settings); ++iByte) {
+    hash = (hash ^ bytes[iByte]) * 16777619u;
+  }
+  return hash == 0 ? 1 : hash;
+}
 } // namespace o2::analysis
 
 #endif // PWGHF_UTILS_UTILSANALYSIS_H_
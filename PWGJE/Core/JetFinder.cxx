@@ -13,6 +13,10 @@
 //
 // Author: Jochen Klein, Nima Zardoshti
 #include "PWGJE/Core/JetFinder.h"
+
+#include <algorithm>
+#include <thread>
+
 #include "Framework/Logger.h"
 
 /// Sets the jet finding parameters
@@ -103,3 +107,102 @@ fastjet::ClusterSequenceArea JetFinder::findJets(std::vector<fastjet::PseudoJet>
   }
   return clusterSeq;
 }
+
+/// Jet definition and jet selection for a given radius, as set by setParams
+void JetFinder::getJetParams(float R, fastjet::JetDefinition& jetDefR, fastjet::Selector& selJetsR) const
+{
+  float jetEtaMinR = jetEtaMin;
+  float jetEtaMaxR = jetEtaMax;
+  if (jetEtaDefault) {
+    jetEtaMinR = etaMin + R;
+    jetEtaMaxR = etaMax - R;
+    if (isReclustering || isTriggering) {
+      jetEtaMinR -= R;
+      jetEtaMaxR += R;
+    }
+  }
+  jetDefR = fastjet::JetDefinition(algorithm, isReclustering ? 5.0 * R : R, recombScheme, strategy);
+  selJetsR = fastjet::SelectorPtRange(jetPtMin, jetPtMax) && fastjet::SelectorEtaRange(jetEtaMinR, jetEtaMaxR) && fastjet::SelectorPhiRange(jetPhiMin, jetPhiMax);
+}
+
+/// Performs jet finding for several jet radii at once
+/// \note the input particle list is passed by reference
+/// \param inputParticles vector of input particles/tracks
+/// \param jetRadii jet radii
+/// \param jets vectors of jets to be filled, one per radius
+/// \return cluster sequences needed to access constituents, one per radius
+std::vector<std::unique_ptr<fastjet::ClusterSequenceActiveAreaExplicitGhosts>> JetFinder::findJetsMultiR(std::vector<fastjet::PseudoJet>& inputParticles, const std::vector<double>& jetRadii, std::vector<std::vector<fastjet::PseudoJet>>& jets)
+{
+  if (areaType != fastjet::active_area && areaType != fastjet::active_area_explicit_ghosts) {
+    LOGF(fatal, "only active areas are supported when sharing ghosts between jet radii, use findJets for each radius instead!");
+  }
+  // quantities which do not depend on the jet radius: ghosts and background
+  setParams();
+  setBkgE();
+  if (isReclustering) {
+    jetR = jetR / 5.0;
+  }
+  if (bkgE) {
+    bkgE->set_particles(inputParticles);
+    setSub();
+    bkgE->rho(); // the estimate is computed here once and cached for all the radii
+  }
+  if (constituentSub) {
+    inputParticles = constituentSub->subtract_event(inputParticles);
+  }
+  ghosts.clear();
+  double ghostAreaActual = 0.;
+  if (ghostRepeatN > 0) {
+    ghostAreaSpec.add_ghosts(ghosts);
+    ghostAreaActual = ghostAreaSpec.actual_ghost_area();
+  }
+
+  const int nR = jetRadii.size();
+  std::vector<std::unique_ptr<fastjet::ClusterSequenceActiveAreaExplicitGhosts>> clusterSeqs(nR);
+  jets.resize(nR);
+  std::vector<fastjet::Selector> selJetsR(nR);
+  auto findJetsR = [&](int iR) {
+    fastjet::JetDefinition jetDefR;
+    getJetParams(jetRadii[iR], jetDefR, selJetsR[iR]);
+    clusterSeqs[iR] = std::make_unique<fastjet::ClusterSequenceActiveAreaExplicitGhosts>(inputParticles, jetDefR, ghosts, ghostAreaActual);
+    jets[iR] = (!fastjet::SelectorIsPureGhost())(clusterSeqs[iR]->inclusive_jets());
+  };
+
+  int nThreadsUsed = std::min(nThreads, nR);
+#ifndef FASTJET_HAVE_THREAD_SAFETY
+  // the input particles share their user info, whose reference counts are only atomic in a thread-safe fastjet build
+  if (nThreadsUsed > 1) {
+    static bool warned = false;
+    if (!warned) {
+      LOGF(warning, "fastjet was built without thread safety, the jet radii are clustered in a single thread");
+      warned = true;
+    }
+    nThreadsUsed = 1;
+  }
+#endif
+  if (nThreadsUsed > 1) {
+    std::vector<std::thread> threads;
+    for (int iThread = 0; iThread < nThreadsUsed; iThread++) {
+      threads.emplace_back([&, iThread]() {
+        for (int iR = iThread; iR < nR; iR += nThreadsUsed) {
+          findJetsR(iR);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  } else {
+    for (int iR = 0; iR < nR; iR++) {
+      findJetsR(iR);
+    }
+  }
+  // the background estimator is not thread safe, the subtraction is done afterwards
+  for (int iR = 0; iR < nR; iR++) {
+    if (sub) {
+      jets[iR] = (*sub)(jets[iR]);
+    }
+    jets[iR] = sorted_by_pt(selJetsR[iR](jets[iR]));
+  }
+  return clusterSeqs;
+}
@@ -25,6 +25,7 @@
 
 #include "fastjet/PseudoJet.hh"
 #include "fastjet/ClusterSequenceArea.hh"
+#include "fastjet/ClusterSequenceActiveAreaExplicitGhosts.hh"
 #include "fastjet/AreaDefinition.hh"
 #include "fastjet/JetDefinition.hh"
 #include "fastjet/tools/JetMedianBackgroundEstimator.hh"
@@ -91,6 +92,9 @@ class JetFinder
   bool isReclustering;
   bool isTriggering;
 
+  bool shareGhosts; // find the jets of all radii with the same ghosts and background estimate, see findJetsMultiR
+  int nThreads;     // number of threads used to cluster the different radii in findJetsMultiR
+
   fastjet::JetAlgorithm algorithm;
   fastjet::RecombinationScheme recombScheme;
   fastjet::Strategy strategy;
@@ -139,6 +143,8 @@ class JetFinder
                                                                                                                  constSubRMax(0.6),
                                                                                                                  isReclustering(false),
                                                                                                                  isTriggering(false),
+                                                                                                                 shareGhosts(false),
+                                                                                                                 nThreads(1),
                                                                                                                  algorithm(fastjet::antikt_algorithm),
                                                                                                                  recombScheme(fastjet::E_scheme),
                                                                                                                  strategy(fastjet::Best),
@@ -171,6 +177,17 @@ class JetFinder
   /// \return ClusterSequenceArea object needed to access constituents
   fastjet::ClusterSequenceArea findJets(std::vector<fastjet::PseudoJet>& inputParticles, std::vector<fastjet::PseudoJet>& jets); // ideally find a way of passing the cluster sequence as a reeference
 
+  /// Performs jet finding for several jet radii at once
+  /// The background estimate (and constituent subtraction) and the ghosts used for the jet areas are computed once and shared
+  /// by all the radii, which are clustered in parallel if nThreads > 1 and fastjet is built with thread safety (FASTJET_HAVE_THREAD_SAFETY).
+  /// Only active areas and a single ghost repetition are supported
+  /// \note the input particle list is passed by reference
+  /// \param inputParticles vector of input particles/tracks
+  /// \param jetRadii jet radii
+  /// \param jets vectors of jets to be filled, one per radius, without pure ghost jets
+  /// \return cluster sequences needed to access constituents (including ghosts, see PseudoJet::is_pure_ghost), one per radius
+  std::vector<std::unique_ptr<fastjet::ClusterSequenceActiveAreaExplicitGhosts>> findJetsMultiR(std::vector<fastjet::PseudoJet>& inputParticles, const std::vector<double>& jetRadii, std::vector<std::vector<fastjet::PseudoJet>>& jets);
+
  private:
   // void setParams();
   // void setBkgSub();
@@ -178,6 +195,11 @@ class JetFinder
   std::unique_ptr<fastjet::Subtractor> sub;
   std::unique_ptr<fastjet::contrib::ConstituentSubtractor> constituentSub;
 
+  std::vector<fastjet::PseudoJet> ghosts; //! ghosts shared by all the radii in findJetsMultiR
+
+  /// Jet definition and jet selection for a given radius, as set by setParams
+  void getJetParams(float R, fastjet::JetDefinition& jetDefR, fastjet::Selector& selJetsR) const;
+
   ClassDefNV(JetFinder, 1);
 };
 
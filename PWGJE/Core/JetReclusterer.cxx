@@ -0,0 +1,134 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+// jet reclustering
+//
+// Author: Nima Zardoshti
+#include "PWGJE/Core/JetReclusterer.h"
+
+#include <algorithm>
+#include <numeric>
+
+/// Reclusters the constituents of a jet with a plain cluster sequence
+/// \param constituents constituents of the jet
+/// \return hardest reclustered jet
+fastjet::PseudoJet JetReclusterer::recluster(const std::vector<fastjet::PseudoJet>& constituents)
+{
+  clusterSeq = std::make_unique<fastjet::ClusterSequence>(constituents, fastjet::JetDefinition(algorithm, jetR, recombScheme, strategy));
+  std::vector<fastjet::PseudoJet> jets = sorted_by_pt(clusterSeq->inclusive_jets());
+  if (jets.empty()) {
+    return fastjet::PseudoJet();
+  }
+  return jets[0];
+}
+
+/// Adds a splitting to the primary Lund plane
+/// \param branch1 harder branch
+/// \param branch2 softer branch
+void JetReclusterer::addSplitting(const fastjet::PseudoJet& branch1, const fastjet::PseudoJet& branch2)
+{
+  LundSplitting splitting;
+  splitting.pt = branch1.perp() + branch2.perp();
+  splitting.z = branch2.perp() / splitting.pt;
+  splitting.deltaR = branch1.delta_R(branch2);
+  splitting.kt = branch2.perp() * splitting.deltaR;
+  lundPlane.push_back(splitting);
+}
+
+/// Declusters the constituents of a jet along the harder branch
+/// \param constituents constituents of the jet
+/// \return splittings of the primary Lund plane
+const std::vector<JetReclusterer::LundSplitting>& JetReclusterer::findPrimaryLundPlane(const std::vector<fastjet::PseudoJet>& constituents)
+{
+  lundPlane.clear();
+  if (constituents.empty()) {
+    return lundPlane;
+  }
+  if (algorithm == fastjet::cambridge_algorithm && recombScheme == fastjet::E_scheme && jetR == fastjet::JetDefinition::max_allowable_R && static_cast<int>(constituents.size()) <= nMaxInternal) {
+    clusterInternalCA(constituents);
+    int node = caNodes.size() - 1;
+    while (caChildren[node].first >= 0) {
+      int branch1 = caChildren[node].first;
+      int branch2 = caChildren[node].second;
+      if (caNodes[branch1].perp() < caNodes[branch2].perp()) {
+        std::swap(branch1, branch2);
+      }
+      addSplitting(caNodes[branch1], caNodes[branch2]);
+      node = branch1;
+    }
+    return lundPlane;
+  }
+
+  fastjet::PseudoJet daughterSubJet = recluster(constituents);
+  fastjet::PseudoJet parentSubJet1;
+  fastjet::PseudoJet parentSubJet2;
+  while (daughterSubJet.has_parents(parentSubJet1, parentSubJet2)) {
+    if (parentSubJet1.perp() < parentSubJet2.perp()) {
+      std::swap(parentSubJet1, parentSubJet2);
+    }
+    addSplitting(parentSubJet1, parentSubJet2);
+    daughterSubJet = parentSubJet1;
+  }
+  return lundPlane;
+}
+
+/// Cambridge/Aachen clustering of all the constituents into one jet, with E-scheme recombination
+/// The closest pair in the rapidity-azimuth plane is merged at each step, the merging history is stored in caNodes and caChildren
+/// \param constituents constituents of the jet
+void JetReclusterer::clusterInternalCA(const std::vector<fastjet::PseudoJet>& constituents)
+{
+  const int n = constituents.size();
+  caNodes.assign(constituents.begin(), constituents.end());
+  caNodes.reserve(2 * n - 1);
+  caChildren.assign(n, {-1, -1});
+  caSlots.resize(n);
+  std::iota(caSlots.begin(), caSlots.end(), 0);
+  caDistances.resize(n * n);
+  for (int i = 1; i < n; i++) {
+    for (int j = 0; j < i; j++) {
+      caDistances[i * n + j] = caNodes[i].squared_distance(caNodes[j]);
+    }
+  }
+
+  for (int nActive = n; nActive > 1; nActive--) {
+    int iMin = 1;
+    int jMin = 0;
+    double distanceMin = caDistances[n];
+    for (int i = 1; i < nActive; i++) {
+      for (int j = 0; j < i; j++) {
+        if (caDistances[i * n + j] < distanceMin) {
+          distanceMin = caDistances[i * n + j];
+          iMin = i;
+          jMin = j;
+        }
+      }
+    }
+    // the merged branch replaces slot jMin, slot iMin is filled with the last active slot
+    caNodes.push_back(caNodes[caSlots[jMin]] + caNodes[caSlots[iMin]]);
+    caChildren.emplace_back(caSlots[jMin], caSlots[iMin]);
+    caSlots[jMin] = caNodes.size() - 1;
+    int last = nActive - 1;
+    if (iMin != last) {
+      caSlots[iMin] = caSlots[last];
+      for (int k = 0; k < last; k++) {
+        if (k != iMin) {
+          caDistances[std::max(iMin, k) * n + std::min(iMin, k)] = caDistances[std::max(last, k) * n + std::min(last, k)];
+        }
+      }
+    }
+    const fastjet::PseudoJet& merged = caNodes.back();
+    for (int k = 0; k < last; k++) {
+      if (k != jMin) {
+        caDistances[std::max(jMin, k) * n + std::min(jMin, k)] = merged.squared_distance(caNodes[caSlots[k]]);
+      }
+    }
+  }
+}
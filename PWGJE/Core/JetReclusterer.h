@@ -0,0 +1,80 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file JetReclusterer.h
+/// \brief Reclustering of the constituents of a jet, without ghosts, and primary Lund plane declustering
+///
+/// \author Nima Zardoshti
+
+#ifndef PWGJE_CORE_JETRECLUSTERER_H_
+#define PWGJE_CORE_JETRECLUSTERER_H_
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "fastjet/PseudoJet.hh"
+#include "fastjet/ClusterSequence.hh"
+#include "fastjet/JetDefinition.hh"
+
+class JetReclusterer
+{
+ public:
+  /// Splitting of the primary Lund plane, the harder branch is the one followed by the declustering
+  struct LundSplitting {
+    float z;      // momentum fraction of the softer branch
+    float deltaR; // distance between the two branches in the rapidity-azimuth plane
+    float kt;     // transverse momentum of the softer branch relative to the harder branch, ptSoft * deltaR
+    float pt;     // transverse momentum of the parent
+  };
+
+  fastjet::JetAlgorithm algorithm;
+  fastjet::RecombinationScheme recombScheme;
+  fastjet::Strategy strategy;
+  double jetR;      // radius used for the reclustering, the default merges all the constituents into one jet
+  int nMaxInternal; // maximum number of constituents clustered with the internal C/A algorithm instead of fastjet (0: always use fastjet)
+
+  JetReclusterer() : algorithm(fastjet::cambridge_algorithm),
+                     recombScheme(fastjet::E_scheme),
+                     strategy(fastjet::Best),
+                     jetR(fastjet::JetDefinition::max_allowable_R),
+                     nMaxInternal(20)
+  {
+  }
+
+  /// Reclusters the constituents of a jet with a plain cluster sequence (no ghosts)
+  /// \param constituents constituents of the jet
+  /// \return hardest reclustered jet; its cluster sequence is kept until the next call
+  fastjet::PseudoJet recluster(const std::vector<fastjet::PseudoJet>& constituents);
+
+  /// Declusters the constituents of a jet along the harder branch
+  /// For the C/A algorithm and up to nMaxInternal constituents, the clustering is done internally without building a fastjet cluster sequence
+  /// \param constituents constituents of the jet
+  /// \return splittings of the primary Lund plane, starting from the widest one; the buffer is reused by the next call
+  const std::vector<LundSplitting>& findPrimaryLundPlane(const std::vector<fastjet::PseudoJet>& constituents);
+
+  const std::vector<LundSplitting>& getPrimaryLundPlane() const { return lundPlane; }
+
+ private:
+  void addSplitting(const fastjet::PseudoJet& branch1, const fastjet::PseudoJet& branch2);
+  void clusterInternalCA(const std::vector<fastjet::PseudoJet>& constituents);
+
+  std::unique_ptr<fastjet::ClusterSequence> clusterSeq;
+  std::vector<LundSplitting> lundPlane;
+
+  // buffers of the internal C/A clustering
+  std::vector<fastjet::PseudoJet> caNodes;     // constituents followed by the merged branches
+  std::vector<std::pair<int, int>> caChildren; // branches merged into each node, -1 for the constituents
+  std::vector<int> caSlots;                    // node held by each active slot
+  std::vector<double> caDistances;             // squared distances between the active slots, [i * n + j] with j < i
+};
+
+#endif // PWGJE_CORE_JETRECLUSTERER_H_
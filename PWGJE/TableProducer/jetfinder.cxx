@@ -65,6 +65,8 @@ struct JetFinderTask {
   Configurable<bool> DoTriggering{"DoTriggering", false, "used for the charged jet trigger to remove the eta constraint on the jet axis"};
   Configurable<bool> DoRhoAreaSub{"DoRhoAreaSub", false, "do rho area subtraction"};
   Configurable<bool> DoConstSub{"DoConstSub", false, "do constituent subtraction"};
+  Configurable<bool> shareGhostsAcrossRadii{"shareGhostsAcrossRadii", false, "cluster all the jet radii with the same ghosts and background estimate (single ghost repetition)"};
+  Configurable<int> nThreadsRadii{"nThreadsRadii", 1, "number of threads used to cluster the jet radii when sharing the ghosts"};
 
   Service<o2::framework::O2DatabasePDG> pdgDatabase;
   std::string trackSelection;
@@ -100,6 +102,8 @@ struct JetFinderTask {
     jetFinder.recombScheme = static_cast<fastjet::RecombinationScheme>(static_cast<int>(jetRecombScheme));
     jetFinder.ghostArea = jetGhostArea;
     jetFinder.ghostRepeatN = ghostRepeat;
+    jetFinder.shareGhosts = shareGhostsAcrossRadii;
+    jetFinder.nThreads = nThreadsRadii;
     if (DoTriggering) {
       jetFinder.isTriggering = true;
     }
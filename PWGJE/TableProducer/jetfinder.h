@@ -139,53 +139,79 @@ bool analyseCandidateMC(std::vector<fastjet::PseudoJet>& inputParticles, int can
   return analyseCandidate(inputParticles, candMass, candPtMin, candPtMax, candYMin, candYMax, candidate);
 }
 
+// function that fills the tables for a jet
+// ghosts are only present when the jets are found with explicit ghosts, see JetFinder::findJetsMultiR
+template <typename T, typename U, typename V, typename W>
+void fillJetTables(fastjet::PseudoJet const& jet, double R, T const& collision, U& jetsTable, V& constituentsTable, W& constituentsSubTable, bool DoConstSub, bool doHFJetFinding)
+{
+  // auto candidatepT = 0.0;
+  bool isHFJet = false;
+  if (doHFJetFinding) {
+    for (const auto& constituent : jet.constituents()) {
+      if (constituent.is_pure_ghost()) {
+        continue;
+      }
+      if (constituent.template user_info<FastJetUtilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::candidateHF)) {
+        isHFJet = true;
+        // candidatepT = constituent.pt();
+        break;
+      }
+    }
+    if (!isHFJet) {
+      return;
+    }
+  }
+  std::vector<int> trackconst;
+  std::vector<int> candconst;
+  std::vector<int> clusterconst;
+  jetsTable(collision.globalIndex(), jet.pt(), jet.eta(), jet.phi(),
+            jet.E(), jet.m(), jet.area(), std::round(R * 100));
+  for (const auto& constituent : sorted_by_pt(jet.constituents())) {
+    if (constituent.is_pure_ghost()) {
+      continue;
+    }
+    // need to add seperate thing for constituent subtraction
+    if (DoConstSub) { // FIXME: needs to be addressed in Haadi's PR
+      constituentsSubTable(jetsTable.lastIndex(), constituent.pt(), constituent.eta(), constituent.phi(),
+                           constituent.E(), constituent.m(), constituent.user_index());
+    }
+
+    if (constituent.template user_info<FastJetUtilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::track)) {
+      trackconst.push_back(constituent.template user_info<FastJetUtilities::fastjet_user_info>().getIndex());
+    }
+    if (constituent.template user_info<FastJetUtilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::cluster)) {
+      clusterconst.push_back(constituent.template user_info<FastJetUtilities::fastjet_user_info>().getIndex());
+    }
+    if (constituent.template user_info<FastJetUtilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::candidateHF)) {
+      candconst.push_back(constituent.template user_info<FastJetUtilities::fastjet_user_info>().getIndex());
+    }
+  }
+  constituentsTable(jetsTable.lastIndex(), trackconst, clusterconst, candconst);
+}
+
 // function that calls the jet finding and fills the relevant tables
 template <typename T, typename U, typename V, typename W>
 void findJets(JetFinder& jetFinder, std::vector<fastjet::PseudoJet>& inputParticles, std::vector<double> jetRadius, T const& collision, U& jetsTable, V& constituentsTable, W& constituentsSubTable, bool DoConstSub, bool doHFJetFinding = false)
 {
-  // auto candidatepT = 0.0;
   auto jetRValues = static_cast<std::vector<double>>(jetRadius);
+  // the shared ghosts are only supported with active areas, the other area types fall back to one jet finding per radius
+  if (jetFinder.shareGhosts && (jetFinder.areaType == fastjet::active_area || jetFinder.areaType == fastjet::active_area_explicit_ghosts)) {
+    // all the radii are clustered at once, the tables are then filled radius by radius
+    std::vector<std::vector<fastjet::PseudoJet>> jets;
+    auto clusterSeqs = jetFinder.findJetsMultiR(inputParticles, jetRValues, jets);
+    for (std::size_t iR = 0; iR < jetRValues.size(); iR++) {
+      for (const auto& jet : jets[iR]) {
+        fillJetTables(jet, jetRValues[iR], collision, jetsTable, constituentsTable, constituentsSubTable, DoConstSub, doHFJetFinding);
+      }
+    }
+    return;
+  }
   for (auto R : jetRValues) {
     jetFinder.jetR = R;
     std::vector<fastjet::PseudoJet> jets;
     fastjet::ClusterSequenceArea clusterSeq(jetFinder.findJets(inputParticles, jets));
     for (const auto& jet : jets) {
-      bool isHFJet = false;
-      if (doHFJetFinding) {
-        for (const auto& constituent : jet.constituents()) {
-          if (constituent.template user_info<FastJetUtilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::candidateHF)) {
-            isHFJet = true;
-            // candidatepT = constituent.pt();
-            break;
-          }
-        }
-        if (!isHFJet) {
-          continue;
-        }
-      }
-      std::vector<int> trackconst;
-      std::vector<int> candconst;
-      std::vector<int> clusterconst;
-      jetsTable(collision.globalIndex(), jet.pt(), jet.eta(), jet.phi(),
-                jet.E(), jet.m(), jet.area(), std::round(R * 100));
-      for (const auto& constituent : sorted_by_pt(jet.constituents())) {
-        // need to add seperate thing for constituent subtraction
-        if (DoConstSub) { // FIXME: needs to be addressed in Haadi's PR
-          constituentsSubTable(jetsTable.lastIndex(), constituent.pt(), constituent.eta(), constituent.phi(),
-                               constituent.E(), constituent.m(), constituent.user_index());
-        }
-
-        if (constituent.template user_info<FastJetUtilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::track)) {
-          trackconst.push_back(constituent.template user_info<FastJetUtilities::fastjet_user_info>().getIndex());
-        }
-        if (constituent.template user_info<FastJetUtilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::cluster)) {
-          clusterconst.push_back(constituent.template user_info<FastJetUtilities::fastjet_user_info>().getIndex());
-        }
-        if (constituent.template user_info<FastJetUtilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::candidateHF)) {
-          candconst.push_back(constituent.template user_info<FastJetUtilities::fastjet_user_info>().getIndex());
-        }
-      }
-      constituentsTable(jetsTable.lastIndex(), trackconst, clusterconst, candconst);
+      fillJetTables(jet, R, collision, jetsTable, constituentsTable, constituentsSubTable, DoConstSub, doHFJetFinding);
     }
   }
 }
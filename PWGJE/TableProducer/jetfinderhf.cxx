@@ -91,6 +91,8 @@ struct JetFinderHFTask {
   Configurable<int> jetRecombScheme{"jetRecombScheme", 0, "jet recombination scheme. 0 = E-scheme, 1 = pT-scheme, 2 = pT2-scheme"};
   Configurable<float> jetGhostArea{"jetGhostArea", 0.005, "jet ghost area"};
   Configurable<int> ghostRepeat{"ghostRepeat", 1, "set to 0 to gain speed if you dont need area calculation"};
+  Configurable<bool> shareGhostsAcrossRadii{"shareGhostsAcrossRadii", false, "cluster all the jet radii with the same ghosts and background estimate (single ghost repetition)"};
+  Configurable<int> nThreadsRadii{"nThreadsRadii", 1, "number of threads used to cluster the jet radii when sharing the ghosts"};
   Configurable<bool> DoRhoAreaSub{"DoRhoAreaSub", false, "do rho area subtraction"};
   Configurable<bool> DoConstSub{"DoConstSub", false, "do constituent subtraction"};
 
@@ -131,6 +133,8 @@ struct JetFinderHFTask {
     jetFinder.recombScheme = static_cast<fastjet::RecombinationScheme>(static_cast<int>(jetRecombScheme));
     jetFinder.ghostArea = jetGhostArea;
     jetFinder.ghostRepeatN = ghostRepeat;
+    jetFinder.shareGhosts = shareGhostsAcrossRadii;
+    jetFinder.nThreads = nThreadsRadii;
 
     if constexpr (std::is_same_v<std::decay_t<CandidateTableData>, CandidatesD0Data>) { // Note : need to be careful if configurable workflow options are added later
       candMass = pdg::MassD0;
@@ -15,7 +15,6 @@
 //
 
 #include "fastjet/PseudoJet.hh"
-#include "fastjet/ClusterSequenceArea.hh"
 
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
@@ -30,6 +29,7 @@
 #include "PWGJE/DataModel/Jet.h"
 #include "PWGJE/DataModel/JetSubstructure.h"
 #include "PWGJE/Core/JetFinder.h"
+#include "PWGJE/Core/JetReclusterer.h"
 #include "PWGJE/Core/FastJetUtilities.h"
 
 using namespace o2;
@@ -47,11 +47,11 @@ struct JetSubstructureTask {
 
   Configurable<float> zCut{"zCut", 0.1, "soft drop z cut"};
   Configurable<float> beta{"beta", 0.0, "soft drop beta"};
+  Configurable<int> nMaxConstituentsInternalCA{"nMaxConstituentsInternalCA", 20, "maximum number of constituents reclustered without fastjet (0: always use fastjet)"};
 
   Service<o2::framework::O2DatabasePDG> pdg;
   std::vector<fastjet::PseudoJet> jetConstituents;
-  std::vector<fastjet::PseudoJet> jetReclustered;
-  JetFinder jetReclusterer;
+  JetReclusterer jetReclusterer;
 
   void init(InitContext const&)
   {
@@ -62,40 +62,28 @@ struct JetSubstructureTask {
     hNsd.setObject(new TH2F("h_jet_nsd_jet_pt", ";n_{SD}; #it{p}_{T,jet} (GeV/#it{c})",
                             7, -0.5, 6.5, 200, 0.0, 200.0));
 
-    jetReclusterer.isReclustering = true;
     jetReclusterer.algorithm = fastjet::JetAlgorithm::cambridge_algorithm;
+    jetReclusterer.nMaxInternal = nMaxConstituentsInternalCA;
   }
 
   template <typename T>
   void jetReclustering(T const& jet)
   {
-    jetReclustered.clear();
-    fastjet::ClusterSequenceArea clusterSeq(jetReclusterer.findJets(jetConstituents, jetReclustered));
-    jetReclustered = sorted_by_pt(jetReclustered);
-    fastjet::PseudoJet daughterSubJet = jetReclustered[0];
-    fastjet::PseudoJet parentSubJet1;
-    fastjet::PseudoJet parentSubJet2;
     bool softDropped = false;
     auto nsd = 0.0;
     auto zg = -1.0;
     auto rg = -1.0;
-    while (daughterSubJet.has_parents(parentSubJet1, parentSubJet2)) {
-      if (parentSubJet1.perp() < parentSubJet2.perp()) {
-        std::swap(parentSubJet1, parentSubJet2);
-      }
-      auto z = parentSubJet2.perp() / (parentSubJet1.perp() + parentSubJet2.perp());
-      auto theta = parentSubJet1.delta_R(parentSubJet2);
-      if (z >= zCut * TMath::Power(theta / (jet.r() / 100.f), beta)) {
+    for (const auto& splitting : jetReclusterer.findPrimaryLundPlane(jetConstituents)) {
+      if (splitting.z >= zCut * TMath::Power(splitting.deltaR / (jet.r() / 100.f), beta)) {
         if (!softDropped) {
-          zg = z;
-          rg = theta;
+          zg = splitting.z;
+          rg = splitting.deltaR;
           hZg->Fill(zg, jet.pt());
           hRg->Fill(rg, jet.pt());
           softDropped = true;
         }
         nsd++;
       }
-      daughterSubJet = parentSubJet1;
     }
     hNsd->Fill(nsd, jet.pt());
     jetSubstructureTable(zg, rg, nsd);
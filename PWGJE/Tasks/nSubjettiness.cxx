@@ -26,6 +26,7 @@
 #include "PWGJE/DataModel/Jet.h"
 #include "PWGJE/Core/JetUtilities.h"
 #include "PWGJE/Core/JetFinder.h"
+#include "PWGJE/Core/JetReclusterer.h"
 #include "PWGJE/Core/FastJetUtilities.h"
 #include "fastjet/contrib/Nsubjettiness.hh"
 #include "fastjet/contrib/AxesDefinition.hh"
@@ -59,10 +60,12 @@ struct nSubJettiness {
   ConfigurableAxis NSubRatioBinning{"NSub-Ratio-binning", {50, 0.0f, 1.2f}, ""};
 
   std::vector<fastjet::PseudoJet> jetConstituents;
-  fastjet::ClusterSequence clusterSeq_pseudoJet;
+  JetReclusterer jetReclusterer;
 
   void init(InitContext const&)
   {
+    jetReclusterer.algorithm = fastjet::JetAlgorithm::kt_algorithm;
+
     AxisSpec ptAxis = {ptBinning, "#it{p}_{T} (GeV/c)"};
     AxisSpec DeltaRAxis = {DeltaRBinning, "#Delta R"};
     AxisSpec NSubRatioAxis = {NSubRatioBinning, "#tau_{2}/#tau_{1}"};
@@ -99,19 +102,17 @@ struct nSubJettiness {
     registry.get<TH1>(HIST("hErrorControl"))->GetXaxis()->SetBinLabel(2, "Single track groomed jet");
   }
 
-  // function that converts a jet from the O2Physics jet table into a pseudojet; the fastjet cluster sequence of the jet needs to be given as input and will be modified by the function to save the clustering information
+  // function that converts a jet from the O2Physics jet table into a pseudojet; the clustering information is kept by the reclusterer until the next jet is converted
   template <typename JetTableElement>
-  void jetToPseudoJet(JetTableElement const& jet, fastjet::PseudoJet& pseudoJet, std::vector<fastjet::PseudoJet> jetConstituents, fastjet::ClusterSequence& clusterSeqInput)
+  void jetToPseudoJet(JetTableElement const& jet, fastjet::PseudoJet& pseudoJet)
   {
+    jetConstituents.clear();
     for (auto& jetConstituent : jet.template tracks_as<TrackTable>()) {
       FastJetUtilities::fillTracks(jetConstituent, jetConstituents, jetConstituent.globalIndex());
     }
 
-    fastjet::JetDefinition jet_def(fastjet::JetAlgorithm::kt_algorithm, 2.5 * jet.r() / 100);
-    fastjet::ClusterSequence clusterSeq(jetConstituents, jet_def);
-
-    clusterSeqInput.transfer_from_sequence(clusterSeq);
-    pseudoJet = sorted_by_pt(clusterSeqInput.inclusive_jets())[0]; // returns the jet found by the reclustering with the largest pT; should be the one corresponding to the jet table element
+    jetReclusterer.jetR = 2.5 * jet.r() / 100;
+    pseudoJet = jetReclusterer.recluster(jetConstituents); // returns the jet found by the reclustering with the largest pT; should be the one corresponding to the jet table element
   }
 
   // function that returns the N-subjettiness ratio and the distance betewwen the two axes considered for tau2, in the form of a vector
@@ -151,8 +152,7 @@ struct nSubJettiness {
       registry.fill(HIST("hErrorControl"), -999);
     } else {
       fastjet::PseudoJet pseudoJet;
-      jetConstituents.clear();
-      jetToPseudoJet(jet, pseudoJet, jetConstituents, clusterSeq_pseudoJet);
+      jetToPseudoJet(jet, pseudoJet);
       std::vector<float> nSub_Kt_results = getNsubRatio21(pseudoJet, jet.r() / 100., fastjet::contrib::KT_Axes(), "Kt");
       std::vector<float> nSub_CA_results = getNsubRatio21(pseudoJet, jet.r() / 100., fastjet::contrib::CA_Axes(), "CA");
       std::vector<float> nSub_SD_results = getNsubRatio21(pseudoJet, jet.r() / 100., fastjet::contrib::CA_Axes(), "SD");
@@ -30,7 +30,7 @@ class DGSelector
   ~DGSelector() { delete fPDG; }
 
   template <typename CC, typename BCs, typename TCs, typename FWs>
-  int Print(DGCutparHolder diffCuts, CC& collision, BCs& bcRange, TCs& tracks, FWs& fwdtracks)
+  int Print(DGCutparHolder const& diffCuts, CC& collision, BCs& bcRange, TCs& tracks, FWs& fwdtracks)
   {
     LOGF(info, "Size of array %i", collision.size());
     return 1;
@@ -38,7 +38,7 @@ class DGSelector
 
   // Function to check if collisions passes DG filter
   template <typename CC, typename BCs, typename TCs, typename FWs>
-  int IsSelected(DGCutparHolder diffCuts, CC& collision, BCs& bcRange, TCs& tracks, FWs& fwdtracks)
+  int IsSelected(DGCutparHolder const& diffCuts, CC& collision, BCs& bcRange, TCs& tracks, FWs& fwdtracks)
   {
     LOGF(debug, "Collision %f", collision.collisionTime());
     LOGF(debug, "Number of close BCs: %i", bcRange.size());
@@ -51,6 +51,28 @@ class DGSelector
       }
     }
 
+    return IsSelectedTracks(diffCuts, collision, tracks, fwdtracks);
+  };
+
+  // Same as above, with the FIT activity of the compatible BCs taken from a FITActivityIndex
+  // bcRange is the range of compatible BCs as given by FITActivityIndex::compatibleBCRange
+  template <typename CC, typename TCs, typename FWs>
+  int IsSelected(DGCutparHolder const& diffCuts, CC& collision, udhelpers::FITActivityIndex const& fitIndex, std::pair<int64_t, int64_t> const& bcRange, TCs& tracks, FWs& fwdtracks)
+  {
+    LOGF(debug, "Number of close BCs: %i", bcRange.second - bcRange.first);
+
+    // Double Gap (DG) condition
+    if (!fitIndex.isClean(bcRange)) {
+      return 1;
+    }
+
+    return IsSelectedTracks(diffCuts, collision, tracks, fwdtracks);
+  };
+
+  // Selections of a collision which passed the Double Gap condition: forward tracks, tracks, PID, and invariant mass
+  template <typename CC, typename TCs, typename FWs>
+  int IsSelectedTracks(DGCutparHolder const& diffCuts, CC& collision, TCs& tracks, FWs& fwdtracks)
+  {
     // forward tracks
     LOGF(debug, "FwdTracks %i", fwdtracks.size());
     if (!diffCuts.withFwdTracks()) {
@@ -147,7 +169,7 @@ class DGSelector
 
   // Function to check if BC passes DG filter (without associated collision)
   template <typename BCs, typename TCs, typename FWs>
-  int IsSelected(DGCutparHolder diffCuts, BCs& bcRange, TCs& tracks, FWs& fwdtracks)
+  int IsSelected(DGCutparHolder const& diffCuts, BCs& bcRange, TCs& tracks, FWs& fwdtracks)
   {
     // check that there are no FIT signals in bcRange
     // Double Gap (DG) condition
@@ -16,8 +16,10 @@
 #ifndef PWGUD_CORE_UDHELPERS_H_
 #define PWGUD_CORE_UDHELPERS_H_
 
-#include <vector>
+#include <algorithm>
 #include <bitset>
+#include <utility>
+#include <vector>
 #include "TLorentzVector.h"
 #include "Framework/Logger.h"
 #include "DataFormatsFT0/Digit.h"
@@ -106,6 +108,25 @@ T compatibleBCs(uint64_t meanBC, int deltaBC, T const& bcs);
 template <typename I, typename T>
 T compatibleBCs(I& bcIter, uint64_t meanBC, int deltaBC, T const& bcs);
 
+// Index of the first BC with globalBC >= bcnum (bcs.size() if there is none).
+// The BCs table is sorted in globalBC, hence a binary search can be used.
+template <typename T>
+int64_t lowerBoundBC(uint64_t bcnum, T const& bcs)
+{
+  int64_t first = 0;
+  int64_t count = bcs.size();
+  while (count > 0) {
+    int64_t step = count / 2;
+    if (bcs.iteratorAt(first + step).globalBC() < bcnum) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  return first;
+}
+
 // In this variant of compatibleBCs the bcIter is ideally placed within
 // [minBC, maxBC], but it does not need to be. The range is given by meanBC +- delatBC.
 template <typename I, typename T>
@@ -203,7 +224,10 @@ template <typename T>
 T compatibleBCs(uint64_t meanBC, int deltaBC, T const& bcs)
 {
   // find BC with globalBC ~ meanBC
-  uint64_t ind = (uint64_t)(bcs.size() / 2);
+  uint64_t ind = lowerBoundBC(meanBC, bcs);
+  if (ind >= (uint64_t)bcs.size()) {
+    ind = bcs.size() - 1;
+  }
   auto bcIter = bcs.iteratorAt(ind);
 
   return compatibleBCs(bcIter, meanBC, deltaBC, bcs);
@@ -242,7 +266,7 @@ T MCcompatibleBCs(F const& collision, int ndt, T const& bcs, int nMinBCs = 7)
 // function to check if track provides good PID information
 // Checks the nSigma for any particle assumption to be within limits.
 template <typename TC>
-bool hasGoodPID(DGCutparHolder diffCuts, TC track)
+bool hasGoodPID(DGCutparHolder const& diffCuts, TC const& track)
 {
   // El, Mu, Pi, Ka, and Pr are considered
   // at least one nSigma must be within set limits
@@ -410,12 +434,99 @@ bool cleanFDD(T& bc, float maxFITtime, float limitA, float limitC)
 //  lims[4]: FDDC
 
 template <typename T>
-bool cleanFIT(T& bc, float maxFITtime, std::vector<float> lims)
+bool cleanFIT(T& bc, float maxFITtime, std::vector<float> const& lims)
 {
   return cleanFV0(bc, maxFITtime, lims[0]) &&
          cleanFT0(bc, maxFITtime, lims[1], lims[2]) &&
          cleanFDD(bc, maxFITtime, lims[3], lims[4]);
 }
+
+// -----------------------------------------------------------------------------
+// Per data frame index of the FIT activity in the BCs.
+// For every BC of the BCs table the decision of cleanFIT is stored in a bitmap, together with
+// the prefix counts of the BCs with FIT activity. The BCs compatible with a collision are
+// found with a binary search in the sorted global BCs, and the Double Gap condition of a
+// range of BCs is obtained from the difference of two prefix counts.
+class FITActivityIndex
+{
+ public:
+  // build the index for a BCs table, nothing is done if it was already built for this table and these cuts
+  template <typename T>
+  void build(T const& bcs, float maxFITtime, std::vector<float> const& lims)
+  {
+    if (isBuiltFor(bcs, maxFITtime, lims)) {
+      return;
+    }
+    int64_t nBCs = bcs.size();
+    mGlobalBCs.resize(nBCs);
+    mCleanBits.assign((nBCs + 63) / 64, 0);
+    mNActive.resize(nBCs + 1);
+    mNActive[0] = 0;
+    int64_t ind = 0;
+    for (auto bc : bcs) {
+      mGlobalBCs[ind] = bc.globalBC();
+      bool clean = cleanFIT(bc, maxFITtime, lims);
+      if (clean) {
+        mCleanBits[ind / 64] |= (uint64_t)1 << (ind % 64);
+      }
+      mNActive[ind + 1] = mNActive[ind] + (clean ? 0 : 1);
+      ind++;
+    }
+    mMaxFITtime = maxFITtime;
+    mLims = lims;
+  }
+
+  template <typename T>
+  bool isBuiltFor(T const& bcs, float maxFITtime, std::vector<float> const& lims) const
+  {
+    if (static_cast<int64_t>(mGlobalBCs.size()) != static_cast<int64_t>(bcs.size()) || mMaxFITtime != maxFITtime || mLims != lims) {
+      return false;
+    }
+    return mGlobalBCs.empty() || (mGlobalBCs.front() == bcs.iteratorAt(0).globalBC() && mGlobalBCs.back() == bcs.iteratorAt(bcs.size() - 1).globalBC());
+  }
+
+  // range [first, last) of the BCs with globalBC in [minBC, maxBC]
+  std::pair<int64_t, int64_t> bcRange(uint64_t minBC, uint64_t maxBC) const
+  {
+    int64_t first = std::lower_bound(mGlobalBCs.begin(), mGlobalBCs.end(), minBC) - mGlobalBCs.begin();
+    int64_t last = std::upper_bound(mGlobalBCs.begin(), mGlobalBCs.end(), maxBC) - mGlobalBCs.begin();
+    return {first, std::max(first, last)};
+  }
+
+  // range of the BCs compatible with a collision, as given by compatibleBCs(collision, ndt, bcs, nMinBCs)
+  template <typename C>
+  std::pair<int64_t, int64_t> compatibleBCRange(C const& collision, int ndt, int nMinBCs = 7) const
+  {
+    if (!collision.has_foundBC() || ndt < 0) {
+      return {0, 0};
+    }
+    uint64_t meanBC = mGlobalBCs[collision.foundBCId()] + std::lround(collision.collisionTime() / o2::constants::lhc::LHCBunchSpacingNS);
+    int deltaBC = std::ceil(collision.collisionTimeRes() / o2::constants::lhc::LHCBunchSpacingNS * ndt);
+    if (deltaBC < nMinBCs) {
+      deltaBC = nMinBCs;
+    }
+    uint64_t minBC = (uint64_t)deltaBC < meanBC ? meanBC - (uint64_t)deltaBC : 0;
+    uint64_t maxBC = meanBC + (uint64_t)deltaBC;
+    return bcRange(minBC, maxBC);
+  }
+
+  // FIT activity of a single BC, ind is the row in the BCs table
+  bool isClean(int64_t ind) const { return (mCleanBits[ind / 64] >> (ind % 64)) & 1; }
+
+  // number of BCs with FIT activity in the range [first, last)
+  int64_t nActive(int64_t first, int64_t last) const { return mNActive[last] - mNActive[first]; }
+
+  // Double Gap condition: no FIT activity in any BC of the range [first, last)
+  bool isClean(std::pair<int64_t, int64_t> const& range) const { return nActive(range.first, range.second) == 0; }
+
+ private:
+  std::vector<uint64_t> mGlobalBCs; // global BC of each BC
+  std::vector<uint64_t> mCleanBits; // bit i is set if BC i has no FIT activity
+  std::vector<int64_t> mNActive;    // number of BCs with FIT activity before BC i
+  float mMaxFITtime = -1.;
+  std::vector<float> mLims;
+};
+
 template <typename T>
 bool cleanFITCollision(T& col, float maxFITtime, std::vector<float> lims)
 {
@@ -27,10 +27,14 @@ struct DGCandProducer {
   // get a DGCutparHolder
   DGCutparHolder diffCuts = DGCutparHolder();
   Configurable<DGCutparHolder> DGCuts{"DGCuts", {}, "DG event cuts"};
+  Configurable<bool> useFITIndex{"useFITIndex", true, "Evaluate the FIT activity of all BCs once per data frame"};
 
   // DG selector
   DGSelector dgSelector;
 
+  // FIT activity of the BCs of the current data frame
+  udhelpers::FITActivityIndex fitIndex;
+
   // data tables
   Produces<aod::UDCollisions> outputCollisions;
   Produces<aod::UDCollisionsSels> outputCollisionsSels;
@@ -153,12 +157,19 @@ struct DGCandProducer {
     auto bc = collision.foundBC_as<BCs>();
     LOGF(debug, "<DGCandProducer>  BC id %d", bc.globalBC());
 
-    // obtain slice of compatible BCs
-    auto bcRange = udhelpers::compatibleBCs(collision, diffCuts.NDtcoll(), bcs, diffCuts.minNBCs());
-    LOGF(debug, "<DGCandProducer>  Size of bcRange %d", bcRange.size());
-
     // apply DG selection
-    auto isDGEvent = dgSelector.IsSelected(diffCuts, collision, bcRange, tracks, fwdtracks);
+    int isDGEvent;
+    if (useFITIndex) {
+      // the index is built with the first collision of a data frame
+      fitIndex.build(bcs, diffCuts.maxFITtime(), diffCuts.FITAmpLimits());
+      auto bcRange = fitIndex.compatibleBCRange(collision, diffCuts.NDtcoll(), diffCuts.minNBCs());
+      isDGEvent = dgSelector.IsSelected(diffCuts, collision, fitIndex, bcRange, tracks, fwdtracks);
+    } else {
+      // obtain slice of compatible BCs
+      auto bcRange = udhelpers::compatibleBCs(collision, diffCuts.NDtcoll(), bcs, diffCuts.minNBCs());
+      LOGF(debug, "<DGCandProducer>  Size of bcRange %d", bcRange.size());
+      isDGEvent = dgSelector.IsSelected(diffCuts, collision, bcRange, tracks, fwdtracks);
+    }
 
     // save DG candidates
     registry.get<TH1>(HIST("reco/Stat"))->Fill(0., 1.);
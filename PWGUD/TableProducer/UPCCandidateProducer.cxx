@@ -391,11 +391,11 @@ struct UpcCandProducer {
                       o2::aod::FDDs const& fdds,
                       o2::aod::FV0As const& fv0as)
   {
-    auto it = std::find_if(v.begin(),
-                           v.end(),
-                           [midbc](const std::pair<uint64_t, int64_t>& p) { return p.first == midbc; });
+    // v is sorted in global BC
+    auto it = std::lower_bound(v.begin(), v.end(), midbc,
+                               [](const std::pair<uint64_t, int64_t>& p, uint64_t bc) { return p.first < bc; });
 
-    if (it != v.end()) {
+    if (it != v.end() && it->first == midbc) {
       auto bcId = it->second;
       auto bcEntry = bcs.iteratorAt(bcId);
       if (bcEntry.has_foundFT0()) {
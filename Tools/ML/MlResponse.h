@@ -19,6 +19,9 @@
 
 #include <onnxruntime/core/session/experimental_onnxruntime_cxx_api.h>
 
+#include <gsl/span>
+
+#include <algorithm>
 #include <map>
 #include <string>
 #include <vector>
@@ -136,8 +139,31 @@ class MlResponse
   template <typename T1, typename T2>
   std::vector<TypeOutputScore> getModelOutput(T1& input, const T2& nModel)
   {
-    TypeOutputScore* outputPtr = mModels[nModel].evalModel(input);
-    return std::vector<TypeOutputScore>{outputPtr, outputPtr + mNClasses};
+    auto output = evalSingle(input, nModel);
+    return std::vector<TypeOutputScore>{output.begin(), output.begin() + mNClasses};
+  }
+
+  /// Get model predictions for a batch of candidates already grouped by model, with caller-owned buffers
+  /// \param inputs is the row-major matrix (nCandidates x nFeatures) of input features
+  /// \param nModel is the model index
+  /// \param outputs is the row-major matrix (nCandidates x getNumOutputNodes(nModel)) filled with the model predictions
+  template <typename T>
+  void getModelOutputs(gsl::span<const TypeOutputScore> inputs, const T& nModel, gsl::span<TypeOutputScore> outputs)
+  {
+    if (inputs.empty()) {
+      return;
+    }
+    if (!mModels[nModel].evalModel(inputs, outputs)) {
+      LOG(fatal) << "Evaluation of the ML model " << static_cast<int>(nModel) << " failed on a batch of " << inputs.size() << " input values!";
+    }
+  }
+
+  /// Get the number of values predicted per candidate by a model, i.e. the width of its last output (the class probabilities)
+  /// \param nModel is the model index
+  template <typename T>
+  int getNumOutputNodes(const T& nModel) const
+  {
+    return mModels[nModel].getNumOutputNodes();
   }
 
   /// Finds pT bin in an array.
@@ -165,21 +191,8 @@ class MlResponse
   bool isSelectedMl(T1& input, const T2& pt)
   {
     auto nModel = findBin(&mBinsLimits, pt);
-    auto output = getModelOutput(input, nModel);
-    uint8_t iClass{0};
-    for (const auto& outputValue : output) {
-      uint8_t dir = mCutDir.at(iClass);
-      if (dir != o2::cuts_ml::CutDirection::CutNot) {
-        if (dir == o2::cuts_ml::CutDirection::CutGreater && outputValue > mCuts.get(nModel, iClass)) {
-          return false;
-        }
-        if (dir == o2::cuts_ml::CutDirection::CutSmaller && outputValue < mCuts.get(nModel, iClass)) {
-          return false;
-        }
-      }
-      ++iClass;
-    }
-    return true;
+    auto output = evalSingle(input, nModel);
+    return passCuts(output, nModel);
   }
 
   /// ML selections
@@ -191,24 +204,171 @@ class MlResponse
   bool isSelectedMl(T1& input, const T2& pt, std::vector<TypeOutputScore>& output)
   {
     auto nModel = findBin(&mBinsLimits, pt);
-    output = getModelOutput(input, nModel);
-    uint8_t iClass{0};
-    for (const auto& outputValue : output) {
+    auto scores = evalSingle(input, nModel);
+    output.assign(scores.begin(), scores.begin() + mNClasses);
+    return passCuts(scores, nModel);
+  }
+
+  /// Set the maximum number of candidates evaluated in one inference in batch mode
+  /// \param chunkSize is the maximum number of candidates per inference (0: all the candidates of a model at once)
+  void setBatchChunkSize(const int chunkSize) { mBatchChunkSize = chunkSize; }
+
+  /// Remove all the candidates from the batch
+  void clearBatch()
+  {
+    mBatchInputs.clear();
+    mBatchModels.clear();
+    mBatchSelected.clear();
+    mBatchOutputs.clear();
+    mBatchNFeatures = 0;
+  }
+
+  /// Add a candidate to the batch
+  /// \param input is the container of input features, all candidates must have the same number of features
+  /// \param pt is the candidate transverse momentum
+  /// \return index of the candidate in the batch
+  template <typename T1, typename T2>
+  std::size_t addToBatch(T1 const& input, const T2& pt)
+  {
+    if (mBatchModels.empty()) {
+      mBatchNFeatures = input.size();
+    } else if (input.size() != mBatchNFeatures) {
+      LOG(fatal) << "Candidate with " << input.size() << " input features added to a batch of candidates with " << mBatchNFeatures << " features!";
+    }
+    mBatchInputs.insert(mBatchInputs.end(), input.begin(), input.end());
+    mBatchModels.push_back(findBin(&mBinsLimits, pt));
+    return mBatchModels.size() - 1;
+  }
+
+  /// Evaluate all the candidates of the batch, grouped by model, with one inference per model (or per chunk of candidates)
+  /// The decisions and the scores are then available with getBatchSelected() and getBatchOutputs() in the order of insertion
+  /// Candidates outside of the model bins are rejected and get scores equal to -1
+  void evaluateBatch()
+  {
+    const std::size_t nCandidates = mBatchModels.size();
+    mBatchSelected.assign(nCandidates, 0);
+    mBatchOutputs.assign(nCandidates * mNClasses, -1);
+
+    // counting sort of the candidates by model
+    mBatchModelOffsets.assign(mNModels + 1, 0);
+    for (const auto& nModel : mBatchModels) {
+      if (nModel >= 0) {
+        ++mBatchModelOffsets[nModel + 1];
+      }
+    }
+    for (std::size_t iModel = 0; iModel < mNModels; ++iModel) {
+      mBatchModelOffsets[iModel + 1] += mBatchModelOffsets[iModel];
+    }
+    mBatchOrder.resize(mBatchModelOffsets[mNModels]);
+    mBatchGroupedInputs.resize(mBatchModelOffsets[mNModels] * mBatchNFeatures);
+    mBatchModelFill.assign(mBatchModelOffsets.begin(), mBatchModelOffsets.end() - 1);
+    for (std::size_t iCandidate = 0; iCandidate < nCandidates; ++iCandidate) {
+      const auto nModel = mBatchModels[iCandidate];
+      if (nModel < 0) {
+        continue;
+      }
+      const auto position = mBatchModelFill[nModel]++;
+      mBatchOrder[position] = iCandidate;
+      std::copy_n(mBatchInputs.begin() + iCandidate * mBatchNFeatures, mBatchNFeatures, mBatchGroupedInputs.begin() + position * mBatchNFeatures);
+    }
+
+    // one inference per model and chunk, then scatter back the scores and the decisions
+    for (std::size_t iModel = 0; iModel < mNModels; ++iModel) {
+      const std::size_t first = mBatchModelOffsets[iModel];
+      const std::size_t nModelCandidates = mBatchModelOffsets[iModel + 1] - first;
+      if (nModelCandidates == 0) {
+        continue;
+      }
+      const std::size_t nOutputs = getNumOutputNodes(iModel);
+      if (nOutputs < static_cast<std::size_t>(mNClasses)) {
+        LOG(fatal) << "The ML model " << iModel << " predicts " << nOutputs << " values per candidate, fewer than the " << mNClasses << " configured classes!";
+      }
+      const std::size_t chunkSize = mBatchChunkSize > 0 ? std::min<std::size_t>(mBatchChunkSize, nModelCandidates) : nModelCandidates;
+      mBatchGroupedOutputs.resize(chunkSize * nOutputs);
+      for (std::size_t firstChunk = 0; firstChunk < nModelCandidates; firstChunk += chunkSize) {
+        const std::size_t nChunk = std::min(chunkSize, nModelCandidates - firstChunk);
+        gsl::span<const TypeOutputScore> inputs(mBatchGroupedInputs.data() + (first + firstChunk) * mBatchNFeatures, nChunk * mBatchNFeatures);
+        gsl::span<TypeOutputScore> outputs(mBatchGroupedOutputs.data(), nChunk * nOutputs);
+        getModelOutputs(inputs, iModel, outputs);
+        for (std::size_t iChunk = 0; iChunk < nChunk; ++iChunk) {
+          const auto iCandidate = mBatchOrder[first + firstChunk + iChunk];
+          gsl::span<const TypeOutputScore> scores(outputs.data() + iChunk * nOutputs, nOutputs);
+          std::copy_n(scores.begin(), mNClasses, mBatchOutputs.begin() + iCandidate * mNClasses);
+          mBatchSelected[iCandidate] = passCuts(scores, iModel);
+        }
+      }
+    }
+  }
+
+  /// Batched ML selections
+  /// \param inputs is the row-major matrix (nCandidates x nFeatures) of input features
+  /// \param pts are the candidate transverse momenta
+  /// \param isSelected is filled with the decision for each candidate
+  /// \param outputs is filled with the model predictions (nCandidates x nClasses, row-major)
+  template <typename T>
+  void isSelectedMl(gsl::span<const TypeOutputScore> inputs, gsl::span<const T> pts, std::vector<uint8_t>& isSelected, std::vector<TypeOutputScore>& outputs)
+  {
+    clearBatch();
+    if (pts.empty()) {
+      isSelected.clear();
+      outputs.clear();
+      return;
+    }
+    const std::size_t nFeatures = inputs.size() / pts.size();
+    for (std::size_t iCandidate = 0; iCandidate < pts.size(); ++iCandidate) {
+      addToBatch(inputs.subspan(iCandidate * nFeatures, nFeatures), pts[iCandidate]);
+    }
+    evaluateBatch();
+    isSelected = mBatchSelected;
+    outputs = mBatchOutputs;
+  }
+
+  /// Get the decisions of the batch, in the order of insertion
+  std::vector<uint8_t> const& getBatchSelected() const { return mBatchSelected; }
+
+  /// Get the scores of a candidate of the batch
+  /// \param iCandidate is the index of the candidate returned by addToBatch
+  /// \return view of the nClasses model predictions
+  gsl::span<const TypeOutputScore> getBatchOutputs(const std::size_t iCandidate) const
+  {
+    return gsl::span<const TypeOutputScore>(mBatchOutputs.data() + iCandidate * mNClasses, mNClasses);
+  }
+
+ protected:
+  /// Evaluate one candidate on the buffers bound to the model, no memory is allocated after the first call
+  /// \param input is the container of input features
+  /// \param nModel is the model index
+  /// \return view of the model predictions, valid until the next evaluation
+  template <typename T1, typename T2>
+  gsl::span<const TypeOutputScore> evalSingle(T1& input, const T2& nModel)
+  {
+    mInputBuffer.assign(input.begin(), input.end());
+    mOutputBuffer.resize(mModels[nModel].getNumOutputNodes());
+    getModelOutputs(gsl::span<const TypeOutputScore>(mInputBuffer), nModel, gsl::span<TypeOutputScore>(mOutputBuffer));
+    return mOutputBuffer;
+  }
+
+  /// Apply the cuts of a model to the predictions of one candidate
+  /// \param scores is the view of the model predictions, the first mNClasses are used
+  /// \param nModel is the model index
+  /// \return boolean telling if model predictions pass the cuts
+  template <typename T>
+  bool passCuts(gsl::span<const TypeOutputScore> scores, const T& nModel) const
+  {
+    for (uint8_t iClass = 0; iClass < mNClasses; ++iClass) {
       uint8_t dir = mCutDir.at(iClass);
       if (dir != o2::cuts_ml::CutDirection::CutNot) {
-        if (dir == o2::cuts_ml::CutDirection::CutGreater && outputValue > mCuts.get(nModel, iClass)) {
+        if (dir == o2::cuts_ml::CutDirection::CutGreater && scores[iClass] > mCuts.get(nModel, iClass)) {
           return false;
         }
-        if (dir == o2::cuts_ml::CutDirection::CutSmaller && outputValue < mCuts.get(nModel, iClass)) {
+        if (dir == o2::cuts_ml::CutDirection::CutSmaller && scores[iClass] < mCuts.get(nModel, iClass)) {
           return false;
         }
       }
-      ++iClass;
     }
     return true;
   }
 
- protected:
   std::vector<o2::ml::OnnxModel> mModels;                 // OnnxModel objects, one for each bin
   uint8_t mNModels = 1;                                   // number of bins
   uint8_t mNClasses = 3;                                  // number of model classes
@@ -218,6 +378,19 @@ class MlResponse
   o2::framework::LabeledArray<double> mCuts = {};         // array of cut values to apply on the model scores
   std::map<std::string, uint8_t> mAvailableInputFeatures; // map of available input features
   std::vector<uint8_t> mCachedIndices;                    // vector of indices correspondance between configurable and available input features
+  std::vector<TypeOutputScore> mInputBuffer;              // input features of a single candidate, bound to the models
+  std::vector<TypeOutputScore> mOutputBuffer;             // predictions of a single candidate, bound to the models
+  int mBatchChunkSize = 0;                                // maximum number of candidates per inference in batch mode (0: no limit)
+  std::size_t mBatchNFeatures = 0;                        // number of input features of the candidates in the batch
+  std::vector<TypeOutputScore> mBatchInputs;              // input features of the batch, in the order of insertion
+  std::vector<int> mBatchModels;                          // model index of each candidate of the batch (-1: outside of the bins)
+  std::vector<uint8_t> mBatchSelected;                    // decision of each candidate of the batch
+  std::vector<TypeOutputScore> mBatchOutputs;             // scores of each candidate of the batch (nCandidates x nClasses)
+  std::vector<std::size_t> mBatchModelOffsets;            // first position of each model in the grouped batch
+  std::vector<std::size_t> mBatchModelFill;               // filling position of each model in the grouped batch
+  std::vector<std::size_t> mBatchOrder;                   // candidate index of each position of the grouped batch
+  std::vector<TypeOutputScore> mBatchGroupedInputs;       // input features grouped by model
+  std::vector<TypeOutputScore> mBatchGroupedOutputs;      // model predictions of one chunk
 
   virtual void setAvailableInputFeatures() { return; } // method to fill the map of available input features
 };
@@ -22,10 +22,12 @@
 
 // C++ and system includes
 #include <onnxruntime/core/session/experimental_onnxruntime_cxx_api.h>
+#include <gsl/span>
 #include <vector>
 #include <string>
 #include <memory>
 #include <map>
+#include <array>
 
 // ROOT includes
 #include "TSystem.h"
@@ -57,7 +59,9 @@ class OnnxModel
     // assert(input[0].GetTensorTypeAndShapeInfo().GetShape() == getNumInputNodes()); --> Fails build in debug mode, TODO: assertion should be checked somehow
 
     try {
-      auto outputTensors = mSession->Run(mInputNames, input, mOutputNames);
+      // the output tensors are kept in the model, so that the returned pointer stays valid until the next evaluation
+      auto& outputTensors = mOutputTensors.values;
+      outputTensors = mSession->Run(mInputNames, input, mOutputNames);
       LOG(debug) << "Number of output tensors: " << outputTensors.size();
       if (outputTensors.size() != mOutputNames.size()) {
         LOG(fatal) << "Number of output tensors: " << outputTensors.size() << " does not agree with the model specified size: " << mOutputNames.size();
@@ -88,14 +92,72 @@ class OnnxModel
     return evalModel<T>(inputTensors);
   }
 
+  /// Evaluates the model on a batch of rows with input and output buffers owned by the caller
+  /// The buffers are bound to the session with an Ort::IoBinding, which is reused as long as the buffers and the batch size do not change,
+  /// so that repeated evaluations on the same buffers do not allocate
+  /// \param input nRows x getNumInputNodes() input values, the number of rows is deduced from its size
+  /// \param output nRows x getNumOutputNodes() values, filled by the ONNX runtime with the last output of the model
+  /// \return true if the inference succeeded
+  template <typename T>
+  bool evalModel(gsl::span<const T> input, gsl::span<T> output)
+  {
+    const int64_t nInputs = mInputShapes[0][1];
+    const int64_t nOutputs = mOutputShapes.back()[1];
+    const int64_t nRows = static_cast<int64_t>(input.size()) / nInputs;
+    if (static_cast<int64_t>(input.size()) != nRows * nInputs || static_cast<int64_t>(output.size()) < nRows * nOutputs) {
+      LOG(error) << "Input (" << input.size() << ") or output (" << output.size() << ") buffer incompatible with the model shapes " << printShape(mInputShapes[0]) << " and " << printShape(mOutputShapes.back());
+      return false;
+    }
+    try {
+      if (!mIoBinding.binding) {
+        mIoBinding.binding = std::make_unique<Ort::IoBinding>(*mSession);
+      }
+      auto& io = mIoBinding;
+      if (io.inputPtr != input.data() || io.nRows != nRows) {
+        const std::array<int64_t, 2> inputShape{nRows, nInputs};
+        io.input = Ort::Value::CreateTensor<T>(io.memoryInfo, const_cast<T*>(input.data()), nRows * nInputs, inputShape.data(), inputShape.size());
+        io.binding->BindInput(mInputNames[0].c_str(), io.input);
+        io.inputPtr = input.data();
+      }
+      if (io.outputPtr != output.data() || io.nRows != nRows) {
+        const std::array<int64_t, 2> outputShape{nRows, nOutputs};
+        io.output = Ort::Value::CreateTensor<T>(io.memoryInfo, output.data(), nRows * nOutputs, outputShape.data(), outputShape.size());
+        io.binding->BindOutput(mOutputNames.back().c_str(), io.output);
+        io.outputPtr = output.data();
+      }
+      io.nRows = nRows;
+      mSession->Run(Ort::RunOptions{nullptr}, *io.binding);
+      return true;
+    } catch (const Ort::Exception& exception) {
+      LOG(error) << "Error running model inference: " << exception.what();
+      mIoBinding.reset();
+    }
+    return false;
+  }
+
+  /// Evaluates the model on nRows rows of input and writes the last output of the model directly into the caller-owned buffer
+  /// \param input pointer to nRows x getNumInputNodes() input values
+  /// \param nRows number of rows (batch size) to evaluate
+  /// \param output pointer to nRows x getNumOutputNodes() values, filled by the ONNX runtime without intermediate copies
+  /// \return true if the inference succeeded
+  template <typename T>
+  bool evalModel(T* input, int64_t nRows, T* output)
+  {
+    return evalModel(gsl::span<const T>(input, nRows * mInputShapes[0][1]), gsl::span<T>(output, nRows * mOutputShapes.back()[1]));
+  }
+
   // Reset session
-  void resetSession() { mSession.reset(new Ort::Experimental::Session{*mEnv, modelPath, sessionOptions}); }
+  void resetSession()
+  {
+    mSession.reset(new Ort::Experimental::Session{*mEnv, modelPath, sessionOptions});
+    mIoBinding.reset();
+  }
 
   // Getters & Setters
   Ort::SessionOptions* getSessionOptions() { return &sessionOptions; } // For optimizations in post
   std::shared_ptr<Ort::Experimental::Session> getSession() { return mSession; }
   int getNumInputNodes() const { return mInputShapes[0][1]; }
-  int getNumOutputNodes() const { return mOutputShapes[0][1]; }
+  int getNumOutputNodes() const { return mOutputShapes.back()[1]; } // last output, the one returned by evalModel
   uint64_t getValidityFrom() const { return validFrom; }
   uint64_t getValidityUntil() const { return validUntil; }
   void setActiveThreads(int);
@@ -112,6 +174,51 @@ class OnnxModel
   std::vector<std::string> mOutputNames;
   std::vector<std::vector<int64_t>> mOutputShapes;
 
+  // Buffers bound to the session for the evaluation on caller-owned memory
+  // The cache belongs to one model instance: copies of the model start with an empty cache and bind their own session lazily
+  struct IoBindingCache {
+    IoBindingCache() = default;
+    IoBindingCache(const IoBindingCache&) {}
+    IoBindingCache& operator=(const IoBindingCache&)
+    {
+      reset();
+      return *this;
+    }
+
+    std::unique_ptr<Ort::IoBinding> binding = nullptr;
+    Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    Ort::Value input{nullptr};
+    Ort::Value output{nullptr};
+    const void* inputPtr = nullptr;
+    const void* outputPtr = nullptr;
+    int64_t nRows = 0;
+
+    void reset()
+    {
+      binding.reset();
+      input = Ort::Value{nullptr};
+      output = Ort::Value{nullptr};
+      inputPtr = nullptr;
+      outputPtr = nullptr;
+      nRows = 0;
+    }
+  };
+  IoBindingCache mIoBinding;
+
+  // Output tensors of the last evaluation with Session::Run, owned by the model instance and not shared with its copies
+  struct OutputTensors {
+    OutputTensors() = default;
+    OutputTensors(const OutputTensors&) {}
+    OutputTensors& operator=(const OutputTensors&)
+    {
+      values.clear();
+      return *this;
+    }
+
+    std::vector<Ort::Value> values;
+  };
+  OutputTensors mOutputTensors;
+
   // Environment settings
   std::string modelPath;
   int activeThreads = 0;